@@ -0,0 +1,70 @@
+#!/usr/bin/env bash
+# ====================================================================
+# >>> 機器人負載測試 <<<
+# 在本機啟動一個專用伺服器與 N 個無頭機器人客戶端，伺服器記錄 CSV 後自行結束。
+#
+# 用法：Scripts/RunBotLoadTest.sh [機器人數量，預設 16] [記錄秒數，預設 120] [名稱，預設 Bots<N>]
+#
+# 環境變數：
+#   SERVER_BIN      伺服器執行檔 (預設為 LinuxServer 的 staged build)
+#   CLIENT_BIN      客戶端執行檔 (預設為 Linux 的 staged build)
+#   MAP             伺服器載入的地圖 (預設為專案的預設地圖)
+#   PORT            伺服器埠號 (預設 7777)
+#   BOT_PATTERN     CharacterSample.Bot.AttackPattern (L = 輕攻擊、H = 重攻擊、其他 = 停一拍)
+#   BOT_INTERVAL    CharacterSample.Bot.AttackInterval (秒)
+#   SERVER_ARGS     額外傳給伺服器的參數
+#   CLIENT_ARGS     額外傳給客戶端的參數
+#
+# CSV 寫到伺服器的 Saved/Profiling/LoadTest/，各行程的日誌在 Saved/Logs/。
+# ====================================================================
+set -euo pipefail
+
+NUM_BOTS="${1:-16}"
+DURATION="${2:-120}"
+RUN_NAME="${3:-Bots${NUM_BOTS}}"
+
+PROJECT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+SERVER_BIN="${SERVER_BIN:-${PROJECT_DIR}/Saved/StagedBuilds/LinuxServer/CharacterSample/Binaries/Linux/CharacterSampleServer}"
+CLIENT_BIN="${CLIENT_BIN:-${PROJECT_DIR}/Saved/StagedBuilds/Linux/CharacterSample/Binaries/Linux/CharacterSample}"
+MAP="${MAP:-}"
+PORT="${PORT:-7777}"
+BOT_PATTERN="${BOT_PATTERN:-LLLH-LLH--}"
+BOT_INTERVAL="${BOT_INTERVAL:-0.3}"
+
+for BIN in "${SERVER_BIN}" "${CLIENT_BIN}"; do
+    if [[ ! -x "${BIN}" ]]; then
+        echo "Executable not found: ${BIN} (set SERVER_BIN / CLIENT_BIN)" >&2
+        exit 1
+    fi
+done
+
+BOT_PIDS=()
+cleanup() {
+    for PID in "${BOT_PIDS[@]}"; do
+        kill "${PID}" 2>/dev/null || true
+    done
+}
+trap cleanup EXIT
+
+echo "Starting server on port ${PORT}, recording ${DURATION}s as '${RUN_NAME}'..."
+# 伺服器在記錄結束後自行結束 (CharacterSample.LoadTest.Record ... quit)
+"${SERVER_BIN}" ${MAP} -port="${PORT}" -log -unattended \
+    -ExecCmds="CharacterSample.LoadTest.Record ${DURATION} 1 ${RUN_NAME} quit" \
+    ${SERVER_ARGS:-} > /dev/null &
+SERVER_PID=$!
+
+# 等伺服器開始監聽再連線
+sleep 5
+
+echo "Starting ${NUM_BOTS} bot clients..."
+for ((i = 0; i < NUM_BOTS; i++)); do
+    "${CLIENT_BIN}" "127.0.0.1:${PORT}" -nullrhi -nosound -unattended -windowed -CharacterSampleBot -BotSeed="${i}" \
+        -log="Bot${i}.log" \
+        -ExecCmds="CharacterSample.Bot.AttackPattern ${BOT_PATTERN},CharacterSample.Bot.AttackInterval ${BOT_INTERVAL}" \
+        ${CLIENT_ARGS:-} > /dev/null &
+    BOT_PIDS+=($!)
+done
+
+wait "${SERVER_PID}"
+echo "Server exited. CSV files:"
+ls -1t "$(dirname "${SERVER_BIN}")/../../Saved/Profiling/LoadTest/"*.csv 2>/dev/null | head -n 1 || echo "(none found next to the server binary; check the server log)"
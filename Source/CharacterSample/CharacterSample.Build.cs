@@ -9,5 +9,11 @@ public class CharacterSample : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput" });
+
+		// Push Model 複製 (MARK_PROPERTY_DIRTY_FROM_NAME) 與複製圖 (ReplicationGraph 外掛)
+		PrivateDependencyModuleNames.AddRange(new string[] { "NetCore", "ReplicationGraph" });
+
+		// 血條 (UUserWidget 與群眾血條的 Slate 元件)
+		PrivateDependencyModuleNames.AddRange(new string[] { "UMG", "Slate", "SlateCore" });
 	}
 }
@@ -2,6 +2,31 @@
 
 #include "CharacterSample.h"
 #include "Modules/ModuleManager.h"
+#include "ReplicationDriver.h"
+#include "Replication/CharacterSampleReplicationGraph.h"
+#include "Core/StartupTiming.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, CharacterSample, "CharacterSample" );
- 
\ No newline at end of file
+UE_TRACE_CHANNEL_DEFINE(CharacterSampleChannel);
+
+// ====================================================================
+// >>> 模組 <<<
+// 啟動時綁定複製驅動的建立委託，讓遊戲 NetDriver 使用專案的複製圖 (不需要在 ini 中設定 ReplicationDriverClassName)；
+// 並開始記錄冷啟動各階段的時間
+// ====================================================================
+class FCharacterSampleModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		UReplicationDriver::CreateReplicationDriverDelegate().BindStatic(&UCharacterSampleReplicationGraph::CreateForNetDriver);
+		StartupTiming::Initialize();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		StartupTiming::Shutdown();
+		UReplicationDriver::CreateReplicationDriverDelegate().Unbind();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FCharacterSampleModule, CharacterSample, "CharacterSample" );
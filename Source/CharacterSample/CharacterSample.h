@@ -3,3 +3,20 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// ====================================================================
+// >>> 效能分析 <<<
+// stat CharacterSample 顯示模組的週期計數器；
+// Unreal Insights 以 -trace=cpu,CharacterSample 啟用模組的追蹤頻道
+// ====================================================================
+DECLARE_STATS_GROUP(TEXT("CharacterSample"), STATGROUP_CharacterSample, STATCAT_Advanced);
+
+UE_TRACE_CHANNEL_EXTERN(CharacterSampleChannel, CHARACTERSAMPLE_API);
+
+// 同時記錄 stat 週期計數器與 Insights 的 CPU 事件 (事件名稱與 stat 名稱相同)
+#define CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, CharacterSampleChannel)
@@ -1,38 +1,151 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "CharacterSampleGameMode.h"
-#include "UObject/ConstructorHelpers.h"
 #include "Player/PlayerCharacter.h"
 #include "Player/PlayerCharacterController.h"
+#include "Subsystems/CharacterAssetPreloadSubsystem.h" // 角色類別載入後預載其蒙太奇
+#include "Core/StartupTiming.h"
+#include "Engine/AssetManager.h"
 
 
 ACharacterSampleGameMode::ACharacterSampleGameMode()
 {
-	// 設定 PlayerCharacterControllerClass 為你的 C++ APlayerCharacterController
-    // PlayerControllerClass = APlayerCharacterController::StaticClass();
-    // 使用 ConstructorHelpers 載入藍圖 PlayerController
-    static ConstructorHelpers::FClassFinder<APlayerController> PlayerControllerBPClass(TEXT("/Game/ThirdPerson/Blueprints/PlayerCharacter/BP_PlayerCharacterController.BP_PlayerCharacterController_C")); // 請確認你的藍圖路徑
-    if (PlayerControllerBPClass.Class != NULL && PlayerControllerBPClass.Succeeded())
+	// 以軟類別路徑指定藍圖，建構 CDO 時不載入 (請確認你的藍圖路徑)
+    PlayerControllerSoftClass = TSoftClassPtr<APlayerController>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Blueprints/PlayerCharacter/BP_PlayerCharacterController.BP_PlayerCharacterController_C")));
+    DefaultPawnSoftClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Blueprints/PlayerCharacter/BP_PlayerCharacter.BP_PlayerCharacter_C")));
+
+    // 藍圖載入完成前 (或找不到時) 的後備：C++ 版本的控制器與角色
+    PlayerControllerClass = APlayerCharacterController::StaticClass(); // 安全網，但此時 HealthBarWidgetClass 可能為空
+    DefaultPawnClass = APlayerCharacter::StaticClass();
+}
+
+void ACharacterSampleGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+    Super::InitGame(MapName, Options, ErrorMessage);
+
+    // 與地圖其餘的初始化重疊載入；本地玩家在同一次 LoadMap 中就會登入，屆時若仍未完成才等待
+    TArray<FSoftObjectPath> ClassPaths;
+    if (!PlayerControllerSoftClass.IsNull())
+    {
+        ClassPaths.Add(PlayerControllerSoftClass.ToSoftObjectPath());
+    }
+    if (!DefaultPawnSoftClass.IsNull())
+    {
+        ClassPaths.Add(DefaultPawnSoftClass.ToSoftObjectPath());
+    }
+    for (const FCharacterPoolPrewarmEntry& Entry : PooledCharacters)
+    {
+        if (!Entry.CharacterClass.IsNull() && Entry.Count > 0)
+        {
+            ClassPaths.AddUnique(Entry.CharacterClass.ToSoftObjectPath());
+        }
+    }
+    if (ClassPaths.Num() == 0)
+    {
+        ApplyPlayerClasses();
+        return;
+    }
+
+    StartupTiming::BeginStage(StartupTiming::EStage::ClassLoad);
+    PlayerClassesHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(ClassPaths),
+        FStreamableDelegate::CreateUObject(this, &ACharacterSampleGameMode::ApplyPlayerClasses), FStreamableManager::AsyncLoadHighPriority);
+}
+
+APlayerController* ACharacterSampleGameMode::SpawnPlayerController(ENetRole InRemoteRole, const FString& Options)
+{
+    WaitForPlayerClasses();
+
+    return Super::SpawnPlayerController(InRemoteRole, Options);
+}
+
+void ACharacterSampleGameMode::StartPlay()
+{
+    Super::StartPlay();
+
+    if (PooledCharacters.Num() == 0)
     {
-        PlayerControllerClass = PlayerControllerBPClass.Class;
+        return;
     }
-    else
+
+    // 專用伺服器沒有本地玩家登入，池的類別可能還在載入中
+    WaitForPlayerClasses();
+
+    UCharacterPoolSubsystem* PoolSubsystem = GetWorld()->GetSubsystem<UCharacterPoolSubsystem>();
+    if (!PoolSubsystem)
+    {
+        return;
+    }
+
+    const double PrewarmStart = FPlatformTime::Seconds();
+    int32 NumSpawned = 0;
+    for (const FCharacterPoolPrewarmEntry& Entry : PooledCharacters)
+    {
+        if (UClass* CharacterClass = Entry.CharacterClass.Get())
+        {
+            NumSpawned += PoolSubsystem->Prewarm(CharacterClass, Entry.Count);
+        }
+        else if (!Entry.CharacterClass.IsNull())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("CharacterSampleGameMode: failed to load pooled character class %s."), *Entry.CharacterClass.ToString());
+        }
+    }
+    UE_LOG(LogTemp, Log, TEXT("CharacterSampleGameMode: prewarmed %d pooled characters in %.1f ms."), NumSpawned, (FPlatformTime::Seconds() - PrewarmStart) * 1000.0);
+}
+
+void ACharacterSampleGameMode::WaitForPlayerClasses()
+{
+    if (bPlayerClassesApplied || !PlayerClassesHandle.IsValid())
+    {
+        return;
+    }
+
+    const double WaitStart = FPlatformTime::Seconds();
+    PlayerClassesHandle->WaitUntilComplete();
+    const double WaitMs = (FPlatformTime::Seconds() - WaitStart) * 1000.0;
+
+    StartupTiming::AddClassLoadWaitMs(WaitMs);
+    UE_LOG(LogTemp, Log, TEXT("CharacterSampleGameMode: waited %.1f ms for player classes to finish loading."), WaitMs);
+
+    ApplyPlayerClasses();
+}
+
+void ACharacterSampleGameMode::ApplyPlayerClasses()
+{
+    if (bPlayerClassesApplied)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Failed to find BP_PlayerCharacterController. Falling back to C++ APlayerCharacterController."));
-        PlayerControllerClass = APlayerCharacterController::StaticClass(); // 安全網，但此時 HealthBarWidgetClass 可能為空
+        return;
     }
+    bPlayerClassesApplied = true;
+    StartupTiming::EndStage(StartupTiming::EStage::ClassLoad);
 
-    // 繼續使用 ConstructorHelpers 載入你的藍圖角色
-    static ConstructorHelpers::FClassFinder<APawn> PlayerPawnBPClass(TEXT("/Game/ThirdPerson/Blueprints/PlayerCharacter/BP_PlayerCharacter.BP_PlayerCharacter_C"));
+    // 只取代後備類別：藍圖子類別若直接指定了 PlayerControllerClass / DefaultPawnClass，保留它的設定
+    if (PlayerControllerClass == APlayerCharacterController::StaticClass() && !PlayerControllerSoftClass.IsNull())
+    {
+        if (UClass* ControllerClass = PlayerControllerSoftClass.Get())
+        {
+            PlayerControllerClass = ControllerClass;
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to find BP_PlayerCharacterController. Falling back to C++ APlayerCharacterController."));
+        }
+    }
 
-    if (PlayerPawnBPClass.Class != NULL && PlayerPawnBPClass.Succeeded()) // 這裡用 && 比較嚴謹
+    if (DefaultPawnClass == APlayerCharacter::StaticClass() && !DefaultPawnSoftClass.IsNull())
     {
-        DefaultPawnClass = PlayerPawnBPClass.Class;
+        if (UClass* PawnClass = DefaultPawnSoftClass.Get())
+        {
+            DefaultPawnClass = PawnClass;
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to find BP_PlayerCharacter.BP_PlayerCharacter_C in GameMode. Falling back to default C++ Pawn if any."));
+        }
     }
-    else
+
+    // GameMode 初始化時預載的還是後備類別，換成藍圖類別後重新預載它的蒙太奇
+    if (UCharacterAssetPreloadSubsystem* PreloadSubsystem = GetWorld()->GetSubsystem<UCharacterAssetPreloadSubsystem>())
     {
-        UE_LOG(LogTemp, Warning, TEXT("Failed to find BP_PlayerCharacter.BP_PlayerCharacter_C in GameMode. Falling back to default C++ Pawn if any."));
-        // 如果在藍圖找不到時，至少生成 C++ 版本
-        DefaultPawnClass = APlayerCharacter::StaticClass();
-    }	
+        PreloadSubsystem->PreloadCharacterClass(DefaultPawnClass);
+    }
 }
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/CharacterPoolSubsystem.h" // FCharacterPoolPrewarmEntry
 #include "CharacterSampleGameMode.generated.h"
 
 UCLASS(minimalapi)
@@ -13,7 +15,47 @@ class ACharacterSampleGameMode : public AGameModeBase
 
 public:
 	ACharacterSampleGameMode();
-};
 
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	// 世界開始遊戲後 (仍在地圖載入中) 預熱角色池
+	virtual void StartPlay() override;
+
+	const TSoftClassPtr<APawn>& GetDefaultPawnSoftClass() const { return DefaultPawnSoftClass; }
+
+protected:
+	// 第一個玩家控制器生成前，確保藍圖類別已經載入 (載入中時同步等待剩下的部分)
+	virtual APlayerController* SpawnPlayerController(ENetRole InRemoteRole, const FString& Options) override;
+
+	// ====================================================================
+	// >>> 玩家類別 (軟引用) <<<
+	// 建構 CDO 時不再載入藍圖 (編輯器與遊戲啟動都不需要)，改在 InitGame 開始非同步載入；
+	// 載入完成前 PlayerControllerClass 與 DefaultPawnClass 為原生的後備類別
+	// ====================================================================
+
+	UPROPERTY(EditDefaultsOnly, Category = "Classes")
+	TSoftClassPtr<APlayerController> PlayerControllerSoftClass;
 
+	UPROPERTY(EditDefaultsOnly, Category = "Classes")
+	TSoftClassPtr<APawn> DefaultPawnSoftClass;
 
+	// ====================================================================
+	// >>> 角色池預熱 <<<
+	// 列出的類別與玩家類別一起非同步載入，StartPlay 時由 UCharacterPoolSubsystem 預先生成，
+	// 遊戲中以 AcquireCharacter / ReleaseCharacter 取代生成與銷毀
+	// ====================================================================
+
+	UPROPERTY(EditDefaultsOnly, Category = "Pool")
+	TArray<FCharacterPoolPrewarmEntry> PooledCharacters;
+
+private:
+	// 類別仍在載入中時同步等待完成並套用 (第一次登入或 StartPlay，以先發生者為準)
+	void WaitForPlayerClasses();
+
+	// 載入完成時 (或登入時等待完成後) 套用藍圖類別
+	void ApplyPlayerClasses();
+
+	TSharedPtr<FStreamableHandle> PlayerClassesHandle;
+
+	bool bPlayerClassesApplied = false;
+};
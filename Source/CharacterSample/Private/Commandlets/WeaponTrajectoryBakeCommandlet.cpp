@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Commandlets/WeaponTrajectoryBakeCommandlet.h"
+#include "Data/WeaponTrajectoryDataAsset.h"
+#include "Player/PlayerCharacter.h"
+#include "Components/CombatComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSequence.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+static const TCHAR* DefaultCharacterPath = TEXT("/Game/ThirdPerson/Blueprints/PlayerCharacter/BP_PlayerCharacter.BP_PlayerCharacter_C");
+static const TCHAR* DefaultOutputPath = TEXT("/Game/ThirdPerson/Blueprints/PlayerCharacter/Animations/DA_WeaponTrajectories");
+
+UWeaponTrajectoryBakeCommandlet::UWeaponTrajectoryBakeCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+#if WITH_EDITOR
+
+// ====================================================================
+// >>> 取樣 <<<
+// 從蒙太奇的第一個插槽軌道找出 MontageTime 所在的動畫片段，
+// 沿骨骼鏈由插槽骨骼往上組合到根骨骼，得到元件空間的插槽變換。
+// ====================================================================
+static bool SampleSocketComponentTransform(
+    const UAnimMontage* Montage,
+    float MontageTime,
+    const FReferenceSkeleton& RefSkeleton,
+    int32 SocketBoneIndex,
+    const FTransform& SocketLocalTransform,
+    FTransform& OutTransform)
+{
+    if (Montage->SlotAnimTracks.Num() == 0)
+    {
+        return false;
+    }
+
+    const FAnimSegment* Segment = Montage->SlotAnimTracks[0].AnimTrack.GetSegmentAtTime(MontageTime);
+    const UAnimSequence* Sequence = Segment ? Cast<UAnimSequence>(Segment->GetAnimReference()) : nullptr;
+    if (!Sequence)
+    {
+        return false;
+    }
+
+    const float AnimTime = Segment->ConvertTrackPosToAnimPos(MontageTime);
+    const IAnimationDataModel* DataModel = Sequence->GetDataModel();
+    const FFrameTime FrameTime = Sequence->GetSamplingFrameRate().AsFrameTime(AnimTime);
+
+    FTransform Transform = SocketLocalTransform;
+    for (int32 BoneIndex = SocketBoneIndex; BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+    {
+        const FName BoneName = RefSkeleton.GetBoneName(BoneIndex);
+
+        // 根動畫會被抽取到 Actor 的移動上，因此根骨骼維持參考姿勢，軌跡才會是相對於 Actor 的
+        const bool bUseRefPose = (BoneIndex == 0 && Sequence->bEnableRootMotion) || !DataModel->IsValidBoneTrackName(BoneName);
+        const FTransform LocalTransform = bUseRefPose
+            ? RefSkeleton.GetRefBonePose()[BoneIndex]
+            : DataModel->EvaluateBoneTrackTransform(BoneName, FrameTime, Sequence->Interpolation);
+
+        Transform = Transform * LocalTransform;
+    }
+
+    OutTransform = Transform;
+    return true;
+}
+
+static bool BakeMontage(
+    UAnimMontage* Montage,
+    const USkeletalMesh* SkeletalMesh,
+    const USkeletalMeshSocket* Socket,
+    const FTransform& MeshRelativeTransform,
+    float SampleRate,
+    FBakedWeaponTrajectory& OutTrajectory)
+{
+    const FReferenceSkeleton& RefSkeleton = SkeletalMesh->GetRefSkeleton();
+    const int32 SocketBoneIndex = RefSkeleton.FindBoneIndex(Socket->BoneName);
+    if (SocketBoneIndex == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Error, TEXT("WeaponTrajectoryBake: bone %s of socket %s not found."), *Socket->BoneName.ToString(), *Socket->SocketName.ToString());
+        return false;
+    }
+
+    const float PlayLength = Montage->GetPlayLength();
+    const int32 NumSamples = FMath::FloorToInt32(PlayLength * SampleRate) + 1;
+    const FTransform SocketLocalTransform = Socket->GetSocketLocalTransform();
+
+    TArray<FVector> Positions;
+    Positions.Reserve(NumSamples);
+    for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+    {
+        const float MontageTime = FMath::Min(SampleIndex / SampleRate, PlayLength);
+
+        FTransform ComponentTransform;
+        if (SampleSocketComponentTransform(Montage, MontageTime, RefSkeleton, SocketBoneIndex, SocketLocalTransform, ComponentTransform))
+        {
+            // 元件空間 -> Actor 空間 (網格相對於膠囊體的位移與旋轉)
+            Positions.Add(MeshRelativeTransform.TransformPosition(ComponentTransform.GetLocation()));
+        }
+        else
+        {
+            // 片段之間的空隙沿用上一個取樣
+            Positions.Add(Positions.Num() > 0 ? Positions.Last() : FVector::ZeroVector);
+        }
+    }
+
+    OutTrajectory.Encode(Positions, SampleRate);
+
+    // 量化誤差 (只用於報告)
+    double MaxError = 0.0;
+    for (int32 SampleIndex = 0; SampleIndex < Positions.Num(); ++SampleIndex)
+    {
+        MaxError = FMath::Max(MaxError, FVector::Dist(Positions[SampleIndex], OutTrajectory.Evaluate(SampleIndex / SampleRate)));
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("WeaponTrajectoryBake: %s -> %d samples, %d bytes, max quantization error %.4f cm"),
+        *Montage->GetName(), OutTrajectory.NumSamples(), OutTrajectory.QuantizedSamples.Num() * static_cast<int32>(sizeof(uint16)), MaxError);
+    return true;
+}
+
+#endif // WITH_EDITOR
+
+int32 UWeaponTrajectoryBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+    TArray<FString> Tokens;
+    TArray<FString> Switches;
+    TMap<FString, FString> ParamValues;
+    ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+    const FString* CharacterParam = ParamValues.Find(TEXT("Character"));
+    const FString* MontagesParam = ParamValues.Find(TEXT("Montages"));
+    const FString* SocketParam = ParamValues.Find(TEXT("Socket"));
+    const FString* SampleRateParam = ParamValues.Find(TEXT("SampleRate"));
+    const FString* OutputParam = ParamValues.Find(TEXT("Output"));
+
+    const FString CharacterPath = CharacterParam ? *CharacterParam : DefaultCharacterPath;
+    const FName SocketName = SocketParam ? FName(**SocketParam) : FName(TEXT("weapon_l"));
+    const float SampleRate = SampleRateParam ? FMath::Max(1.0f, FCString::Atof(**SampleRateParam)) : 60.0f;
+    const FString OutputPath = OutputParam ? *OutputParam : DefaultOutputPath;
+
+    // 骨架網格與網格相對變換取自角色類別的 CDO (包含藍圖中的覆寫)
+    UClass* CharacterClass = LoadClass<APlayerCharacter>(nullptr, *CharacterPath);
+    const APlayerCharacter* CharacterCDO = CharacterClass ? CharacterClass->GetDefaultObject<APlayerCharacter>() : nullptr;
+    const USkeletalMeshComponent* MeshComponent = CharacterCDO ? CharacterCDO->GetMesh() : nullptr;
+    const USkeletalMesh* SkeletalMesh = MeshComponent ? MeshComponent->GetSkeletalMeshAsset() : nullptr;
+    if (!SkeletalMesh)
+    {
+        UE_LOG(LogTemp, Error, TEXT("WeaponTrajectoryBake: %s has no skeletal mesh."), *CharacterPath);
+        return 1;
+    }
+
+    const USkeletalMeshSocket* Socket = SkeletalMesh->FindSocket(SocketName);
+    if (!Socket)
+    {
+        UE_LOG(LogTemp, Error, TEXT("WeaponTrajectoryBake: socket %s not found on %s."), *SocketName.ToString(), *SkeletalMesh->GetName());
+        return 1;
+    }
+
+    TArray<UAnimMontage*> Montages;
+    if (MontagesParam)
+    {
+        TArray<FString> MontagePaths;
+        MontagesParam->ParseIntoArray(MontagePaths, TEXT(","));
+        for (const FString& MontagePath : MontagePaths)
+        {
+            if (UAnimMontage* Montage = LoadObject<UAnimMontage>(nullptr, *MontagePath))
+            {
+                Montages.Add(Montage);
+            }
+            else
+            {
+                UE_LOG(LogTemp, Warning, TEXT("WeaponTrajectoryBake: montage %s not found, skipped."), *MontagePath);
+            }
+        }
+    }
+    else if (CharacterCDO->CombatComponent)
+    {
+        CharacterCDO->CombatComponent->GetAttackMontages(Montages);
+    }
+
+    if (Montages.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("WeaponTrajectoryBake: no montages to bake."));
+        return 1;
+    }
+
+    // 已存在的資產只覆寫這次烘焙的蒙太奇
+    const FString AssetName = FPackageName::GetLongPackageAssetName(OutputPath);
+    UWeaponTrajectoryDataAsset* Asset = LoadObject<UWeaponTrajectoryDataAsset>(nullptr, *(OutputPath + TEXT(".") + AssetName), nullptr, LOAD_NoWarn | LOAD_Quiet);
+    if (!Asset)
+    {
+        UPackage* NewPackage = CreatePackage(*OutputPath);
+        Asset = NewObject<UWeaponTrajectoryDataAsset>(NewPackage, *AssetName, RF_Public | RF_Standalone);
+    }
+    Asset->SocketName = SocketName;
+
+    int32 NumBaked = 0;
+    for (UAnimMontage* Montage : Montages)
+    {
+        FBakedWeaponTrajectory Trajectory;
+        if (BakeMontage(Montage, SkeletalMesh, Socket, MeshComponent->GetRelativeTransform(), SampleRate, Trajectory))
+        {
+            Asset->Trajectories.Add(TSoftObjectPtr<UAnimMontage>(Montage), MoveTemp(Trajectory));
+            ++NumBaked;
+        }
+    }
+
+    UPackage* Package = Asset->GetOutermost();
+    Package->MarkPackageDirty();
+
+    FSavePackageArgs SaveArgs;
+    SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+    const FString Filename = FPackageName::LongPackageNameToFilename(OutputPath, FPackageName::GetAssetPackageExtension());
+    if (!UPackage::SavePackage(Package, Asset, *Filename, SaveArgs))
+    {
+        UE_LOG(LogTemp, Error, TEXT("WeaponTrajectoryBake: failed to save %s."), *Filename);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("WeaponTrajectoryBake: baked %d / %d montages into %s."), NumBaked, Montages.Num(), *OutputPath);
+    return NumBaked == Montages.Num() ? 0 : 1;
+#else
+    UE_LOG(LogTemp, Error, TEXT("WeaponTrajectoryBake: this commandlet requires an editor build."));
+    return 1;
+#endif
+}
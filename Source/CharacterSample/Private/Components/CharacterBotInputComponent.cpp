@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Components/CharacterBotInputComponent.h"
+#include "Components/CharacterInputManagerComponent.h"
+#include "Player/PlayerCharacter.h"
+#include "Player/PlayerCharacterController.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "EnhancedInputSubsystems.h" // InjectInputForAction
+#include "InputAction.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台變數
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bot Injected Attacks"), STAT_BotInjectedAttacks, STATGROUP_CharacterSample);
+
+namespace BotInput
+{
+    static FString AttackPattern = TEXT("LLLH-LLH--");
+    static FAutoConsoleVariableRef CVarAttackPattern(
+        TEXT("CharacterSample.Bot.AttackPattern"),
+        AttackPattern,
+        TEXT("機器人的攻擊節奏，循環執行：L = 輕攻擊、H = 重攻擊、其他字元 = 停一拍。"));
+
+    static float AttackInterval = 0.3f;
+    static FAutoConsoleVariableRef CVarAttackInterval(
+        TEXT("CharacterSample.Bot.AttackInterval"),
+        AttackInterval,
+        TEXT("攻擊節奏每一拍的秒數。"));
+
+    static float WanderSeconds = 2.0f;
+    static FAutoConsoleVariableRef CVarWanderSeconds(
+        TEXT("CharacterSample.Bot.WanderSeconds"),
+        WanderSeconds,
+        TEXT("機器人平均每隔幾秒更換一次移動方向與轉向速度。"));
+
+    static float JumpChancePerSecond = 0.2f;
+    static FAutoConsoleVariableRef CVarJumpChancePerSecond(
+        TEXT("CharacterSample.Bot.JumpChancePerSecond"),
+        JumpChancePerSecond,
+        TEXT("機器人每秒起跳的機率。"));
+
+    // Look 的數值與滑鼠輸入相同單位，換算成每秒的偏移
+    static constexpr float MaxLookYawRate = 60.0f;
+}
+
+// ====================================================================
+// >>> 控制台指令：在 PIE 或一般客戶端中切換機器人輸入 <<<
+// 用法：CharacterSample.Bot.Toggle
+// ====================================================================
+static FAutoConsoleCommandWithWorld GBotToggleCommand(
+    TEXT("CharacterSample.Bot.Toggle"),
+    TEXT("切換本地玩家是否由機器人注入輸入。"),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+    {
+        if (APlayerCharacterController* PlayerController = World ? Cast<APlayerCharacterController>(World->GetFirstPlayerController()) : nullptr)
+        {
+            PlayerController->SetBotInputEnabled(!PlayerController->IsBotInputEnabled());
+            UE_LOG(LogTemp, Log, TEXT("Bot input %s."), PlayerController->IsBotInputEnabled() ? TEXT("enabled") : TEXT("disabled"));
+        }
+    }));
+
+UCharacterBotInputComponent::UCharacterBotInputComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+bool UCharacterBotInputComponent::IsBotRequestedOnCommandLine()
+{
+    return FParse::Param(FCommandLine::Get(), TEXT("CharacterSampleBot"));
+}
+
+void UCharacterBotInputComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // 在控制器的 PlayerTick 處理輸入之前注入，讓數值在同一幀生效
+    GetOwner()->AddTickPrerequisiteComponent(this);
+
+    // 同一台機器上的多個機器人預設以行程 ID 區分
+    int32 Seed = static_cast<int32>(FPlatformProcess::GetCurrentProcessId());
+    FParse::Value(FCommandLine::Get(), TEXT("BotSeed="), Seed);
+    RandomStream.Initialize(Seed);
+
+    ChooseWanderDirection();
+    AttackTimeRemaining = RandomStream.FRandRange(0.0f, BotInput::AttackInterval);
+
+    UE_LOG(LogTemp, Log, TEXT("CharacterBotInputComponent: bot input started (seed %d, pattern \"%s\")."), Seed, *BotInput::AttackPattern);
+}
+
+const UCharacterInputManagerComponent* UCharacterBotInputComponent::GetInputManager() const
+{
+    const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+    const APlayerCharacter* PlayerChar = PlayerController ? Cast<APlayerCharacter>(PlayerController->GetPawn()) : nullptr;
+    return PlayerChar ? PlayerChar->CharacterInputManagerComponent : nullptr;
+}
+
+void UCharacterBotInputComponent::Inject(const UInputAction* Action, const FInputActionValue& Value) const
+{
+    if (!Action)
+    {
+        return;
+    }
+
+    const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+    if (UEnhancedInputLocalPlayerSubsystem* Subsystem = PlayerController ? ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()) : nullptr)
+    {
+        Subsystem->InjectInputForAction(Action, Value, {}, {});
+    }
+}
+
+void UCharacterBotInputComponent::ChooseWanderDirection()
+{
+    // 偶爾停下來，讓群眾中同時有移動與靜止的角色
+    WanderInput = RandomStream.FRand() < 0.2f ? FVector2D::ZeroVector : FVector2D(RandomStream.FRandRange(-1.0f, 1.0f), RandomStream.FRandRange(-1.0f, 1.0f)).GetSafeNormal();
+    LookYawRate = RandomStream.FRandRange(-BotInput::MaxLookYawRate, BotInput::MaxLookYawRate);
+    WanderTimeRemaining = RandomStream.FRandRange(0.5f, 1.5f) * FMath::Max(BotInput::WanderSeconds, 0.1f);
+}
+
+void UCharacterBotInputComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    const UCharacterInputManagerComponent* InputManager = GetInputManager();
+    if (!InputManager)
+    {
+        return; // 尚未操控角色或角色正在重生
+    }
+
+    // --- 移動與視角：持續注入，每隔一段時間換一個方向 ---
+    WanderTimeRemaining -= DeltaTime;
+    if (WanderTimeRemaining <= 0.0f)
+    {
+        ChooseWanderDirection();
+    }
+    if (!WanderInput.IsZero())
+    {
+        Inject(InputManager->MoveAction, FInputActionValue(WanderInput));
+    }
+    Inject(InputManager->LookAction, FInputActionValue(FVector2D(LookYawRate * DeltaTime, 0.0f)));
+
+    // --- 跳躍：注入一幀即觸發 Started，下一幀沒有注入時觸發 Completed ---
+    if (RandomStream.FRand() < BotInput::JumpChancePerSecond * DeltaTime)
+    {
+        Inject(InputManager->JumpAction, FInputActionValue(true));
+    }
+
+    // --- 攻擊：依節奏字串每拍注入一次 ---
+    const FString& Pattern = BotInput::AttackPattern;
+    AttackTimeRemaining -= DeltaTime;
+    if (AttackTimeRemaining <= 0.0f && !Pattern.IsEmpty())
+    {
+        AttackTimeRemaining += FMath::Max(BotInput::AttackInterval, 0.05f);
+        AttackPatternIndex = (AttackPatternIndex + 1) % Pattern.Len();
+
+        const TCHAR Beat = FChar::ToUpper(Pattern[AttackPatternIndex]);
+        const UInputAction* AttackAction = Beat == TEXT('L') ? InputManager->AttackAction : Beat == TEXT('H') ? InputManager->HeavyAttackAction : nullptr;
+        if (AttackAction)
+        {
+            Inject(AttackAction, FInputActionValue(true));
+            INC_DWORD_STAT(STAT_BotInjectedAttacks);
+        }
+    }
+}
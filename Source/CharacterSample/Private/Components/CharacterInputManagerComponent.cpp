@@ -116,6 +116,12 @@ void UCharacterInputManagerComponent::SetupInputBindings(UInputComponent* Player
         {
              UE_LOG(LogTemp, Warning, TEXT("CharacterInputManagerComponent: CombatComponentRef is null, AttackAction not bound."));
         }
+
+        // --- 綁定重攻擊輸入 ---
+        if (HeavyAttackAction && CombatComponentRef)
+        {
+            EnhancedInputComponent->BindAction(HeavyAttackAction, ETriggerEvent::Started, CombatComponentRef, &UCombatComponent::HeavyAttack);
+        }
     }
     else
     {
@@ -6,12 +6,72 @@
 #include "GameFramework/CharacterMovementComponent.h" // 訪問角色移動組件
 #include "Components/CapsuleComponent.h" // 訪問膠囊碰撞體
 #include "Components/SkeletalMeshComponent.h" // 訪問網格模型
-#include "Kismet/KismetSystemLibrary.h" // 用於藍圖輔助函數，如 Sweep Trace
+#include "DrawDebugHelpers.h" // 用於命中檢測的除錯繪製
 #include "Engine/DamageEvents.h" // 用於處理傷害事件
 #include "Animation/AnimMontage.h" // 用於動畫蒙太奇
 #include "Animation/AnimInstance.h" // 用於動畫實例
-#include "Engine/Engine.h" // 用於 GEngine->AddOnScreenDebugMessage
 #include "Components/EntranceAnimationComponent.h" // 包含 UEntranceAnimationComponent 的頭檔
+#include "Subsystems/CombatHitQuerySubsystem.h" // 批次非同步命中查詢
+#include "Subsystems/CombatDamageSubsystem.h" // 幀末合併的傷害管線
+#include "Subsystems/GameplayTimerSubsystem.h" // 連擊窗口計時器 (時間輪)
+#include "Subsystems/CharacterAssetPreloadSubsystem.h" // 軟引用蒙太奇的串流載入
+#include "Data/WeaponTrajectoryDataAsset.h" // 離線烘焙的武器軌跡
+#include "Core/CombatDebug.h" // 可由控制台變數開關、Shipping 中移除的除錯輸出
+#include "Core/CombatInputLatency.h" // 輸入到蒙太奇開始的延遲直方圖
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+#include "Net/UnrealNetwork.h" // DOREPLIFETIME
+#include "Net/Core/PushModel/PushModel.h" // MARK_PROPERTY_DIRTY_FROM_NAME
+#include "GameFramework/GameStateBase.h" // 客戶端估計的伺服器世界時間
+
+DECLARE_CYCLE_STAT(TEXT("Combat Attack Input"), STAT_CombatAttackInput, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Combat Hit Check"), STAT_CombatHitCheck, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Combat Hit Results"), STAT_CombatHitResults, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Predicted Inputs"), STAT_CombatPredictedInputs, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Prediction Rollbacks"), STAT_CombatPredictionRollbacks, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Buffered Inputs Expired"), STAT_CombatBufferedInputsExpired, STATGROUP_CharacterSample);
+
+namespace ComboBuffering
+{
+    // 取消窗口開啟前多久以內按下的輸入仍然有效；更早的輸入在消耗時丟棄
+    static float InputBufferSeconds = 0.4f;
+    static FAutoConsoleVariableRef CVarInputBufferSeconds(
+        TEXT("CharacterSample.Combat.InputBufferSeconds"),
+        InputBufferSeconds,
+        TEXT("連擊輸入在取消窗口開啟前最多可以提早幾秒按下。"));
+
+    // 緩衝輸入接續時，新的一段最多往前追上的秒數 (窗口開啟到這一幀實際處理之間的延遲，低幀率時較明顯)
+    static constexpr double MaxSegmentCatchUpSeconds = 0.1;
+}
+
+namespace ComboPrediction
+{
+    // 伺服器以客戶端按下的時間判定取消窗口時，最多往回採信的秒數 (避免偽造的時間戳記)
+    static float MaxInputRewindSeconds = 0.25f;
+    static FAutoConsoleVariableRef CVarMaxInputRewindSeconds(
+        TEXT("CharacterSample.Combat.MaxInputRewindSeconds"),
+        MaxInputRewindSeconds,
+        TEXT("伺服器驗證預測的連擊輸入時，最多往回採信客戶端時間戳記的秒數。"));
+
+    // 回滾時停止預測蒙太奇的混出時間
+    static constexpr float RollbackBlendOutTime = 0.1f;
+}
+
+namespace ComboReplication
+{
+    // ReplicatedComboState 的位元配置：[0, 6] 連擊段數、[7] 攻擊中、[8, 15] 段序號
+    static constexpr uint16 SegmentMask = 0x7F;
+    static constexpr uint16 AttackingBit = 1 << 7;
+    static constexpr uint16 SequenceShift = 8;
+
+    static uint16 Pack(int32 SegmentIndex, bool bAttacking, uint8 Sequence)
+    {
+        return static_cast<uint16>(SegmentIndex & SegmentMask) | (bAttacking ? AttackingBit : 0) | (static_cast<uint16>(Sequence) << SequenceShift);
+    }
+
+    static int32 GetSegment(uint16 State) { return State & SegmentMask; }
+    static bool IsAttacking(uint16 State) { return (State & AttackingBit) != 0; }
+    static uint8 GetSequence(uint16 State) { return static_cast<uint8>(State >> SequenceShift); }
+}
 
 // ====================================================================
 // >>> 構造函數：UCombatComponent::UCombatComponent() <<<
@@ -20,12 +80,43 @@
 UCombatComponent::UCombatComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false; // 只在命中窗口開啟期間 Tick
+	PrimaryComponentTick.TickGroup = TG_PostPhysics; // 在動畫更新之後取樣武器插槽
+	SetIsReplicatedByDefault(true); // 連擊狀態以 Push Model 複製
+
+	bResolveHitsWithCharacterIndex = true;
+	WeaponSocketName = TEXT("weapon_l");
+	WeaponSweepRadius = 30.0f;
+	bIsHitWindowActive = false;
+	PreviousWeaponSocketLocation = FVector::ZeroVector;
+	WeaponTrajectories = nullptr;
+	CurrentWeaponTrajectory = nullptr;
+	CurrentSegmentStartTime = 0.0;
+	CurrentSegmentPlayRate = 1.0f;
+	CurrentSwingId = 0;
 
 	CurrentAttackComboIndex = 0;
 	bIsAttacking = false;
-	bCanEnterNextCombo = false;
-	bPendingNextComboInput = false;
+	ComboWindowOpenTime = TNumericLimits<double>::Max();
+	ComboWindowCloseTime = 0.0;
+	CurrentSegmentDamage = 0.0f;
+	HitRewindOffset = 0.0;
+	GameplayTimerSubsystem = nullptr;
+	bHeadless = false;
 	bIsDead = false; // 這裡先保留，未來可能移到 HealthComponent
+	ReplicatedComboState = 0;
+	ComboSequence = 0;
+	NextPredictionKey = 0;
+	AcknowledgedServerSequence = 0;
+}
+
+void UCombatComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatComponent, ReplicatedComboState, Params);
 }
 
 
@@ -51,109 +142,425 @@ void UCombatComponent::BeginPlay()
     {
         UE_LOG(LogTemp, Warning, TEXT("CombatComponent: EntranceAnimationComponent not found on OwnerCharacter. Attack checks may be incomplete."));
     }
+
+    GameplayTimerSubsystem = GetWorld()->GetSubsystem<UGameplayTimerSubsystem>();
+    if (!GameplayTimerSubsystem)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("CombatComponent: GameplayTimerSubsystem is not available in this world. Combo windows will not time out."));
+    }
+
+    // 未指定連擊圖資產時，將舊版的 AttackMontages 編譯成線性連擊。
+    // 蒙太奇通常已由生成前的預載載入，這裡的請求只是取得句柄；仍在載入中時等待同一個請求完成
+    if (!ComboGraph)
+    {
+        TArray<FSoftObjectPath> Paths;
+        GetPreloadAssets(Paths);
+        AttackMontagesHandle = UCharacterAssetPreloadSubsystem::RequestAssets(MoveTemp(Paths), FStreamableDelegate::CreateUObject(this, &UCombatComponent::OnAttackMontagesLoaded));
+    }
 }
 
+void UCombatComponent::OnAttackMontagesLoaded()
+{
+    if (LegacyComboGraph.IsValid())
+    {
+        return;
+    }
 
-// Called every frame
-// void UCombatComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-// {
-// 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    // 與原本的 +0.1 秒窗口一致
+    TArray<UAnimMontage*> Montages;
+    Montages.Reserve(AttackMontages.Num());
+    for (const TSoftObjectPtr<UAnimMontage>& Montage : AttackMontages)
+    {
+        Montages.Add(Montage.Get());
+    }
+    LegacyComboGraph.CompileLinear(Montages, 0.1f);
+}
 
-// 	// ...
-// }
+
+// ====================================================================
+// >>> TickComponent()：只在連續命中窗口開啟期間執行 <<<
+// 每幀取樣武器插槽，只掃掠上一幀到這一幀之間的短線段，
+// 高幀率下也不會漏掉快速的揮擊，且不需要額外的 Notify。
+// ====================================================================
+void UCombatComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CombatHitCheck);
+
+    if (!bIsHitWindowActive || !OwnerCharacter || !OwnerCharacter->GetMesh())
+    {
+        StopAttackHitWindow();
+        return;
+    }
+
+    const FVector CurrentWeaponSocketLocation = GetWeaponLocation();
+
+    // 武器幾乎沒動時不需要再次查詢，上一段掃掠已經涵蓋這個位置
+    if (FVector::DistSquared(PreviousWeaponSocketLocation, CurrentWeaponSocketLocation) > 1.0f)
+    {
+        SubmitAttackSweep(PreviousWeaponSocketLocation, CurrentWeaponSocketLocation, WeaponSweepRadius);
+        PreviousWeaponSocketLocation = CurrentWeaponSocketLocation;
+    }
+}
 
 // ====================================================================
 // >>> 攻擊輸入處理 (整合 Combo 邏輯) <<<
 // ====================================================================
 void UCombatComponent::Attack()
+{
+    HandleComboInput(EComboInput::Light);
+}
+
+void UCombatComponent::HeavyAttack()
+{
+    HandleComboInput(EComboInput::Heavy);
+}
+
+void UCombatComponent::HandleComboInput(EComboInput Input)
+{
+    // 延遲量測的起點：Enhanced Input 的 Started 事件 (或機器人注入) 分派到這裡的時間
+    const double InputPlatformTime = FPlatformTime::Seconds();
+
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CombatAttackInput);
+
+    if (!IsPredictingClient())
+    {
+        HandleComboInputAt(Input, GetWorld()->GetTimeSeconds(), InputPlatformTime);
+        return;
+    }
+
+    // 預測：先在本地執行，以段序號是否改變判斷這次輸入是否開始了新的一段
+    const uint8 SequenceBefore = ComboSequence;
+    HandleComboInputAt(Input, GetWorld()->GetTimeSeconds(), InputPlatformTime);
+
+    FPredictedComboInput& Prediction = PendingPredictions.AddDefaulted_GetRef();
+    Prediction.Key = NextPredictionKey++;
+    Prediction.PredictedSegment = ComboSequence != SequenceBefore ? CurrentAttackComboIndex : INDEX_NONE;
+    INC_DWORD_STAT(STAT_CombatPredictedInputs);
+
+    // 以估計的伺服器世界時間標記輸入，讓伺服器以按下當時的取消窗口判定
+    const AGameStateBase* GameState = GetWorld()->GetGameState();
+    const double ClientInputTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+    ServerHandleComboInput(Input, Prediction.Key, ClientInputTime);
+}
+
+void UCombatComponent::HandleComboInputAt(EComboInput Input, double InputTime, double InputPlatformTime)
 {
     // 如果角色不存在、正在播放入場動畫，或者角色已經死亡，則不允許攻擊，直接返回。
     if (!OwnerCharacter || bIsDead) return;
     if (EntranceAnimationComponent && EntranceAnimationComponent->bIsPlayingEntranceAnimation) return;
 
+    const FCompiledComboGraph& Graph = GetActiveComboGraph();
+    if (!Graph.IsValid()) return;
+
     // 判斷是否正在攻擊中。
     if (!bIsAttacking)
     {
-        CurrentAttackComboIndex = 0; // 設定當前連擊段數為第一段 (0)
-        PlayAttackComboSegment(); // 播放第一段攻擊動畫
-        GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Magenta, TEXT("Starting First Attack!"));
+        // 從待機列查表取得起手段
+        const int32 EntrySegment = Graph.GetNextSegment(INDEX_NONE, Input);
+        if (EntrySegment != INDEX_NONE && StartComboSegment(EntrySegment))
+        {
+            RecordInputLatency(InputPlatformTime, false, 0.0);
+            COMBAT_DEBUG_MESSAGE(FColor::Magenta, TEXT("Starting First Attack!"));
+        }
         return; // 啟動第一擊後，直接返回
     }
 
-    // 如果 bIsAttacking 為 true，表示角色正在攻擊中，接下來判斷是否能進入下一段連擊。
-    if (bCanEnterNextCombo)
+    // 攻擊中：依到達順序寫入緩衝區，取消窗口已經開啟時立即依時間戳記消耗，否則等窗口開啟
+    InputBuffer.Push(Input, InputTime, InputPlatformTime);
+    if (TryConsumeBufferedInput())
     {
-        TryEnterNextCombo(); // 嘗試進入下一段連擊
-        GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Yellow, TEXT("Attempting Next Combo (Direct)!"));
-        SetPendingNextComboInput(false); // 成功連擊後，清除任何緩衝的輸入旗標
+        COMBAT_DEBUG_MESSAGE(FColor::Yellow, TEXT("Attempting Next Combo (Direct)!"));
     }
-    else
+    else if (!InputBuffer.IsEmpty())
     {
-        SetPendingNextComboInput(true);
-        GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, TEXT("Attack input buffered!"));
+        COMBAT_DEBUG_MESSAGE(FColor::Blue, TEXT("Attack input buffered!"));
     }
 }
 
 // ====================================================================
 // >>> Combo 攻擊實作 <<<
 // 負責播放連擊的每一段動畫，並設定相關狀態和計時器。
+// 所有時間都來自載入時編譯好的連擊圖，執行期不再查詢蒙太奇長度。
 // ====================================================================
 
 void UCombatComponent::PlayAttackComboSegment()
 {
-    if (!OwnerCharacter || !OwnerCharacter->GetMesh()) return; // 確保角色和網格存在
+    StartComboSegment(CurrentAttackComboIndex);
+}
+
+bool UCombatComponent::StartComboSegment(int32 SegmentIndex, double StartTime)
+{
+    if (!OwnerCharacter || !OwnerCharacter->GetMesh()) return false; // 確保角色和網格存在
+
+    const FCompiledComboGraph& Graph = GetActiveComboGraph();
+    if (!Graph.Segments.IsValidIndex(SegmentIndex) || !Graph.Segments[SegmentIndex].Montage)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Combo segment %d is invalid or Montage is null!"), SegmentIndex);
+        ResetCombo();
+        return false;
+    }
+
+    const FCompiledComboSegment& Segment = Graph.Segments[SegmentIndex];
+
+    // 從 StartTime 算起：蒙太奇從對應的位置開始播放，取消窗口與所有計時器一起提前
+    const double Now = GetWorld()->GetTimeSeconds();
+    const double CatchUpSeconds = StartTime >= 0.0 ? FMath::Clamp(Now - StartTime, 0.0, ComboBuffering::MaxSegmentCatchUpSeconds) : 0.0;
 
-    if (AttackMontages.IsValidIndex(CurrentAttackComboIndex) && AttackMontages[CurrentAttackComboIndex])
+    // 無頭模式不播放蒙太奇，改由編譯好的時間軸事件驅動
+    if (!bHeadless)
     {
         UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance();
-        if (AnimInstance)
+        if (!AnimInstance)
         {
-            UAnimMontage* CurrentMontage = AttackMontages[CurrentAttackComboIndex];
-            float Duration = AnimInstance->Montage_Play(CurrentMontage, 1.0f);
-            
-            if (Duration > 0.0f)
-            {
-                bIsAttacking = true;
-                bCanEnterNextCombo = false;
-                
-                AnimInstance->OnMontageEnded.RemoveDynamic(this, &UCombatComponent::OnAttackMontageEnded);
-                AnimInstance->OnMontageEnded.AddDynamic(this, &UCombatComponent::OnAttackMontageEnded);
-                
-                OwnerCharacter->GetCharacterMovement()->StopMovementImmediately();
-                OwnerCharacter->GetCharacterMovement()->DisableMovement();
-                
-                GetWorld()->GetTimerManager().ClearTimer(ComboWindowTimerHandle); // 使用 GetWorld() 獲取世界
-                GetWorld()->GetTimerManager().SetTimer(ComboWindowTimerHandle, this, &UCombatComponent::OnComboWindowEnd, Duration + 0.1f, false);
-            }
-            else
-            {
-                UE_LOG(LogTemp, Warning, TEXT("Montage_Play failed for AttackMontage index %d."), CurrentAttackComboIndex);
-                ResetCombo();
-            }
+            UE_LOG(LogTemp, Warning, TEXT("AnimInstance is null for PlayerCharacter during attack."));
+            ResetCombo();
+            return false;
         }
-        else
+
+        const float StartPosition = static_cast<float>(CatchUpSeconds) * Segment.PlayRate;
+        if (AnimInstance->Montage_Play(Segment.Montage, Segment.PlayRate, EMontagePlayReturnType::MontageLength, StartPosition) <= 0.0f)
         {
-            UE_LOG(LogTemp, Warning, TEXT("AnimInstance is null for PlayerCharacter during attack."));
+            UE_LOG(LogTemp, Warning, TEXT("Montage_Play failed for combo segment %d."), SegmentIndex);
             ResetCombo();
+            return false;
         }
+
+        AnimInstance->OnMontageEnded.RemoveDynamic(this, &UCombatComponent::OnAttackMontageEnded);
+        AnimInstance->OnMontageEnded.AddDynamic(this, &UCombatComponent::OnAttackMontageEnded);
+    }
+
+    CurrentAttackComboIndex = SegmentIndex;
+    CurrentSegmentDamage = Segment.Damage;
+    CurrentWeaponTrajectory = WeaponTrajectories ? WeaponTrajectories->FindTrajectory(Segment.Montage) : nullptr;
+    CurrentSegmentPlayRate = Segment.PlayRate;
+    bIsAttacking = true;
+    BeginNewSwing(); // 每段連擊都是新的一段揮擊，目標可以再次被命中
+
+    OwnerCharacter->GetCharacterMovement()->StopMovementImmediately();
+    OwnerCharacter->GetCharacterMovement()->DisableMovement();
+
+    ++ComboSequence;
+    UpdateReplicatedComboState();
+
+    // 取消窗口：CancelWindowStart < 0 時等待 Anim Notify 開啟，否則在指定時間開啟
+    const double SegmentStartTime = Now - CatchUpSeconds;
+    const float CatchUp = static_cast<float>(CatchUpSeconds);
+    CurrentSegmentStartTime = SegmentStartTime;
+    ComboWindowCloseTime = SegmentStartTime + Segment.CancelWindowEnd;
+    ClearComboTimers();
+    if (Segment.CancelWindowStart < 0.0f)
+    {
+        ComboWindowOpenTime = TNumericLimits<double>::Max();
     }
     else
     {
-        UE_LOG(LogTemp, Warning, TEXT("AttackMontage index %d is invalid or Montage is null!"), CurrentAttackComboIndex);
+        ComboWindowOpenTime = SegmentStartTime + Segment.CancelWindowStart;
+        if (Segment.CancelWindowStart > CatchUp && GameplayTimerSubsystem)
+        {
+            ComboWindowOpenTimerHandle = GameplayTimerSubsystem->SetTimer(Segment.CancelWindowStart - CatchUp, FSimpleDelegate::CreateUObject(this, &UCombatComponent::ConsumeBufferedComboInput));
+        }
+    }
+
+    if (GameplayTimerSubsystem)
+    {
+        ComboWindowTimerHandle = GameplayTimerSubsystem->SetTimer(FMath::Max(Segment.RecoveryEnd - CatchUp, 0.0f), FSimpleDelegate::CreateUObject(this, &UCombatComponent::OnComboWindowEnd));
+
+        // 無頭模式由時間軸驅動所有事件；播放蒙太奇時，追趕跳過的區段中的 Notify 不會觸發，
+        // 這些事件 (HitCheck、NextCombo、SaveAttack 等) 依原順序在下一次計時器推進時補發
+        for (const FComboTimelineEntry& Entry : Segment.Timeline)
+        {
+            if (!bHeadless && Entry.Time >= CatchUp)
+            {
+                break; // 時間軸依時間排序，之後的事件由蒙太奇的 Notify 觸發
+            }
+            TimelineEventHandles.Add(GameplayTimerSubsystem->SetTimer(FMath::Max(Entry.Time - CatchUp, 0.0f), FSimpleDelegate::CreateUObject(this, &UCombatComponent::HandleTimelineEvent, Entry.Event)));
+        }
+    }
+    return true;
+}
+
+// ====================================================================
+// >>> 連擊狀態複製 <<<
+// ====================================================================
+
+void UCombatComponent::UpdateReplicatedComboState()
+{
+    if (!GetOwner() || !GetOwner()->HasAuthority()) return;
+
+    const uint16 NewState = ComboReplication::Pack(CurrentAttackComboIndex, bIsAttacking, ComboSequence);
+    if (NewState != ReplicatedComboState)
+    {
+        ReplicatedComboState = NewState;
+        MARK_PROPERTY_DIRTY_FROM_NAME(UCombatComponent, ReplicatedComboState, this);
+    }
+}
+
+void UCombatComponent::OnRep_ComboState(uint16 PreviousComboState)
+{
+    if (!OwnerCharacter) return;
+
+    // 本地控制的角色自己預測連擊；只有伺服器自行開始、沒有對應回覆的段 (例如伺服器消耗了緩衝輸入)
+    // 且與本地不同時才修正，等待回覆期間以回覆為準
+    if (OwnerCharacter->IsLocallyControlled())
+    {
+        const uint8 ServerSequence = ComboReplication::GetSequence(ReplicatedComboState);
+        const int32 ServerSegment = ComboReplication::GetSegment(ReplicatedComboState);
+        if (PendingPredictions.Num() == 0 && ComboReplication::IsAttacking(ReplicatedComboState)
+            && ServerSequence != AcknowledgedServerSequence && (!bIsAttacking || CurrentAttackComboIndex != ServerSegment))
+        {
+            AcknowledgedServerSequence = ServerSequence;
+            RollbackPrediction(bIsAttacking ? CurrentAttackComboIndex : INDEX_NONE, ServerSegment);
+        }
+        return;
+    }
+
+    CurrentAttackComboIndex = ComboReplication::GetSegment(ReplicatedComboState);
+    bIsAttacking = ComboReplication::IsAttacking(ReplicatedComboState);
+
+    // 模擬代理只需要看到動作：新的一段開始時播放蒙太奇，計時器與命中判定都留在伺服器
+    const bool bNewSegment = bIsAttacking && ComboReplication::GetSequence(ReplicatedComboState) != ComboReplication::GetSequence(PreviousComboState);
+    if (bNewSegment && !bHeadless && OwnerCharacter->GetMesh())
+    {
+        const FCompiledComboGraph& Graph = GetActiveComboGraph();
+        UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance();
+        if (AnimInstance && Graph.Segments.IsValidIndex(CurrentAttackComboIndex) && Graph.Segments[CurrentAttackComboIndex].Montage)
+        {
+            AnimInstance->Montage_Play(Graph.Segments[CurrentAttackComboIndex].Montage, Graph.Segments[CurrentAttackComboIndex].PlayRate);
+        }
+    }
+}
+
+// ====================================================================
+// >>> 客戶端預測與伺服器驗證 <<<
+// ====================================================================
+
+bool UCombatComponent::IsPredictingClient() const
+{
+    return OwnerCharacter && OwnerCharacter->IsLocallyControlled() && !OwnerCharacter->HasAuthority();
+}
+
+void UCombatComponent::ServerHandleComboInput_Implementation(EComboInput Input, uint8 PredictionKey, double ClientInputTime)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CombatAttackInput);
+
+    // 以客戶端按下的時間判定取消窗口，但只在限制範圍內採信
+    const double Now = GetWorld()->GetTimeSeconds();
+    const double InputTime = FMath::Clamp(ClientInputTime, Now - ComboPrediction::MaxInputRewindSeconds, Now);
+
+    const uint8 SequenceBefore = ComboSequence;
+    HandleComboInputAt(Input, InputTime);
+    const bool bStartedSegment = ComboSequence != SequenceBefore;
+
+    // 新的一段以同樣的延遲回溯命中判定 (延遲補償)
+    if (bStartedSegment)
+    {
+        SetHitRewindOffset(Now - InputTime);
+    }
+
+    ClientAckComboInput(PredictionKey, static_cast<int8>(bStartedSegment ? CurrentAttackComboIndex : INDEX_NONE), ComboSequence);
+}
+
+void UCombatComponent::ClientAckComboInput_Implementation(uint8 PredictionKey, int8 ServerSegment, uint8 ServerSequence)
+{
+    AcknowledgedServerSequence = ServerSequence;
+
+    // 可靠 RPC 依序送達，較早的預測應已被回覆；找不到時視為重複或過期的回覆
+    const int32 PredictionIndex = PendingPredictions.IndexOfByPredicate([PredictionKey](const FPredictedComboInput& Prediction)
+    {
+        return Prediction.Key == PredictionKey;
+    });
+    if (PredictionIndex == INDEX_NONE)
+    {
+        return;
+    }
+
+    const int32 PredictedSegment = PendingPredictions[PredictionIndex].PredictedSegment;
+    PendingPredictions.RemoveAt(0, PredictionIndex + 1, EAllowShrinking::No);
+
+    if (PredictedSegment != ServerSegment)
+    {
+        RollbackPrediction(PredictedSegment, ServerSegment);
+    }
+}
+
+void UCombatComponent::RollbackPrediction(int32 PredictedSegment, int32 ServerSegment)
+{
+    INC_DWORD_STAT(STAT_CombatPredictionRollbacks);
+    COMBAT_DEBUG_LOG(TEXT("Combo misprediction: predicted segment %d, server segment %d. Rolling back."), PredictedSegment, ServerSegment);
+
+    // 停止預測播放的蒙太奇 (之後的預測若已接續到別段，則目前播放的不是它，保持不動)
+    const FCompiledComboGraph& Graph = GetActiveComboGraph();
+    if (PredictedSegment != INDEX_NONE && bIsAttacking && CurrentAttackComboIndex == PredictedSegment
+        && Graph.Segments.IsValidIndex(PredictedSegment) && OwnerCharacter->GetMesh())
+    {
+        if (UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance())
+        {
+            AnimInstance->Montage_Stop(ComboPrediction::RollbackBlendOutTime, Graph.Segments[PredictedSegment].Montage);
+        }
         ResetCombo();
     }
+
+    // 改採伺服器開始的段
+    if (ServerSegment != INDEX_NONE)
+    {
+        StartComboSegment(ServerSegment);
+    }
 }
 
-void UCombatComponent::TryEnterNextCombo()
+void UCombatComponent::SetHeadless(bool bInHeadless)
 {
-    if (bCanEnterNextCombo && (CurrentAttackComboIndex + 1) < AttackMontages.Num())
+    bHeadless = bInHeadless;
+}
+
+// ====================================================================
+// >>> 無頭模式的時間軸事件 <<<
+// 對應原本由 Anim Notify 呼叫的函式
+// ====================================================================
+void UCombatComponent::HandleTimelineEvent(EComboTimelineEvent Event)
+{
+    switch (Event)
     {
-        CurrentAttackComboIndex++;
-        PlayAttackComboSegment();
-        GetWorld()->GetTimerManager().ClearTimer(ComboWindowTimerHandle);
-        UE_LOG(LogTemp, Log, TEXT("Entered next combo segment: %d"), CurrentAttackComboIndex);
+    case EComboTimelineEvent::HitCheck:
+        PerformNormalAttackHitCheck();
+        break;
+    case EComboTimelineEvent::OpenComboWindow:
+        SetCanEnterNextCombo(true);
+        break;
+    case EComboTimelineEvent::ConsumeBufferedInput:
+        ConsumeBufferedComboInput();
+        break;
+    case EComboTimelineEvent::BeginHitWindow:
+        BeginAttackHitWindow();
+        break;
+    case EComboTimelineEvent::EndHitWindow:
+        EndAttackHitWindow();
+        break;
     }
-    else
+}
+
+bool UCombatComponent::TryComboTransition(EComboInput Input, double StartTime)
+{
+    // 單次查表：目前這段 + 輸入 -> 下一段
+    const int32 NextSegment = GetActiveComboGraph().GetNextSegment(CurrentAttackComboIndex, Input);
+    if (NextSegment == INDEX_NONE)
+    {
+        return false;
+    }
+
+    if (!StartComboSegment(NextSegment, StartTime))
+    {
+        return false;
+    }
+
+    COMBAT_DEBUG_LOG(TEXT("Entered next combo segment: %d"), CurrentAttackComboIndex);
+    return true;
+}
+
+void UCombatComponent::TryEnterNextCombo()
+{
+    if (!bIsAttacking || !IsComboWindowOpen() || !TryComboTransition(EComboInput::Light))
     {
         UE_LOG(LogTemp, Warning, TEXT("Cannot enter next combo. Resetting combo."));
         ResetCombo();
@@ -162,49 +569,135 @@ void UCombatComponent::TryEnterNextCombo()
 
 void UCombatComponent::ResetCombo()
 {
-    UE_LOG(LogTemp, Log, TEXT("Resetting Attack Combo."));
+    COMBAT_DEBUG_LOG(TEXT("Resetting Attack Combo."));
     CurrentAttackComboIndex = 0;
     bIsAttacking = false;
-    bCanEnterNextCombo = false;
-    bPendingNextComboInput = false;
-    GetWorld()->GetTimerManager().ClearTimer(ComboWindowTimerHandle);
+    ComboWindowOpenTime = TNumericLimits<double>::Max();
+    ComboWindowCloseTime = 0.0;
+    InputBuffer.Reset();
+    CurrentWeaponTrajectory = nullptr;
+    HitRewindOffset = 0.0;
+    StopAttackHitWindow();
+    ClearComboTimers();
+    UpdateReplicatedComboState();
     if (OwnerCharacter && OwnerCharacter->GetCharacterMovement()) // 確保角色存在才恢復移動
     {
         OwnerCharacter->GetCharacterMovement()->SetMovementMode(MOVE_Walking);
     }
-    GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Cyan, TEXT("Combo Reset!"));
+    COMBAT_DEBUG_MESSAGE(FColor::Cyan, TEXT("Combo Reset!"));
 }
 
 void UCombatComponent::OnComboWindowEnd()
 {
-    if (bIsAttacking && !bCanEnterNextCombo)
+    // 恢復時間 (段長 + ComboResetGrace) 已過仍未接續下一段
+    if (bIsAttacking)
     {
-        UE_LOG(LogTemp, Log, TEXT("Combo Window Ended without next input. Resetting combo."));
+        COMBAT_DEBUG_LOG(TEXT("Combo Window Ended without next input. Resetting combo."));
         ResetCombo();
     }
 }
 
-void UCombatComponent::SetCanEnterNextCombo(bool bCan)
+void UCombatComponent::ClearComboTimers()
 {
-    bCanEnterNextCombo = bCan;
-    if (bCan)
+    if (GameplayTimerSubsystem)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Green, TEXT("Can Enter Next Combo!"));
-        if (bPendingNextComboInput)
+        GameplayTimerSubsystem->ClearTimer(ComboWindowTimerHandle);
+        GameplayTimerSubsystem->ClearTimer(ComboWindowOpenTimerHandle);
+        for (FTimingWheelHandle& Handle : TimelineEventHandles)
         {
-            TryEnterNextCombo();
-            SetPendingNextComboInput(false);
-            GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Green, TEXT("Buffered input triggered next combo!"));
+            GameplayTimerSubsystem->ClearTimer(Handle);
         }
     }
+    TimelineEventHandles.Reset();
+}
+
+bool UCombatComponent::IsComboWindowOpen() const
+{
+    return IsComboWindowOpenAt(GetWorld()->GetTimeSeconds());
+}
+
+bool UCombatComponent::IsComboWindowOpenAt(double Time) const
+{
+    return bIsAttacking && Time >= ComboWindowOpenTime && Time <= ComboWindowCloseTime;
+}
+
+void UCombatComponent::ConsumeBufferedComboInput()
+{
+    if (TryConsumeBufferedInput())
+    {
+        COMBAT_DEBUG_MESSAGE(FColor::Green, TEXT("Buffered input triggered next combo!"));
+    }
+}
+
+// ====================================================================
+// >>> 依時間戳記消耗緩衝輸入 <<<
+// 有效的輸入：按下時間在窗口開啟前 InputBufferSeconds 以內，且不晚於窗口關閉。
+// 接續的一段從「按下時間」與「窗口開啟時間」較晚者開始，不因這一幀處理得晚而延後。
+// ====================================================================
+bool UCombatComponent::TryConsumeBufferedInput()
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+    if (!bIsAttacking || InputBuffer.IsEmpty() || Now < ComboWindowOpenTime) return false;
+
+    const double EarliestValidTime = ComboWindowOpenTime - ComboBuffering::InputBufferSeconds;
+    FComboInputEvent Event;
+    while (InputBuffer.PopOldest(Event))
+    {
+        if (Event.Time < EarliestValidTime || Event.Time > ComboWindowCloseTime)
+        {
+            INC_DWORD_STAT(STAT_CombatBufferedInputsExpired);
+            continue;
+        }
+
+        // 在窗口開啟前按下的輸入是緩衝輸入，否則是窗口內按下、立即處理的直接輸入
+        const bool bBuffered = Event.Time < ComboWindowOpenTime;
+        const double StartTime = FMath::Max(Event.Time, ComboWindowOpenTime);
+
+        // 沒有對應轉移的輸入 (例如這段不接受重攻擊) 直接丟棄，繼續檢查下一個
+        if (TryComboTransition(Event.Input, StartTime))
+        {
+            RecordInputLatency(Event.InputPlatformTime, bBuffered, Now - StartTime);
+            return true;
+        }
+    }
+    return false;
+}
+
+void UCombatComponent::RecordInputLatency(double InputPlatformTime, bool bBuffered, double ResolveDelaySeconds) const
+{
+    if (InputPlatformTime > 0.0 && !bHeadless)
+    {
+        CombatInputLatency::RecordSegmentStart(InputPlatformTime, bBuffered, ResolveDelaySeconds);
+    }
+}
+
+void UCombatComponent::SetCanEnterNextCombo(bool bCan)
+{
+    if (!bIsAttacking) return;
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    if (bCan)
+    {
+        ComboWindowOpenTime = Now;
+        COMBAT_DEBUG_MESSAGE(FColor::Green, TEXT("Can Enter Next Combo!"));
+        ConsumeBufferedComboInput();
+    }
+    else
+    {
+        ComboWindowCloseTime = FMath::Min(ComboWindowCloseTime, Now);
+    }
 }
 
 void UCombatComponent::SetPendingNextComboInput(bool bPending)
 {
-    bPendingNextComboInput = bPending;
     if (bPending)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, TEXT("Input Buffered!"));
+        InputBuffer.Push(EComboInput::Light, GetWorld()->GetTimeSeconds());
+        COMBAT_DEBUG_MESSAGE(FColor::Blue, TEXT("Input Buffered!"));
+    }
+    else
+    {
+        InputBuffer.Reset();
     }
 }
 
@@ -214,66 +707,217 @@ void UCombatComponent::SetPendingNextComboInput(bool bPending)
 
 void UCombatComponent::PerformNormalAttackHitCheck()
 {
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CombatHitCheck);
+
     if (!OwnerCharacter || !OwnerCharacter->GetMesh()) return; // 確保角色和網格存在
 
-    UE_LOG(LogTemp, Log, TEXT("Performing Normal Attack Hit Check for Combo Segment: %d"), CurrentAttackComboIndex);
+    COMBAT_DEBUG_LOG(TEXT("Performing Normal Attack Hit Check for Combo Segment: %d"), CurrentAttackComboIndex);
 
-    FVector StartLocation = OwnerCharacter->GetMesh()->GetSocketLocation(TEXT("weapon_l"));
-    FVector EndLocation = StartLocation + OwnerCharacter->GetActorForwardVector() * 150.0f;
+    const FCompiledComboGraph& Graph = GetActiveComboGraph();
+    if (!Graph.Segments.IsValidIndex(CurrentAttackComboIndex)) return;
+    const FCompiledComboSegment& Segment = Graph.Segments[CurrentAttackComboIndex];
 
-    TArray<FHitResult> HitResults;
-    FCollisionQueryParams Params;
-    Params.AddIgnoredActor(OwnerCharacter); // 忽略 OwnerCharacter，防止自體命中
-    Params.bTraceComplex = true;
+    // 單次取樣：從武器插槽沿角色前方掃掠，形狀來自目前這段的設定
+    const FVector StartLocation = GetWeaponLocation();
+    const FVector EndLocation = StartLocation + OwnerCharacter->GetActorForwardVector() * Segment.HitReach;
+    SubmitAttackSweep(StartLocation, EndLocation, Segment.HitRadius);
+}
 
-    TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
-    ObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECC_Pawn));
+void UCombatComponent::BeginAttackHitWindow()
+{
+    // 客戶端的蒙太奇同樣會觸發 Notify，但命中只在權威端判定，不需要開始逐幀取樣
+    if (!OwnerCharacter || !OwnerCharacter->GetMesh() || !OwnerCharacter->HasAuthority()) return;
 
-    FCollisionShape SphereShape = FCollisionShape::MakeSphere(70.0f);
+    // 記錄起始位置，第一次 Tick 時才會掃掠第一段
+    PreviousWeaponSocketLocation = GetWeaponLocation();
+    bIsHitWindowActive = true;
+    SetComponentTickEnabled(true);
+}
 
-    bool bHit = UKismetSystemLibrary::SphereTraceMultiForObjects(
-        GetWorld(),
-        StartLocation,
-        EndLocation,
-        SphereShape.GetSphereRadius(),
-        ObjectTypes,
-        false,
-        TArray<AActor*>(), // 由於上面已經用 Params.AddIgnoredActor，這裡可以傳空 TArray
-        EDrawDebugTrace::ForDuration,
-        HitResults,
-        true,
-        FLinearColor::Red,
-        FLinearColor::Green,
-        5.0f
-    );
+void UCombatComponent::EndAttackHitWindow()
+{
+    // 關閉前補上最後一段，避免窗口結束那一幀的移動被漏掉
+    if (bIsHitWindowActive && OwnerCharacter && OwnerCharacter->GetMesh())
+    {
+        const FVector CurrentWeaponSocketLocation = GetWeaponLocation();
+        if (FVector::DistSquared(PreviousWeaponSocketLocation, CurrentWeaponSocketLocation) > 1.0f)
+        {
+            SubmitAttackSweep(PreviousWeaponSocketLocation, CurrentWeaponSocketLocation, WeaponSweepRadius);
+        }
+    }
+
+    StopAttackHitWindow();
+}
+
+void UCombatComponent::StopAttackHitWindow()
+{
+    bIsHitWindowActive = false;
+    SetComponentTickEnabled(false);
+}
+
+FVector UCombatComponent::GetWeaponLocation() const
+{
+    // 烘焙軌跡只依賴 Actor 變換，不需要骨架網格已更新姿勢 (遠處或動畫被節流時仍然正確)
+    if (CurrentWeaponTrajectory)
+    {
+        const float MontageTime = static_cast<float>(GetWorld()->GetTimeSeconds() - CurrentSegmentStartTime) * CurrentSegmentPlayRate;
+        return OwnerCharacter->GetActorTransform().TransformPosition(CurrentWeaponTrajectory->Evaluate(MontageTime));
+    }
+    return OwnerCharacter->GetMesh()->GetSocketLocation(WeaponSocketName);
+}
+
+void UCombatComponent::GetAttackMontages(TArray<UAnimMontage*>& OutMontages) const
+{
+    if (ComboGraph)
+    {
+        for (const FComboSegmentDefinition& Segment : ComboGraph->Segments)
+        {
+            if (Segment.Montage)
+            {
+                OutMontages.AddUnique(Segment.Montage);
+            }
+        }
+    }
+    for (const TSoftObjectPtr<UAnimMontage>& SoftMontage : AttackMontages)
+    {
+        if (UAnimMontage* Montage = SoftMontage.LoadSynchronous())
+        {
+            OutMontages.AddUnique(Montage);
+        }
+    }
+}
+
+void UCombatComponent::GetPreloadAssets(TArray<FSoftObjectPath>& OutPaths) const
+{
+    for (const TSoftObjectPtr<UAnimMontage>& Montage : AttackMontages)
+    {
+        if (!Montage.IsNull())
+        {
+            OutPaths.AddUnique(Montage.ToSoftObjectPath());
+        }
+    }
+}
+
+void UCombatComponent::SubmitAttackSweep(const FVector& Start, const FVector& End, float Radius)
+{
+    // 命中與傷害只在權威端 (伺服器或單機) 判定，結果透過生命值複製同步到客戶端
+    if (!OwnerCharacter->HasAuthority()) return;
 
-    if (bHit)
+    UCombatHitQuerySubsystem* HitQuerySubsystem = GetWorld()->GetSubsystem<UCombatHitQuerySubsystem>();
+    if (!HitQuerySubsystem)
     {
-        for (const FHitResult& Hit : HitResults)
+        UE_LOG(LogTemp, Warning, TEXT("CombatComponent: CombatHitQuerySubsystem is not available in this world. Hit check skipped."));
+        return;
+    }
+
+    // 不再於此同步執行掃掠，而是將請求交給子系統，與本幀其他攻擊者一起批次處理
+    FCombatHitQueryRequest Request;
+    Request.Start = Start;
+    Request.End = End;
+    Request.Radius = Radius;
+    Request.IgnoredActor = OwnerCharacter; // 忽略 OwnerCharacter，防止自體命中
+    Request.bResolveWithCharacterIndex = bResolveHitsWithCharacterIndex;
+    Request.RewindTime = HitRewindOffset > 0.0 ? GetWorld()->GetTimeSeconds() - HitRewindOffset : -1.0;
+    Request.OnComplete.BindUObject(this, &UCombatComponent::OnNormalAttackHitQueryComplete, CurrentSwingId, CurrentSegmentDamage);
+
+#if ENABLE_DRAW_DEBUG
+    if (COMBAT_DEBUG_DRAW_ENABLED())
+    {
+        DrawDebugLine(GetWorld(), Start, End, FColor::Red, false, 5.0f);
+        DrawDebugSphere(GetWorld(), End, Radius, 12, FColor::Red, false, 5.0f);
+    }
+#endif
+
+    HitQuerySubsystem->SubmitSphereSweep(MoveTemp(Request));
+}
+
+void UCombatComponent::OnNormalAttackHitQueryComplete(const TArray<FHitResult>& HitResults, uint32 SwingId, float Damage)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CombatHitResults);
+
+    // 結果可能晚一幀才送達，期間角色可能已經死亡或被銷毀
+    if (!OwnerCharacter || bIsDead) return;
+
+    UCombatDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UCombatDamageSubsystem>();
+
+    for (const FHitResult& Hit : HitResults)
+    {
+        if (AActor* HitActor = Hit.GetActor())
         {
-            if (AActor* HitActor = Hit.GetActor())
+            // 再次確認不是命中自己，且目標在這段揮擊中尚未被命中
+            if (HitActor != OwnerCharacter && TryRegisterSwingHit(HitActor, SwingId))
             {
-                if (HitActor != OwnerCharacter) // 再次確認不是命中自己
+                COMBAT_DEBUG_LOG(TEXT("攻擊命中: %s"), *HitActor->GetName());
+#if ENABLE_DRAW_DEBUG
+                if (COMBAT_DEBUG_DRAW_ENABLED())
+                {
+                    DrawDebugPoint(GetWorld(), Hit.ImpactPoint, 10.0f, FColor::Green, false, 5.0f);
+                }
+#endif
+                // 角色的傷害交給子系統在幀末合併套用，其他 Actor 仍直接呼叫 TakeDamage
+                ACharacterBase* HitCharacter = Cast<ACharacterBase>(HitActor);
+                if (HitCharacter && DamageSubsystem)
+                {
+                    DamageSubsystem->SubmitDamage(HitCharacter, Damage, OwnerCharacter->GetController(), OwnerCharacter);
+                }
+                else
                 {
-                    UE_LOG(LogTemp, Log, TEXT("攻擊命中: %s"), *HitActor->GetName());
                     FDamageEvent DamageEvent;
-                    HitActor->TakeDamage(25.0f, DamageEvent, OwnerCharacter->GetController(), OwnerCharacter); // 使用 OwnerCharacter 的 Controller 和 Actor
+                    HitActor->TakeDamage(Damage, DamageEvent, OwnerCharacter->GetController(), OwnerCharacter); // 使用 OwnerCharacter 的 Controller 和 Actor
                 }
             }
         }
     }
 }
 
+// ====================================================================
+// >>> 每段揮擊的命中去重 <<<
+// ====================================================================
+
+void UCombatComponent::BeginNewSwing()
+{
+    PreviousSwingHitActors = MoveTemp(CurrentSwingHitActors);
+    CurrentSwingHitActors.Reset();
+    ++CurrentSwingId;
+}
+
+bool UCombatComponent::TryRegisterSwingHit(const AActor* HitActor, uint32 SwingId)
+{
+    FSwingHitSet* HitSet = nullptr;
+    if (SwingId == CurrentSwingId)
+    {
+        HitSet = &CurrentSwingHitActors;
+    }
+    else if (SwingId + 1 == CurrentSwingId)
+    {
+        HitSet = &PreviousSwingHitActors; // 上一段揮擊的遲到結果
+    }
+    else
+    {
+        return false; // 太舊的結果直接丟棄
+    }
+
+    const TObjectKey<AActor> HitActorKey(HitActor);
+    if (HitSet->Contains(HitActorKey))
+    {
+        return false;
+    }
+
+    HitSet->Add(HitActorKey);
+    return true;
+}
+
 // ====================================================================
 // >>> 動畫蒙太奇結束回調 <<<
 // ====================================================================
 
 void UCombatComponent::OnAttackMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
-    // 檢查結束的蒙太奇是否是我們攻擊蒙太奇數組中的一個，並且角色仍然處於攻擊狀態。
-    if (AttackMontages.Contains(Montage) && bIsAttacking)
+    // 檢查結束的蒙太奇是否是目前這段連擊的蒙太奇，並且角色仍然處於攻擊狀態。
+    const FCompiledComboGraph& Graph = GetActiveComboGraph();
+    if (bIsAttacking && Graph.Segments.IsValidIndex(CurrentAttackComboIndex) && Graph.Segments[CurrentAttackComboIndex].Montage == Montage)
     {
-        UE_LOG(LogTemp, Log, TEXT("Attack Montage Ended (Index: %d, Interrupted: %s)."), CurrentAttackComboIndex, bInterrupted ? TEXT("True") : TEXT("False"));
+        COMBAT_DEBUG_LOG(TEXT("Attack Montage Ended (Index: %d, Interrupted: %s)."), CurrentAttackComboIndex, bInterrupted ? TEXT("True") : TEXT("False"));
         
         if (OwnerCharacter && OwnerCharacter->GetMesh()) // 確保角色和網格存在
         {
@@ -8,6 +8,8 @@
 #include "GameFramework/CharacterMovementComponent.h" // 因為需要 GetCharacterMovement()
 #include "Components/CapsuleComponent.h" // 因為需要 GetCapsuleComponent()
 #include "Engine/Engine.h" // 用於 UE_LOG 訊息
+#include "Engine/World.h" // 預載時依世界的網路模式判斷
+#include "Subsystems/CharacterAssetPreloadSubsystem.h" // 軟引用蒙太奇的串流載入
 
 // Sets default values for this component's properties
 UEntranceAnimationComponent::UEntranceAnimationComponent()
@@ -50,55 +52,156 @@ void UEntranceAnimationComponent::PlayEntranceAnimation()
         return;
     }
 
-    if (EntranceMontage) // 檢查是否有設定入場動畫 Montage (UAnimMontage 變數，需在藍圖中指定)
+    // 入場動畫只是表演：專用伺服器上沒有人看得到，也不需要在這段期間鎖住移動與碰撞，
+    // 直接視為已結束 (客戶端仍會自行播放並暫停輸入，伺服器不會在這段期間收到移動或攻擊)
+    if (OwnerCharacter->IsNetMode(NM_DedicatedServer))
     {
-        // 透過 OwnerCharacter 獲取 SkeletalMeshComponent，再獲取其 AnimInstance
-        UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance(); 
-        if (AnimInstance)
+        OwnerCharacter->SetPlayerInputEnabled(true);
+        return;
+    }
+
+    if (EntranceMontage.IsNull()) // 如果沒有設定入場動畫 Montage
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EntranceAnimationComponent: EntranceMontage is not set! Enabling Player Input."));
+        // 如果沒有指定蒙太奇，直接啟用輸入
+        OwnerCharacter->SetPlayerInputEnabled(true); 
+        return;
+    }
+
+    // 蒙太奇通常已由生成前的預載載入，直接播放
+    if (UAnimMontage* LoadedMontage = EntranceMontage.Get())
+    {
+        PlayLoadedEntranceMontage(LoadedMontage);
+        return;
+    }
+
+    // 尚未載入完成：不在這一幀同步載入 (會卡頓)，而是等待串流句柄 (預載進行中時等待同一個請求)。
+    // 等待期間與播放期間一樣鎖住輸入、移動與碰撞，攻擊也會因 bIsPlayingEntranceAnimation 被擋下
+    bIsPlayingEntranceAnimation = true;
+    OwnerCharacter->GetCharacterMovement()->DisableMovement();
+    OwnerCharacter->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    OwnerCharacter->SetPlayerInputEnabled(false);
+
+    EntranceMontageWaitStartTime = FPlatformTime::Seconds();
+    EntranceMontageHandle = UCharacterAssetPreloadSubsystem::RequestAssets({ EntranceMontage.ToSoftObjectPath() },
+        FStreamableDelegate::CreateUObject(this, &UEntranceAnimationComponent::OnEntranceMontageLoaded));
+}
+
+void UEntranceAnimationComponent::OnEntranceMontageLoaded()
+{
+    // 等待期間角色可能已被銷毀，或入場動畫已被中止
+    if (!OwnerCharacter || !bIsPlayingEntranceAnimation) return;
+
+    UAnimMontage* LoadedMontage = EntranceMontage.Get();
+    if (!LoadedMontage)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EntranceAnimationComponent: Failed to load EntranceMontage %s. Enabling Player Input."), *EntranceMontage.ToString());
+        AbortEntranceAnimation();
+        return;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("EntranceAnimationComponent: EntranceMontage streamed in after %.1f ms."), (FPlatformTime::Seconds() - EntranceMontageWaitStartTime) * 1000.0);
+    PlayLoadedEntranceMontage(LoadedMontage);
+}
+
+void UEntranceAnimationComponent::PlayLoadedEntranceMontage(UAnimMontage* Montage)
+{
+    // 透過 OwnerCharacter 獲取 SkeletalMeshComponent，再獲取其 AnimInstance
+    UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance(); 
+    if (AnimInstance)
+    {
+        // 播放蒙太奇，速度為 1.0f (正常速度)。返回蒙太奇的實際持續時間。
+        float Duration = AnimInstance->Montage_Play(Montage, 1.0f); 
+        
+        if (Duration > 0.0f) // 如果蒙太奇成功播放 (持續時間大於 0)
         {
-            // 播放蒙太奇，速度為 1.0f (正常速度)。返回蒙太奇的實際持續時間。
-            float Duration = AnimInstance->Montage_Play(EntranceMontage, 1.0f); 
+            bIsPlayingEntranceAnimation = true; // 設定旗標為 true，表示正在播放入場動畫
             
-            if (Duration > 0.0f) // 如果蒙太奇成功播放 (持續時間大於 0)
-            {
-                bIsPlayingEntranceAnimation = true; // 設定旗標為 true，表示正在播放入場動畫
-                
-                // 綁定到 Montage 結束事件作為安全網。
-                // 先移除現有的委託，以防止重複綁定 (如果 PlayEntranceAnimation 被再次呼叫)。
-                AnimInstance->OnMontageEnded.RemoveDynamic(this, &UEntranceAnimationComponent::OnMontageEnded); 
-                // 添加動態委託，當蒙太奇結束時，呼叫 OnMontageEnded 函式。
-                AnimInstance->OnMontageEnded.AddDynamic(this, &UEntranceAnimationComponent::OnMontageEnded);
-                
-                // 在動畫期間禁用角色移動組件，防止玩家移動。
-                // 透過 OwnerCharacter 獲取角色移動組件
-                OwnerCharacter->GetCharacterMovement()->DisableMovement();
-                // 在動畫期間禁用膠囊碰撞體的碰撞，防止角色被推動或卡住。
-                // 透過 OwnerCharacter 獲取膠囊碰撞體
-                OwnerCharacter->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision); 
-
-                // 禁用玩家輸入 (透過 OwnerCharacter 呼叫其輔助函式)
-                OwnerCharacter->SetPlayerInputEnabled(false);
-            }
-            else
-            {
-                // 如果 Montage_Play 返回 0.0 (例如，蒙太奇無效或播放失敗)
-                UE_LOG(LogTemp, Warning, TEXT("EntranceAnimationComponent: Montage_Play failed for EntranceMontage. Enabling Player Input."));
-                // 如果蒙太奇無法播放，立即重新啟用輸入，避免卡住
-                OwnerCharacter->SetPlayerInputEnabled(true); 
-            }
+            // 綁定到 Montage 結束事件作為安全網。
+            // 先移除現有的委託，以防止重複綁定 (如果 PlayEntranceAnimation 被再次呼叫)。
+            AnimInstance->OnMontageEnded.RemoveDynamic(this, &UEntranceAnimationComponent::OnMontageEnded); 
+            // 添加動態委託，當蒙太奇結束時，呼叫 OnMontageEnded 函式。
+            AnimInstance->OnMontageEnded.AddDynamic(this, &UEntranceAnimationComponent::OnMontageEnded);
+            
+            // 在動畫期間禁用角色移動組件，防止玩家移動。
+            // 透過 OwnerCharacter 獲取角色移動組件
+            OwnerCharacter->GetCharacterMovement()->DisableMovement();
+            // 在動畫期間禁用膠囊碰撞體的碰撞，防止角色被推動或卡住。
+            // 透過 OwnerCharacter 獲取膠囊碰撞體
+            OwnerCharacter->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision); 
+
+            // 禁用玩家輸入 (透過 OwnerCharacter 呼叫其輔助函式)
+            OwnerCharacter->SetPlayerInputEnabled(false);
         }
-        else // 如果 AnimInstance 為空 (表示網格或動畫實例有問題)
+        else
         {
-            UE_LOG(LogTemp, Warning, TEXT("EntranceAnimationComponent: AnimInstance is null for OwnerCharacter. Enabling Player Input."));
-            // 如果 AnimInstance 為空，立即重新啟用輸入
-            OwnerCharacter->SetPlayerInputEnabled(true); 
+            // 如果 Montage_Play 返回 0.0 (例如，蒙太奇無效或播放失敗)
+            UE_LOG(LogTemp, Warning, TEXT("EntranceAnimationComponent: Montage_Play failed for EntranceMontage. Enabling Player Input."));
+            // 如果蒙太奇無法播放，立即重新啟用輸入，避免卡住
+            AbortEntranceAnimation();
         }
     }
-    else // 如果沒有設定入場動畫 Montage
+    else // 如果 AnimInstance 為空 (表示網格或動畫實例有問題)
     {
-        UE_LOG(LogTemp, Warning, TEXT("EntranceAnimationComponent: EntranceMontage is not set! Enabling Player Input."));
-        // 如果沒有指定蒙太奇，直接啟用輸入
-        OwnerCharacter->SetPlayerInputEnabled(true); 
+        UE_LOG(LogTemp, Warning, TEXT("EntranceAnimationComponent: AnimInstance is null for OwnerCharacter. Enabling Player Input."));
+        // 如果 AnimInstance 為空，立即重新啟用輸入
+        AbortEntranceAnimation();
+    }
+}
+
+void UEntranceAnimationComponent::AbortEntranceAnimation()
+{
+    // 等待載入期間已經鎖住移動與碰撞，需要一併恢復
+    if (bIsPlayingEntranceAnimation)
+    {
+        bIsPlayingEntranceAnimation = false;
+        OwnerCharacter->GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+        OwnerCharacter->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    }
+    OwnerCharacter->SetPlayerInputEnabled(true);
+    EntranceMontageHandle.Reset();
+}
+
+void UEntranceAnimationComponent::ResetEntranceAnimation()
+{
+    // 取消等待中的載入，避免回調在角色被重用後才播放上一輪的入場動畫
+    if (EntranceMontageHandle.IsValid() && EntranceMontageHandle->IsLoadingInProgress())
+    {
+        EntranceMontageHandle->CancelHandle();
+    }
+    EntranceMontageHandle.Reset();
+
+    if (OwnerCharacter && OwnerCharacter->GetMesh())
+    {
+        if (UAnimInstance* AnimInstance = OwnerCharacter->GetMesh()->GetAnimInstance())
+        {
+            // 先移除委託，停止蒙太奇時不會觸發安全網而交還輸入
+            AnimInstance->OnMontageEnded.RemoveDynamic(this, &UEntranceAnimationComponent::OnMontageEnded);
+            if (UAnimMontage* Montage = EntranceMontage.Get())
+            {
+                AnimInstance->Montage_Stop(0.0f, Montage);
+            }
+        }
+    }
+
+    // 播放或等待載入期間鎖住的移動與膠囊碰撞一併恢復；
+    // 否則下一輪入場動畫沒有完整執行時 (例如 Montage_Play 失敗)，角色會以沒有碰撞的膠囊體離開角色池
+    if (bIsPlayingEntranceAnimation && OwnerCharacter)
+    {
+        OwnerCharacter->GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+        OwnerCharacter->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    }
+    bIsPlayingEntranceAnimation = false;
+}
+
+void UEntranceAnimationComponent::GetPreloadAssets(TArray<FSoftObjectPath>& OutPaths, const UWorld* World) const
+{
+    // 專用伺服器不播放入場動畫 (見 PlayEntranceAnimation)，不需要載入。
+    // 與 PlayEntranceAnimation 一樣以世界的網路模式判斷；預設物件沒有世界，因此由呼叫端傳入，沒有世界時退回行程層級的判斷
+    const bool bDedicatedServer = World ? World->GetNetMode() == NM_DedicatedServer : IsRunningDedicatedServer();
+    if (!EntranceMontage.IsNull() && !bDedicatedServer)
+    {
+        OutPaths.AddUnique(EntranceMontage.ToSoftObjectPath());
     }
 }
 
@@ -114,6 +217,7 @@ void UEntranceAnimationComponent::OnEntranceAnimationFinishedByNotify()
     {
         UE_LOG(LogTemp, Log, TEXT("EntranceAnimationComponent: Entrance Animation Finished by Anim Notify! Enabling Player Input."));
         bIsPlayingEntranceAnimation = false; // 設定旗標為 false，表示入場動畫結束
+        EntranceMontageHandle.Reset(); // 入場動畫只播放一次，不再需要持有蒙太奇
         
         // 啟用玩家輸入 (透過 OwnerCharacter 呼叫)
         OwnerCharacter->SetPlayerInputEnabled(true); 
@@ -141,10 +245,11 @@ void UEntranceAnimationComponent::OnMontageEnded(UAnimMontage* Montage, bool bIn
     if (!OwnerCharacter) return;
 
     // 檢查結束的蒙太奇是否是我們的入場蒙太奇，並且我們仍然處於「正在播放入場動畫」的狀態。
-    if (Montage == EntranceMontage && bIsPlayingEntranceAnimation) 
+    if (Montage && Montage == EntranceMontage.Get() && bIsPlayingEntranceAnimation) 
     {
         UE_LOG(LogTemp, Warning, TEXT("EntranceAnimationComponent: Entrance Montage Ended (safety net triggered)! Forcing Input Enabled."));
         bIsPlayingEntranceAnimation = false; // 設定旗標為 false
+        EntranceMontageHandle.Reset(); // 入場動畫只播放一次，不再需要持有蒙太奇
         
         // 強制啟用玩家輸入 (透過 OwnerCharacter 呼叫)
         OwnerCharacter->SetPlayerInputEnabled(true); 
@@ -3,21 +3,45 @@
 #include "Core/CharacterBase.h"
 #include "Engine/DamageEvents.h"
 #include "GameFramework/DamageType.h" // 引用 DamageType 相關頭檔，雖然本範例未使用具體類型判斷，但標準函數需要
+#include "Components/CapsuleComponent.h" // 空間索引需要監聽膠囊體的移動
+#include "Components/SkeletalMeshComponent.h" // 角色池停用骨架更新
+#include "GameFramework/CharacterMovementComponent.h" // 角色池重設移動狀態
+#include "Subsystems/CharacterSpatialIndexSubsystem.h" // 角色空間索引
+#include "Subsystems/CharacterHealthSubsystem.h" // SoA 生命值
+#include "Subsystems/CharacterHitboxHistorySubsystem.h" // 延遲補償的命中框歷史
+#include "Subsystems/CombatDamageSubsystem.h" // FCoalescedDamageSource
+#include "Core/CombatDebug.h" // 可由控制台變數開關的除錯日誌
+#include "Net/UnrealNetwork.h" // DOREPLIFETIME
+#include "Net/Core/PushModel/PushModel.h" // MARK_PROPERTY_DIRTY_FROM_NAME
+
+namespace HealthReplication
+{
+    // ReplicatedHealthState 的位元配置：低 15 位元為生命值比例，最高位元為死亡旗標
+    static constexpr uint16 DeadBit = 1 << 15;
+    static constexpr uint16 MaxQuantizedHealth = DeadBit - 1;
+}
 
 // Sets default values
 ACharacterBase::ACharacterBase()
 {
-    // Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-    PrimaryActorTick.bCanEverTick = true;
+    // 基礎角色本身不需要 Tick (藍圖子類實作 Event Tick 時會自動啟用)
+    PrimaryActorTick.bCanEverTick = false;
 
     // 初始化生命值
     MaxHealth = 100.0f; // 預設最大生命值
     CurrentHealth = MaxHealth; // 初始化時生命值等於最大生命值
     bIsDead = false; // 初始化時未死亡
+    HealthRegenPerSecond = 0.0f; // 預設不自動回復
+    bCoalesceHealthNotifications = false; // 預設每次變化都立即廣播
 
     // 初始化無敵時間
     InvincibilityDuration = 0.5f; // 預設無敵時間 0.5 秒
-    bIsInInvincibility = false; // 預設不在無敵狀態
+
+    ReplicatedHealthState = EncodeHealthState(CurrentHealth, MaxHealth, bIsDead);
+
+    HealthSubsystem = nullptr;
+    SpatialIndexSubsystem = nullptr;
+    HitboxHistorySubsystem = nullptr;
 }
 
 // Called when the game starts or when spawned
@@ -26,26 +50,261 @@ void ACharacterBase::BeginPlay()
     Super::BeginPlay();
 
     // 在遊戲開始時，如果生命值沒有從藍圖設定，則確保 CurrentHealth 等於 MaxHealth
-    if (CurrentHealth == 0.0f) // 簡單檢查，避免藍圖未賦值導致初始為0
+    // (客戶端的鏡像已由 OnRep_HealthState 設定，已死亡的角色不能在這裡被補滿)
+    if (CurrentHealth == 0.0f && !bIsDead) // 簡單檢查，避免藍圖未賦值導致初始為0
     {
         CurrentHealth = MaxHealth;
     }
 
+    // 登錄到生命值子系統，之後的讀寫都經過句柄
+    // 客戶端的生命值由伺服器複製，不在本地回復，避免與伺服器的值來回跳動
+    HealthSubsystem = GetWorld()->GetSubsystem<UCharacterHealthSubsystem>();
+    if (HealthSubsystem)
+    {
+        HealthHandle = HealthSubsystem->RegisterCharacter(this, MaxHealth, CurrentHealth, InvincibilityDuration, HasAuthority() ? HealthRegenPerSecond : 0.0f);
+        if (HasAuthority())
+        {
+            UpdateReplicatedHealthState();
+        }
+        else if (bIsDead)
+        {
+            HealthSubsystem->SetReplicatedHealth(HealthHandle, CurrentHealth, true);
+        }
+    }
+
     // 可以在這裡廣播初始生命值，用於 UI 初始化
-    OnHealthChanged.Broadcast(CurrentHealth, MaxHealth);
+    NotifyHealthChanged();
+
+    // 登錄到空間索引與命中框歷史
+    RegisterQueryIndices();
+}
+
+void ACharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UnregisterQueryIndices();
+
+    if (HasHealthHandle())
+    {
+        SyncHealthMirror();
+        HealthSubsystem->UnregisterCharacter(HealthHandle);
+    }
+    HealthHandle = INDEX_NONE;
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ACharacterBase::RegisterQueryIndices()
+{
+    // 登錄到空間索引，並在膠囊體移動時增量更新
+    SpatialIndexSubsystem = GetWorld()->GetSubsystem<UCharacterSpatialIndexSubsystem>();
+    if (SpatialIndexSubsystem && SpatialIndexHandle == INDEX_NONE)
+    {
+        SpatialIndexHandle = SpatialIndexSubsystem->RegisterCharacter(this);
+        GetCapsuleComponent()->TransformUpdated.AddUObject(this, &ACharacterBase::OnCapsuleTransformUpdated);
+    }
+
+    // 命中判定只在伺服器執行，因此只有權威端需要記錄歷史位置
+    if (HasAuthority())
+    {
+        HitboxHistorySubsystem = GetWorld()->GetSubsystem<UCharacterHitboxHistorySubsystem>();
+        if (HitboxHistorySubsystem && HitboxHistoryHandle == INDEX_NONE)
+        {
+            HitboxHistoryHandle = HitboxHistorySubsystem->RegisterCharacter(this);
+        }
+    }
+}
+
+void ACharacterBase::UnregisterQueryIndices()
+{
+    // 從空間索引移除，避免查詢回傳已離開世界 (或在池中) 的角色
+    if (SpatialIndexHandle != INDEX_NONE)
+    {
+        GetCapsuleComponent()->TransformUpdated.RemoveAll(this);
+        if (SpatialIndexSubsystem)
+        {
+            SpatialIndexSubsystem->UnregisterCharacter(SpatialIndexHandle);
+        }
+        SpatialIndexHandle = INDEX_NONE;
+    }
+
+    if (HitboxHistorySubsystem && HitboxHistoryHandle != INDEX_NONE)
+    {
+        HitboxHistorySubsystem->UnregisterCharacter(HitboxHistoryHandle);
+    }
+    HitboxHistoryHandle = INDEX_NONE;
+}
+
+void ACharacterBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(ACharacterBase, ReplicatedHealthState, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(ACharacterBase, MaxHealth, Params);
+}
+
+void ACharacterBase::OnCapsuleTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+    if (SpatialIndexSubsystem)
+    {
+        SpatialIndexSubsystem->UpdateCharacter(SpatialIndexHandle, this);
+    }
+}
+
+void ACharacterBase::OnStartCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust)
+{
+    Super::OnStartCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
+
+    if (SpatialIndexSubsystem)
+    {
+        SpatialIndexSubsystem->UpdateCharacterShape(SpatialIndexHandle, this);
+    }
 }
 
-// Called every frame
-void ACharacterBase::Tick(float DeltaTime)
+void ACharacterBase::OnEndCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust)
 {
-    Super::Tick(DeltaTime);
+    Super::OnEndCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
+
+    if (SpatialIndexSubsystem)
+    {
+        SpatialIndexSubsystem->UpdateCharacterShape(SpatialIndexHandle, this);
+    }
 }
 
 // --- 傷害與生命值系統實作 ---
+// 生命值存放在 UCharacterHealthSubsystem 的緊密陣列中，這裡只負責廣播與藍圖事件
+
+float ACharacterBase::GetCurrentHealth() const
+{
+    return HasHealthHandle() ? HealthSubsystem->GetCurrentHealth(HealthHandle) : CurrentHealth;
+}
+
+float ACharacterBase::GetMaxHealth() const
+{
+    return HasHealthHandle() ? HealthSubsystem->GetMaxHealth(HealthHandle) : MaxHealth;
+}
+
+bool ACharacterBase::IsDead() const
+{
+    return HasHealthHandle() ? HealthSubsystem->IsDead(HealthHandle) : bIsDead;
+}
+
+void ACharacterBase::SetMaxHealth(float NewMaxHealth)
+{
+    MaxHealth = NewMaxHealth;
+    if (HasAuthority())
+    {
+        MARK_PROPERTY_DIRTY_FROM_NAME(ACharacterBase, MaxHealth, this);
+    }
+    if (HasHealthHandle())
+    {
+        HealthSubsystem->SetMaxHealth(HealthHandle, NewMaxHealth);
+        SyncHealthMirror();
+    }
+    NotifyHealthChanged();
+}
+
+void ACharacterBase::NotifyHealthChanged()
+{
+    // 合併模式：只標記為待通知，由子系統在幀末 (或畫面外時依頻率) 送出一次
+    if (bCoalesceHealthNotifications && HasHealthHandle())
+    {
+        HealthSubsystem->RequestHealthNotification(HealthHandle);
+        return;
+    }
+
+    BroadcastHealthChanged();
+}
+
+void ACharacterBase::BroadcastHealthChanged()
+{
+    const float Health = GetCurrentHealth();
+    const float Max = GetMaxHealth();
+    OnHealthChangedNative.Broadcast(Health, Max);
+    OnHealthChanged.Broadcast(Health, Max);
+}
+
+void ACharacterBase::SyncHealthMirror()
+{
+    CurrentHealth = HealthSubsystem->GetCurrentHealth(HealthHandle);
+    bIsDead = HealthSubsystem->IsDead(HealthHandle);
+
+    // 所有修改生命值的路徑都會經過這裡，伺服器順便更新複製的量化值
+    if (HasAuthority())
+    {
+        UpdateReplicatedHealthState();
+    }
+}
+
+// ====================================================================
+// >>> 生命值複製 <<<
+// 伺服器只在量化後的值改變時標記為髒 (Push Model)，未變化的角色在複製時直接略過比較。
+// 客戶端收到後寫回子系統，並走與本地相同的廣播與死亡流程。
+// ====================================================================
+
+uint16 ACharacterBase::EncodeHealthState(float Health, float InMaxHealth, bool bDead)
+{
+    uint16 Quantized = 0;
+    if (InMaxHealth > 0.0f && Health > 0.0f)
+    {
+        const float Ratio = FMath::Clamp(Health / InMaxHealth, 0.0f, 1.0f);
+        // 還活著的角色至少保留 1，避免極少的生命值被量化成 0 而在客戶端顯示為空血
+        Quantized = static_cast<uint16>(FMath::Max(FMath::RoundToInt(Ratio * HealthReplication::MaxQuantizedHealth), 1));
+    }
+    return Quantized | (bDead ? HealthReplication::DeadBit : 0);
+}
+
+void ACharacterBase::DecodeHealthState(uint16 State, float InMaxHealth, float& OutHealth, bool& bOutDead)
+{
+    bOutDead = (State & HealthReplication::DeadBit) != 0;
+    OutHealth = InMaxHealth * static_cast<float>(State & HealthReplication::MaxQuantizedHealth) / HealthReplication::MaxQuantizedHealth;
+}
+
+void ACharacterBase::UpdateReplicatedHealthState()
+{
+    const uint16 NewState = EncodeHealthState(GetCurrentHealth(), GetMaxHealth(), IsDead());
+    if (NewState != ReplicatedHealthState)
+    {
+        ReplicatedHealthState = NewState;
+        MARK_PROPERTY_DIRTY_FROM_NAME(ACharacterBase, ReplicatedHealthState, this);
+    }
+}
+
+void ACharacterBase::OnRep_HealthState()
+{
+    const bool bWasDead = IsDead();
+    DecodeHealthState(ReplicatedHealthState, MaxHealth, CurrentHealth, bIsDead);
+
+    // 初始複製可能早於 BeginPlay，此時只更新鏡像，登錄時再帶入子系統
+    if (!HasHealthHandle())
+    {
+        return;
+    }
+
+    HealthSubsystem->SetReplicatedHealth(HealthHandle, CurrentHealth, bIsDead);
+    NotifyHealthChanged();
+
+    if (bIsDead && !bWasDead)
+    {
+        HandleDeath();
+    }
+}
+
+void ACharacterBase::OnRep_MaxHealth()
+{
+    if (HasHealthHandle())
+    {
+        HealthSubsystem->SetMaxHealth(HealthHandle, MaxHealth);
+    }
+
+    // 生命值以比例量化，上限改變時重新換算
+    OnRep_HealthState();
+}
 
 void ACharacterBase::Heal(float HealAmount)
 {
-    if (bIsDead) // 已死亡則無法恢復
+    if (!HasHealthHandle() || IsDead()) // 已死亡則無法恢復
     {
         return;
     }
@@ -54,10 +313,11 @@ void ACharacterBase::Heal(float HealAmount)
     HealAmount = FMath::Abs(HealAmount); // 確保是正數，以防意外傳入負值
 
     // 增加生命值，並限制在 MaxHealth 範圍內
-    CurrentHealth = FMath::Clamp(CurrentHealth + HealAmount, 0.0f, MaxHealth);
+    HealthSubsystem->ApplyHeal(HealthHandle, HealAmount);
+    SyncHealthMirror();
 
     // 廣播生命值改變事件 (UI 更新)
-    OnHealthChanged.Broadcast(CurrentHealth, MaxHealth);
+    NotifyHealthChanged();
 
     // 觸發藍圖治療事件
     OnHealedBlueprintEvent(HealAmount);
@@ -67,8 +327,8 @@ void ACharacterBase::Heal(float HealAmount)
 
 float ACharacterBase::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
-    // 如果已經死亡，或者正處於無敵狀態，則不處理傷害
-    if (bIsDead || bIsInInvincibility)
+    // 如果尚未登錄、已經死亡，或者正處於無敵狀態，則不處理傷害
+    if (!HasHealthHandle() || IsDead() || IsInInvincibility())
     {
         return 0.0f; // 返回 0 表示沒有實際造成傷害
     }
@@ -77,34 +337,69 @@ float ACharacterBase::TakeDamage(float DamageAmount, FDamageEvent const& DamageE
     // 重要的是，這個函數在引擎內部處理各種傷害類型，最終會呼叫到這裏
     const float ActualDamage = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 
-    // 減去生命值，並限制在 0 到 MaxHealth 之間
-    CurrentHealth = FMath::Clamp(CurrentHealth - ActualDamage, 0.0f, MaxHealth);
+    // 減去生命值 (限制在 0 到 MaxHealth 之間)；沒有死亡時子系統會啟動無敵時間
+    const bool bDied = HealthSubsystem->ApplyDamage(HealthHandle, ActualDamage);
+    SyncHealthMirror();
 
     // 廣播生命值改變事件
-    OnHealthChanged.Broadcast(CurrentHealth, MaxHealth);
+    NotifyHealthChanged();
 
     // 觸發藍圖受傷事件
     OnDamagedBlueprintEvent(ActualDamage, EventInstigator, DamageCauser);
 
     // 檢查是否死亡
-    if (CurrentHealth <= 0.0f && !bIsDead)
+    if (bDied)
     {
-        bIsDead = true;
-        // 觸發藍圖死亡事件
-        OnDeathBlueprintEvent();
-        // 可以在這裡添加角色的禁用輸入、禁用碰撞等邏輯
-        // 例如：SetActorEnableCollision(ECollisionEnabled::NoCollision);
-        // GetMesh()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-        // GetCharacterMovement()->DisableMovement();
-        // 如果是玩家角色，可能需要禁用控制器輸入
-        // if (AController* PC = GetController()) { PC->DisableInput(nullptr); }
+        HandleDeath();
     }
-    else // 如果沒有死亡，則啟動無敵時間
+
+    return ActualDamage; // 返回實際造成的傷害量
+}
+
+float ACharacterBase::ApplyCoalescedDamage(TConstArrayView<FCoalescedDamageSource> Sources)
+{
+    // 合併後的傷害視為一次命中：無敵只在開頭檢查一次，無敵時間在第一個來源套用後開始但不會擋下其餘來源，
+    // 因此同一幀內的所有命中都會生效，而廣播、死亡處理與計時器只執行一次
+    if (!HasHealthHandle() || IsDead() || IsInInvincibility())
     {
-        StartInvincibility();
+        return 0.0f;
     }
 
-    return ActualDamage; // 返回實際造成的傷害量
+    TArray<float, TInlineAllocator<4>> ActualDamages;
+    float TotalActualDamage = 0.0f;
+    bool bDied = false;
+    for (const FCoalescedDamageSource& Source : Sources)
+    {
+        COMBAT_DEBUG_LOG(TEXT("%s: applying %.1f coalesced damage from %d hits by %s."), *GetName(), Source.Damage, Source.HitCount, *GetNameSafe(Source.EventInstigator.Get()));
+
+        // 每個來源各自經過引擎的傷害處理 (OnTakeAnyDamage 等)，傷害歸屬不會被合併掉
+        const float ActualDamage = Super::TakeDamage(Source.Damage, FDamageEvent(), Source.EventInstigator.Get(), Source.DamageCauser.Get());
+        ActualDamages.Add(ActualDamage);
+        TotalActualDamage += ActualDamage;
+
+        bDied = HealthSubsystem->ApplyDamage(HealthHandle, ActualDamage);
+        if (bDied)
+        {
+            break; // 之後的來源不再對已死亡的角色造成傷害
+        }
+    }
+    SyncHealthMirror();
+
+    // 廣播生命值改變事件 (只一次)
+    NotifyHealthChanged();
+
+    // 受傷藍圖事件在生命值更新後依來源觸發
+    for (int32 Index = 0; Index < ActualDamages.Num(); ++Index)
+    {
+        OnDamagedBlueprintEvent(ActualDamages[Index], Sources[Index].EventInstigator.Get(), Sources[Index].DamageCauser.Get());
+    }
+
+    if (bDied)
+    {
+        HandleDeath();
+    }
+
+    return TotalActualDamage;
 }
 
 void ACharacterBase::ApplyDamageToHealth(float DamageAmount)
@@ -119,18 +414,129 @@ void ACharacterBase::ApplyDamageToHealth(float DamageAmount)
     TakeDamage(DamageAmount, FDamageEvent(), nullptr, nullptr); 
 }
 
+void ACharacterBase::HandleBatchedHealthChange(bool bDied)
+{
+    // 批次路徑沒有個別的傷害來源，因此只廣播生命值與死亡，不觸發受傷的藍圖事件
+    SyncHealthMirror();
+    NotifyHealthChanged();
+
+    if (bDied)
+    {
+        HandleDeath();
+    }
+}
+
+void ACharacterBase::HandleDeath()
+{
+    // 觸發藍圖死亡事件
+    OnDeathBlueprintEvent();
+    // 可以在這裡添加角色的禁用輸入、禁用碰撞等邏輯
+    // 例如：SetActorEnableCollision(ECollisionEnabled::NoCollision);
+    // GetMesh()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    // GetCharacterMovement()->DisableMovement();
+    // 如果是玩家角色，可能需要禁用控制器輸入
+    // if (AController* PC = GetController()) { PC->DisableInput(nullptr); }
+}
+
+void ACharacterBase::Revive()
+{
+    if (!HasHealthHandle())
+    {
+        return;
+    }
+
+    HealthSubsystem->Revive(HealthHandle);
+    SyncHealthMirror();
+    NotifyHealthChanged();
+}
+
+bool ACharacterBase::IsInInvincibility() const
+{
+    return HasHealthHandle() && HealthSubsystem->IsInvincible(HealthHandle);
+}
+
 void ACharacterBase::StartInvincibility()
 {
-    if (!bIsInInvincibility)
+    if (HasHealthHandle())
     {
-        bIsInInvincibility = true;
-        // 設定定時器，在 InvincibilityDuration 後呼叫 EndInvincibility
-        GetWorldTimerManager().SetTimer(InvincibilityTimerHandle, this, &ACharacterBase::EndInvincibility, InvincibilityDuration, false);
+        // 子系統只記錄結束時間，TakeDamage 時比較即可
+        HealthSubsystem->StartInvincibility(HealthHandle);
     }
 }
 
 void ACharacterBase::EndInvincibility()
 {
-    bIsInInvincibility = false;
-    GetWorldTimerManager().ClearTimer(InvincibilityTimerHandle); // 清除定時器，避免重複呼叫
+    if (HasHealthHandle())
+    {
+        HealthSubsystem->EndInvincibility(HealthHandle);
+    }
+}
+
+// ====================================================================
+// >>> 角色池 <<<
+// 放回池中的角色保留所有組件、輸入綁定與子系統的生命值句柄，只是被隱藏並停用；
+// 取出時重設狀態即可重用，省下 SpawnActor / Destroy 的組件建立、BeginPlay 與登錄成本
+// ====================================================================
+
+void ACharacterBase::OnReleasedToPool()
+{
+    bInPool = true;
+
+    ResetPooledState();
+
+    // 退出查詢索引：命中判定、範圍查詢與複製圖的群眾節點都看不到池中的角色
+    UnregisterQueryIndices();
+
+    SetActorHiddenInGame(true);
+    SetActorEnableCollision(false);
+    bActorTickEnabledBeforePool = IsActorTickEnabled();
+    SetActorTickEnabled(false);
+    if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+    {
+        MovementComp->DisableMovement(); // 不會下落，也不會因 KillZ 被銷毀
+        MovementComp->SetComponentTickEnabled(false);
+    }
+    if (GetMesh())
+    {
+        GetMesh()->SetComponentTickEnabled(false); // 隱藏的骨架預設仍會更新姿勢
+    }
+}
+
+void ACharacterBase::OnAcquiredFromPool(const FTransform& SpawnTransform)
+{
+    // 先移動再登錄，空間索引與命中框歷史直接從新位置開始
+    SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+    ResetPooledState();
+
+    SetActorHiddenInGame(false);
+    SetActorEnableCollision(true);
+    SetActorTickEnabled(bActorTickEnabledBeforePool);
+    if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+    {
+        MovementComp->SetComponentTickEnabled(true);
+        MovementComp->SetDefaultMovementMode();
+    }
+    if (GetMesh())
+    {
+        GetMesh()->SetComponentTickEnabled(true);
+    }
+
+    RegisterQueryIndices();
+
+    bInPool = false;
+}
+
+void ACharacterBase::ResetPooledState()
+{
+    // 生命值：回滿並清除死亡、無敵與尚未結算的傷害 / 治療 (Revive 會廣播給血條)
+    Revive();
+
+    if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+    {
+        MovementComp->StopMovementImmediately();
+        MovementComp->ClearAccumulatedForces();
+    }
+    ResetJumpState();
+    bPressedJump = false;
 }
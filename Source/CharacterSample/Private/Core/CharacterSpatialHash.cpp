@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/CharacterSpatialHash.h"
+
+FCharacterSpatialHash::FCharacterSpatialHash(float InCellSize)
+    : CellSize(FMath::Max(InCellSize, 1.0f))
+    , InvCellSize(1.0f / FMath::Max(InCellSize, 1.0f))
+{
+}
+
+// ====================================================================
+// >>> 條目管理 <<<
+// ====================================================================
+
+int32 FCharacterSpatialHash::Add(ACharacterBase* Character, const FVector& Location, float Radius, float HalfHeight)
+{
+    check(Character);
+
+    int32 Handle;
+    if (FreeList.Num() > 0)
+    {
+        Handle = FreeList.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        Handle = Entries.AddDefaulted();
+    }
+
+    FEntry& Entry = Entries[Handle];
+    Entry.Character = Character;
+    Entry.Location = Location;
+    Entry.Radius = Radius;
+    Entry.HalfHeight = HalfHeight;
+    MaxEntryRadius = FMath::Max(MaxEntryRadius, Radius);
+
+    AddToCell(Handle, GetCellKey(Location));
+    ++NumEntries;
+
+    return Handle;
+}
+
+void FCharacterSpatialHash::Remove(int32 Handle)
+{
+    if (!Entries.IsValidIndex(Handle) || !Entries[Handle].Character)
+    {
+        return;
+    }
+
+    RemoveFromCell(Handle);
+    Entries[Handle] = FEntry();
+    FreeList.Add(Handle);
+    --NumEntries;
+}
+
+void FCharacterSpatialHash::Update(int32 Handle, const FVector& Location)
+{
+    FEntry& Entry = Entries[Handle];
+    Entry.Location = Location;
+
+    // 大部分移動都留在同一個格子裡，只需要更新位置
+    const uint64 NewCellKey = GetCellKey(Location);
+    if (NewCellKey != Entry.CellKey)
+    {
+        RemoveFromCell(Handle);
+        AddToCell(Handle, NewCellKey);
+    }
+}
+
+void FCharacterSpatialHash::UpdateShape(int32 Handle, float Radius, float HalfHeight)
+{
+    FEntry& Entry = Entries[Handle];
+    Entry.Radius = Radius;
+    Entry.HalfHeight = HalfHeight;
+    MaxEntryRadius = FMath::Max(MaxEntryRadius, Radius);
+}
+
+void FCharacterSpatialHash::AddToCell(int32 Handle, uint64 CellKey)
+{
+    FCell& Cell = Cells.FindOrAdd(CellKey);
+    Entries[Handle].CellKey = CellKey;
+    Entries[Handle].SlotInCell = Cell.Add(Handle);
+}
+
+void FCharacterSpatialHash::RemoveFromCell(int32 Handle)
+{
+    FEntry& Entry = Entries[Handle];
+    FCell* Cell = Cells.Find(Entry.CellKey);
+    if (!Cell)
+    {
+        return;
+    }
+
+    // 與最後一個元素交換後移除，並修正被搬移條目的槽位
+    const int32 Slot = Entry.SlotInCell;
+    Cell->RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    if (Cell->IsValidIndex(Slot))
+    {
+        Entries[(*Cell)[Slot]].SlotInCell = Slot;
+    }
+
+    // 空格子保留在表中，角色來回穿越邊界時可以避免反覆配置
+    Entry.SlotInCell = INDEX_NONE;
+}
+
+// ====================================================================
+// >>> 查詢 <<<
+// ====================================================================
+
+template <typename VisitorType>
+void FCharacterSpatialHash::ForEachEntryInBounds(const FVector2D& Min, const FVector2D& Max, VisitorType&& Visitor) const
+{
+    // 條目只存放在中心所在的格子，因此以最大半徑擴張格子範圍
+    const int32 MinX = ToCellCoord(Min.X - MaxEntryRadius);
+    const int32 MinY = ToCellCoord(Min.Y - MaxEntryRadius);
+    const int32 MaxX = ToCellCoord(Max.X + MaxEntryRadius);
+    const int32 MaxY = ToCellCoord(Max.Y + MaxEntryRadius);
+
+    for (int32 X = MinX; X <= MaxX; ++X)
+    {
+        for (int32 Y = MinY; Y <= MaxY; ++Y)
+        {
+            if (const FCell* Cell = Cells.Find(MakeCellKey(X, Y)))
+            {
+                for (const int32 Handle : *Cell)
+                {
+                    Visitor(Entries[Handle]);
+                }
+            }
+        }
+    }
+}
+
+void FCharacterSpatialHash::QueryRadius(const FVector& Center, float Radius, TArray<ACharacterBase*>& OutCharacters) const
+{
+    const FVector2D Center2D(Center);
+    const FVector2D Extent(Radius, Radius);
+
+    ForEachEntryInBounds(Center2D - Extent, Center2D + Extent, [&](const FEntry& Entry)
+    {
+        // 以包住膠囊體的圓柱做保守測試
+        const double HorizontalLimit = Radius + Entry.Radius;
+        if (FVector2D::DistSquared(Center2D, FVector2D(Entry.Location)) <= HorizontalLimit * HorizontalLimit
+            && FMath::Abs(Center.Z - Entry.Location.Z) <= Radius + Entry.HalfHeight)
+        {
+            OutCharacters.Add(Entry.Character);
+        }
+    });
+}
+
+void FCharacterSpatialHash::QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Range, TArray<ACharacterBase*>& OutCharacters) const
+{
+    const FVector2D Origin2D(Origin);
+    const FVector2D Direction2D = FVector2D(Direction).GetSafeNormal();
+    const double HalfAngle = FMath::DegreesToRadians(HalfAngleDegrees);
+    const FVector2D Extent(Range, Range);
+
+    ForEachEntryInBounds(Origin2D - Extent, Origin2D + Extent, [&](const FEntry& Entry)
+    {
+        const FVector2D ToEntry = FVector2D(Entry.Location) - Origin2D;
+        const double DistSquared = ToEntry.SizeSquared();
+        const double RangeLimit = Range + Entry.Radius;
+        if (DistSquared > RangeLimit * RangeLimit || FMath::Abs(Origin.Z - Entry.Location.Z) > Range + Entry.HalfHeight)
+        {
+            return;
+        }
+
+        // 圓覆蓋原點的條目一律視為在錐形內；
+        // 其餘以條目的圓從原點看去所張的半角 asin(半徑 / 距離) 放寬錐角，邊緣擦過錐形的條目也不會漏掉
+        const double Dist = FMath::Sqrt(DistSquared);
+        if (Dist <= Entry.Radius || Dist <= UE_KINDA_SMALL_NUMBER)
+        {
+            OutCharacters.Add(Entry.Character);
+            return;
+        }
+
+        const double AngleToEntry = FMath::Acos(FMath::Clamp(FVector2D::DotProduct(Direction2D, ToEntry) / Dist, -1.0, 1.0));
+        if (AngleToEntry <= HalfAngle + FMath::Asin(Entry.Radius / Dist))
+        {
+            OutCharacters.Add(Entry.Character);
+        }
+    });
+}
+
+void FCharacterSpatialHash::QuerySegment(const FVector& Start, const FVector& End, float Radius, TArray<ACharacterBase*>& OutCharacters) const
+{
+    const FVector Segment = End - Start;
+    const double SegmentLengthSquared = Segment.SizeSquared();
+    const FVector2D Extent(Radius, Radius);
+    const FVector2D Min = FVector2D::Min(FVector2D(Start), FVector2D(End)) - Extent;
+    const FVector2D Max = FVector2D::Max(FVector2D(Start), FVector2D(End)) + Extent;
+
+    ForEachEntryInBounds(Min, Max, [&](const FEntry& Entry)
+    {
+        // 以膠囊體的外接球 (半徑 = 半高) 對掃掠線段做保守測試，精確測試交給窄相
+        const double T = SegmentLengthSquared > UE_SMALL_NUMBER
+            ? FMath::Clamp(FVector::DotProduct(Entry.Location - Start, Segment) / SegmentLengthSquared, 0.0, 1.0)
+            : 0.0;
+        const double Limit = Radius + FMath::Max(Entry.HalfHeight, Entry.Radius);
+        if (FVector::DistSquared(Start + Segment * T, Entry.Location) <= Limit * Limit)
+        {
+            OutCharacters.Add(Entry.Character);
+        }
+    });
+}
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/CombatDebug.h"
+
+#if COMBAT_DEBUG_ENABLED
+
+#include "Engine/Engine.h" // 用於 GEngine->AddOnScreenDebugMessage
+#include "HAL/IConsoleManager.h" // 用於註冊控制台變數
+
+namespace CombatDebug
+{
+    bool bDebugText = false;
+
+    static FAutoConsoleVariableRef CVarDebugText(
+        TEXT("CharacterSample.Combat.DebugText"),
+        bDebugText,
+        TEXT("顯示戰鬥的畫面除錯訊息與熱路徑日誌 (連擊、命中、傷害)。"),
+        ECVF_Cheat);
+
+#if COMBAT_DEBUG_VISUALS_ENABLED
+    bool bDebugDraw = false;
+
+    static FAutoConsoleVariableRef CVarDebugDraw(
+        TEXT("CharacterSample.Combat.DebugDraw"),
+        bDebugDraw,
+        TEXT("繪製攻擊掃掠與命中點。"),
+        ECVF_Cheat);
+
+    void AddOnScreenMessage(const FColor& Color, const TCHAR* Message)
+    {
+        if (GEngine)
+        {
+            GEngine->AddOnScreenDebugMessage(-1, 2.f, Color, Message);
+        }
+    }
+#endif
+}
+
+#endif
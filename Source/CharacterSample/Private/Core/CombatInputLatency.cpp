@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Core/CombatInputLatency.h"
+#include "Core/LatencyHistogram.h"
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+#include "Misc/App.h" // FApp::GetCurrentTime
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Combat Input To Montage Last (ms)"), STAT_CombatInputToMontageLast, STATGROUP_CharacterSample);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Combat Input To Montage p99 (ms)"), STAT_CombatInputToMontageP99, STATGROUP_CharacterSample);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Combat Frame To Montage p99 (ms)"), STAT_CombatFrameToMontageP99, STATGROUP_CharacterSample);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Combat Buffered Resolve Delay p99 (ms)"), STAT_CombatBufferedResolveDelayP99, STATGROUP_CharacterSample);
+
+namespace CombatInputLatency
+{
+    struct FHistograms
+    {
+        // 直接開始的一段
+        FLatencyHistogram FrameToInput;    // 幀開始 -> 收到輸入 (這一幀在輸入之前的工作)
+        FLatencyHistogram InputToMontage;  // 收到輸入 -> Montage_Play 回傳
+        FLatencyHistogram FrameToMontage;  // 幀開始 -> Montage_Play 回傳 (本地可量測的端到端延遲)
+
+        // 緩衝輸入
+        FLatencyHistogram BufferedInputToMontage; // 收到輸入 -> Montage_Play 回傳 (包含等待窗口開啟)
+        FLatencyHistogram BufferedResolveDelay;   // 可接續的世界時間 -> 實際處理 (由蒙太奇追趕補償的部分)
+    };
+
+    static FHistograms Histograms;
+
+    void RecordSegmentStart(double InputPlatformTime, bool bBuffered, double ResolveDelaySeconds)
+    {
+        const double MontagePlatformTime = FPlatformTime::Seconds();
+        const double InputToMontageMs = (MontagePlatformTime - InputPlatformTime) * 1000.0;
+
+        if (bBuffered)
+        {
+            Histograms.BufferedInputToMontage.AddSampleMs(InputToMontageMs);
+            Histograms.BufferedResolveDelay.AddSampleMs(ResolveDelaySeconds * 1000.0);
+            SET_FLOAT_STAT(STAT_CombatBufferedResolveDelayP99, Histograms.BufferedResolveDelay.GetPercentileMs(99.0));
+            return;
+        }
+
+        Histograms.InputToMontage.AddSampleMs(InputToMontageMs);
+        SET_FLOAT_STAT(STAT_CombatInputToMontageLast, InputToMontageMs);
+        SET_FLOAT_STAT(STAT_CombatInputToMontageP99, Histograms.InputToMontage.GetPercentileMs(99.0));
+
+        // 固定步長時 FApp::GetCurrentTime 不是真實時間，不記錄幀開始的階段
+        if (!FApp::UseFixedTimeStep())
+        {
+            const double FrameStartTime = FApp::GetCurrentTime();
+            Histograms.FrameToInput.AddSampleMs((InputPlatformTime - FrameStartTime) * 1000.0);
+            Histograms.FrameToMontage.AddSampleMs((MontagePlatformTime - FrameStartTime) * 1000.0);
+            SET_FLOAT_STAT(STAT_CombatFrameToMontageP99, Histograms.FrameToMontage.GetPercentileMs(99.0));
+        }
+    }
+
+    void Reset()
+    {
+        Histograms = FHistograms();
+    }
+}
+
+// ====================================================================
+// >>> 控制台指令：輸入延遲的百分位數 <<<
+// 用法：CharacterSample.Combat.InputLatency [reset]
+//       CharacterSample.Combat.InputLatency check <p99 上限毫秒> [reset]
+// check 在直接輸入的 幀開始 -> 蒙太奇 p99 (固定步長時改用 輸入 -> 蒙太奇) 超過上限時以 Error 記錄
+// "InputLatency regression"，供自動化測試以日誌判定。
+// ====================================================================
+static void DumpCombatInputLatency(const TArray<FString>& Args)
+{
+    using namespace CombatInputLatency;
+
+    UE_LOG(LogTemp, Log, TEXT("InputLatency [direct] frame->input   %s"), *Histograms.FrameToInput.ToString());
+    UE_LOG(LogTemp, Log, TEXT("InputLatency [direct] input->montage %s"), *Histograms.InputToMontage.ToString());
+    UE_LOG(LogTemp, Log, TEXT("InputLatency [direct] frame->montage %s"), *Histograms.FrameToMontage.ToString());
+    UE_LOG(LogTemp, Log, TEXT("InputLatency [buffered] input->montage %s"), *Histograms.BufferedInputToMontage.ToString());
+    UE_LOG(LogTemp, Log, TEXT("InputLatency [buffered] resolve delay  %s"), *Histograms.BufferedResolveDelay.ToString());
+
+    if (Args.Num() > 1 && Args[0].Equals(TEXT("check"), ESearchCase::IgnoreCase))
+    {
+        const double MaxP99Ms = FCString::Atod(*Args[1]);
+        const FLatencyHistogram& Checked = Histograms.FrameToMontage.Num() > 0 ? Histograms.FrameToMontage : Histograms.InputToMontage;
+        const double P99Ms = Checked.GetPercentileMs(99.0);
+        if (Checked.Num() == 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("InputLatency check: no direct inputs were recorded."));
+        }
+        else if (P99Ms > MaxP99Ms)
+        {
+            UE_LOG(LogTemp, Error, TEXT("InputLatency regression: p99 %.3f ms exceeds %.3f ms (%lld samples)."), P99Ms, MaxP99Ms, Checked.Num());
+        }
+        else
+        {
+            UE_LOG(LogTemp, Log, TEXT("InputLatency check passed: p99 %.3f ms <= %.3f ms (%lld samples)."), P99Ms, MaxP99Ms, Checked.Num());
+        }
+    }
+
+    if (Args.Contains(TEXT("reset")))
+    {
+        Reset();
+    }
+}
+
+static FAutoConsoleCommandWithArgs GCombatInputLatencyCommand(
+    TEXT("CharacterSample.Combat.InputLatency"),
+    TEXT("輸出攻擊輸入到蒙太奇開始的延遲百分位數。參數：[check <p99 上限毫秒>] [reset]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&DumpCombatInputLatency));
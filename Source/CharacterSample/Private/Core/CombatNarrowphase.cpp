@@ -0,0 +1,434 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/CombatNarrowphase.h"
+#include "Components/CapsuleComponent.h" // 讀取膠囊體位置與尺寸
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "Math/VectorRegister.h" // VectorRegister4Float (SSE / NEON / 純量後備)
+
+// ====================================================================
+// >>> FCombatCapsuleSoA 實作 <<<
+// ====================================================================
+
+void FCombatCapsuleSoA::Reset()
+{
+    CenterX.Reset();
+    CenterY.Reset();
+    CenterZ.Reset();
+    CoreHalfHeight.Reset();
+    Radius.Reset();
+    NumCapsules = 0;
+}
+
+void FCombatCapsuleSoA::Reserve(int32 Count)
+{
+    const int32 PaddedCount = Align(Count, Lanes);
+    CenterX.Reserve(PaddedCount);
+    CenterY.Reserve(PaddedCount);
+    CenterZ.Reserve(PaddedCount);
+    CoreHalfHeight.Reserve(PaddedCount);
+    Radius.Reserve(PaddedCount);
+}
+
+int32 FCombatCapsuleSoA::Add(const FVector& Center, float InRadius, float HalfHeight)
+{
+    const int32 Index = NumCapsules++;
+
+    // 需要新的一組 4 個槽位時，一次補齊 (補齊的槽位填 0，輸出時會被忽略)
+    if (Index >= CenterX.Num())
+    {
+        CenterX.AddZeroed(Lanes);
+        CenterY.AddZeroed(Lanes);
+        CenterZ.AddZeroed(Lanes);
+        CoreHalfHeight.AddZeroed(Lanes);
+        Radius.AddZeroed(Lanes);
+    }
+
+    CenterX[Index] = static_cast<float>(Center.X);
+    CenterY[Index] = static_cast<float>(Center.Y);
+    CenterZ[Index] = static_cast<float>(Center.Z);
+    CoreHalfHeight[Index] = FMath::Max(HalfHeight - InRadius, 0.0f);
+    Radius[Index] = InRadius;
+
+    return Index;
+}
+
+int32 FCombatCapsuleSoA::Add(const UCapsuleComponent* Capsule)
+{
+    check(Capsule);
+
+    float CapsuleRadius = 0.0f;
+    float CapsuleHalfHeight = 0.0f;
+    Capsule->GetScaledCapsuleSize(CapsuleRadius, CapsuleHalfHeight);
+
+    return Add(Capsule->GetComponentLocation(), CapsuleRadius, CapsuleHalfHeight);
+}
+
+// ====================================================================
+// >>> 窄相核心 <<<
+// 線段對線段的最近點 (Ericson, Real-Time Collision Detection 5.1.9)：
+//   掃掠線段 P(s) = A + s * D，膠囊核心線段 Q(t) = Bottom + t * E，E = (0, 0, 2 * CoreHalfHeight)
+// 純量與 SIMD 版本必須保持相同的運算順序，任何修改都要同時更新兩者。
+// ====================================================================
+
+namespace CombatNarrowphase
+{
+    // 退化判斷的門檻：掃掠長度或膠囊核心長度的平方小於此值時視為點
+    static constexpr float DegenerateEpsilon = 1.e-6f;
+
+    // 與 SSE 的 max/min 相同的語義 (a > b ? a : b)，確保 ±0 與 NaN 的處理和 SIMD 一致
+    static FORCEINLINE float Clamp01(float Value)
+    {
+        const float Lower = Value > 0.0f ? Value : 0.0f;
+        return Lower < 1.0f ? Lower : 1.0f;
+    }
+
+    // 每次掃掠只需計算一次的共用值
+    struct FSweepTerms
+    {
+        float Ax, Ay, Az;   // 掃掠起點
+        float Dx, Dy, Dz;   // 掃掠方向 (End - Start)
+        float A;            // D · D
+        float SweepRadius;
+        bool bStationary;   // 掃掠長度為 0，只剩一個球體
+
+        explicit FSweepTerms(const FCombatSweptSphere& Sweep)
+        {
+            Ax = Sweep.Start.X;
+            Ay = Sweep.Start.Y;
+            Az = Sweep.Start.Z;
+            Dx = Sweep.End.X - Sweep.Start.X;
+            Dy = Sweep.End.Y - Sweep.Start.Y;
+            Dz = Sweep.End.Z - Sweep.Start.Z;
+            A = (Dx * Dx + Dy * Dy) + Dz * Dz;
+            SweepRadius = Sweep.Radius;
+            bStationary = A <= DegenerateEpsilon;
+        }
+    };
+
+    static FORCEINLINE bool TestCapsule(const FSweepTerms& Terms, float CenterX, float CenterY, float CenterZ, float CoreHalfHeight, float CapsuleRadius)
+    {
+        const float Ez = CoreHalfHeight + CoreHalfHeight;
+        const float BottomZ = CenterZ - CoreHalfHeight;
+        const float Rx = Terms.Ax - CenterX;
+        const float Ry = Terms.Ay - CenterY;
+        const float Rz = Terms.Az - BottomZ;
+        const float E = Ez * Ez;
+        const float F = Ez * Rz;
+        const bool bEValid = E > DegenerateEpsilon;
+
+        float S;
+        float T;
+        if (Terms.bStationary)
+        {
+            S = 0.0f;
+            T = bEValid ? Clamp01(F / E) : 0.0f;
+        }
+        else
+        {
+            const float B = Terms.Dz * Ez;
+            const float C = (Terms.Dx * Rx + Terms.Dy * Ry) + Terms.Dz * Rz;
+            const float SLow = Clamp01((0.0f - C) / Terms.A);
+
+            if (!bEValid)
+            {
+                // 膠囊核心退化為點：只需找掃掠線段上最近的點
+                S = SLow;
+                T = 0.0f;
+            }
+            else
+            {
+                const float Denom = Terms.A * E - B * B;
+                const float SMid = Denom > 0.0f ? Clamp01((B * F - C * E) / Denom) : 0.0f;
+                const float TNom = B * SMid + F;
+
+                if (TNom < 0.0f)
+                {
+                    S = SLow;
+                    T = 0.0f;
+                }
+                else if (TNom > E)
+                {
+                    S = Clamp01((B - C) / Terms.A);
+                    T = 1.0f;
+                }
+                else
+                {
+                    S = SMid;
+                    T = TNom / E;
+                }
+            }
+        }
+
+        const float DistX = Rx + Terms.Dx * S;
+        const float DistY = Ry + Terms.Dy * S;
+        const float DistZ = (Rz + Terms.Dz * S) - Ez * T;
+        const float DistSquared = (DistX * DistX + DistY * DistY) + DistZ * DistZ;
+        const float RadiusSum = Terms.SweepRadius + CapsuleRadius;
+
+        return DistSquared <= RadiusSum * RadiusSum;
+    }
+
+    bool SweptSphereVsCapsule(const FCombatSweptSphere& Sweep, float CenterX, float CenterY, float CenterZ, float CoreHalfHeight, float CapsuleRadius)
+    {
+        return TestCapsule(FSweepTerms(Sweep), CenterX, CenterY, CenterZ, CoreHalfHeight, CapsuleRadius);
+    }
+
+    int32 SweptSphereVsCapsulesScalar(const FCombatSweptSphere& Sweep, const FCombatCapsuleSoA& Capsules, TArray<int32>& OutHitIndices)
+    {
+        const FSweepTerms Terms(Sweep);
+        int32 NumHits = 0;
+
+        for (int32 Index = 0; Index < Capsules.Num(); ++Index)
+        {
+            if (TestCapsule(Terms, Capsules.CenterX[Index], Capsules.CenterY[Index], Capsules.CenterZ[Index], Capsules.CoreHalfHeight[Index], Capsules.Radius[Index]))
+            {
+                OutHitIndices.Add(Index);
+                ++NumHits;
+            }
+        }
+
+        return NumHits;
+    }
+
+    static FORCEINLINE VectorRegister4Float VectorClamp01(const VectorRegister4Float& Value, const VectorRegister4Float& Zero, const VectorRegister4Float& One)
+    {
+        return VectorMin(VectorMax(Value, Zero), One);
+    }
+
+    int32 SweptSphereVsCapsulesSIMD(const FCombatSweptSphere& Sweep, const FCombatCapsuleSoA& Capsules, TArray<int32>& OutHitIndices)
+    {
+        const FSweepTerms Terms(Sweep);
+        const int32 Num = Capsules.Num();
+        int32 NumHits = 0;
+
+        const VectorRegister4Float Zero = VectorZeroFloat();
+        const VectorRegister4Float One = VectorOneFloat();
+        const VectorRegister4Float Epsilon = VectorSetFloat1(DegenerateEpsilon);
+
+        const VectorRegister4Float Ax = VectorSetFloat1(Terms.Ax);
+        const VectorRegister4Float Ay = VectorSetFloat1(Terms.Ay);
+        const VectorRegister4Float Az = VectorSetFloat1(Terms.Az);
+        const VectorRegister4Float Dx = VectorSetFloat1(Terms.Dx);
+        const VectorRegister4Float Dy = VectorSetFloat1(Terms.Dy);
+        const VectorRegister4Float Dz = VectorSetFloat1(Terms.Dz);
+        const VectorRegister4Float A = VectorSetFloat1(Terms.A);
+        const VectorRegister4Float SweepRadius = VectorSetFloat1(Terms.SweepRadius);
+
+        for (int32 Base = 0; Base < Num; Base += FCombatCapsuleSoA::Lanes)
+        {
+            const VectorRegister4Float CenterX = VectorLoadAligned(&Capsules.CenterX[Base]);
+            const VectorRegister4Float CenterY = VectorLoadAligned(&Capsules.CenterY[Base]);
+            const VectorRegister4Float CenterZ = VectorLoadAligned(&Capsules.CenterZ[Base]);
+            const VectorRegister4Float CoreHalfHeight = VectorLoadAligned(&Capsules.CoreHalfHeight[Base]);
+            const VectorRegister4Float CapsuleRadius = VectorLoadAligned(&Capsules.Radius[Base]);
+
+            const VectorRegister4Float Ez = VectorAdd(CoreHalfHeight, CoreHalfHeight);
+            const VectorRegister4Float BottomZ = VectorSubtract(CenterZ, CoreHalfHeight);
+            const VectorRegister4Float Rx = VectorSubtract(Ax, CenterX);
+            const VectorRegister4Float Ry = VectorSubtract(Ay, CenterY);
+            const VectorRegister4Float Rz = VectorSubtract(Az, BottomZ);
+            const VectorRegister4Float E = VectorMultiply(Ez, Ez);
+            const VectorRegister4Float F = VectorMultiply(Ez, Rz);
+            const VectorRegister4Float EValid = VectorCompareGT(E, Epsilon);
+            const VectorRegister4Float ESafe = VectorSelect(EValid, E, One); // 避免無效車道除以 0
+
+            VectorRegister4Float S;
+            VectorRegister4Float T;
+            if (Terms.bStationary)
+            {
+                S = Zero;
+                T = VectorSelect(EValid, VectorClamp01(VectorDivide(F, ESafe), Zero, One), Zero);
+            }
+            else
+            {
+                const VectorRegister4Float B = VectorMultiply(Dz, Ez);
+                const VectorRegister4Float C = VectorAdd(VectorAdd(VectorMultiply(Dx, Rx), VectorMultiply(Dy, Ry)), VectorMultiply(Dz, Rz));
+                const VectorRegister4Float SLow = VectorClamp01(VectorDivide(VectorSubtract(Zero, C), A), Zero, One);
+                const VectorRegister4Float SHigh = VectorClamp01(VectorDivide(VectorSubtract(B, C), A), Zero, One);
+
+                const VectorRegister4Float Denom = VectorSubtract(VectorMultiply(A, E), VectorMultiply(B, B));
+                const VectorRegister4Float DenomValid = VectorCompareGT(Denom, Zero);
+                const VectorRegister4Float DenomSafe = VectorSelect(DenomValid, Denom, One);
+                const VectorRegister4Float SMid = VectorSelect(DenomValid,
+                    VectorClamp01(VectorDivide(VectorSubtract(VectorMultiply(B, F), VectorMultiply(C, E)), DenomSafe), Zero, One),
+                    Zero);
+                const VectorRegister4Float TNom = VectorAdd(VectorMultiply(B, SMid), F);
+                const VectorRegister4Float TMid = VectorDivide(TNom, ESafe);
+
+                const VectorRegister4Float Below = VectorCompareLT(TNom, Zero);
+                const VectorRegister4Float Above = VectorCompareGT(TNom, E);
+
+                S = VectorSelect(Below, SLow, VectorSelect(Above, SHigh, SMid));
+                T = VectorSelect(Below, Zero, VectorSelect(Above, One, TMid));
+
+                // 膠囊核心退化為點的車道
+                S = VectorSelect(EValid, S, SLow);
+                T = VectorSelect(EValid, T, Zero);
+            }
+
+            const VectorRegister4Float DistX = VectorAdd(Rx, VectorMultiply(Dx, S));
+            const VectorRegister4Float DistY = VectorAdd(Ry, VectorMultiply(Dy, S));
+            const VectorRegister4Float DistZ = VectorSubtract(VectorAdd(Rz, VectorMultiply(Dz, S)), VectorMultiply(Ez, T));
+            const VectorRegister4Float DistSquared = VectorAdd(VectorAdd(VectorMultiply(DistX, DistX), VectorMultiply(DistY, DistY)), VectorMultiply(DistZ, DistZ));
+            const VectorRegister4Float RadiusSum = VectorAdd(SweepRadius, CapsuleRadius);
+
+            int32 HitMask = VectorMaskBits(VectorCompareLE(DistSquared, VectorMultiply(RadiusSum, RadiusSum)));
+
+            // 依車道順序輸出，忽略補齊的槽位
+            while (HitMask)
+            {
+                const int32 Lane = FMath::CountTrailingZeros(static_cast<uint32>(HitMask));
+                const int32 Index = Base + Lane;
+                if (Index >= Num)
+                {
+                    break;
+                }
+                OutHitIndices.Add(Index);
+                ++NumHits;
+                HitMask &= HitMask - 1;
+            }
+        }
+
+        return NumHits;
+    }
+}
+
+// ====================================================================
+// >>> 控制台指令：純量 / SIMD 一致性驗證 <<<
+// 用法：CharacterSample.Narrowphase.Verify [測試次數，預設 100000]
+// 以隨機形狀 (包含零長度掃掠、核心退化的膠囊、垂直掃掠與恰好接觸的邊界) 比較兩個版本的輸出
+// ====================================================================
+static void RunNarrowphaseVerify(const TArray<FString>& Args)
+{
+    const int32 NumTrials = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100000;
+    const int32 CapsulesPerTrial = 37; // 刻意不是 4 的倍數，覆蓋補齊的槽位
+
+    FRandomStream RandomStream(0x5EED);
+    FCombatCapsuleSoA Capsules;
+    TArray<int32> ScalarHits;
+    TArray<int32> SIMDHits;
+    int32 NumMismatches = 0;
+    int64 NumHits = 0;
+
+    for (int32 Trial = 0; Trial < NumTrials; ++Trial)
+    {
+        FCombatSweptSphere Sweep;
+        Sweep.Start = FVector3f(RandomStream.FRandRange(-300.0f, 300.0f), RandomStream.FRandRange(-300.0f, 300.0f), RandomStream.FRandRange(-100.0f, 200.0f));
+        Sweep.Radius = RandomStream.FRandRange(0.0f, 100.0f);
+
+        const int32 Variant = Trial % 4;
+        if (Variant == 0)
+        {
+            Sweep.End = Sweep.Start; // 零長度掃掠
+        }
+        else if (Variant == 1)
+        {
+            Sweep.End = Sweep.Start + FVector3f(0.0f, 0.0f, RandomStream.FRandRange(-200.0f, 200.0f)); // 垂直掃掠，與膠囊核心平行
+        }
+        else
+        {
+            Sweep.End = Sweep.Start + FVector3f(RandomStream.GetUnitVector()) * RandomStream.FRandRange(0.0f, 300.0f);
+        }
+
+        Capsules.Reset();
+        for (int32 Index = 0; Index < CapsulesPerTrial; ++Index)
+        {
+            const float CapsuleRadius = RandomStream.FRandRange(10.0f, 60.0f);
+            // 約四分之一的膠囊半高等於半徑，核心退化為點 (即球體)
+            const float HalfHeight = RandomStream.FRand() < 0.25f ? CapsuleRadius : CapsuleRadius + RandomStream.FRandRange(0.0f, 100.0f);
+            Capsules.Add(FVector(RandomStream.FRandRange(-400.0f, 400.0f), RandomStream.FRandRange(-400.0f, 400.0f), RandomStream.FRandRange(-100.0f, 200.0f)), CapsuleRadius, HalfHeight);
+        }
+
+        // 加入一個恰好接觸掃掠起點的膠囊，測試 <= 的邊界
+        Capsules.Add(FVector(Sweep.Start) + FVector(Sweep.Radius + 30.0f, 0.0f, 0.0f), 30.0f, 30.0f);
+
+        ScalarHits.Reset();
+        SIMDHits.Reset();
+        CombatNarrowphase::SweptSphereVsCapsulesScalar(Sweep, Capsules, ScalarHits);
+        CombatNarrowphase::SweptSphereVsCapsulesSIMD(Sweep, Capsules, SIMDHits);
+        NumHits += ScalarHits.Num();
+
+        if (ScalarHits != SIMDHits)
+        {
+            if (NumMismatches < 10)
+            {
+                UE_LOG(LogTemp, Error, TEXT("Narrowphase Verify: trial %d mismatch (scalar %d hits, SIMD %d hits)."), Trial, ScalarHits.Num(), SIMDHits.Num());
+            }
+            ++NumMismatches;
+        }
+    }
+
+    if (NumMismatches == 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Narrowphase Verify: PASSED. %d trials, %lld hits, scalar and SIMD results identical."), NumTrials, NumHits);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("Narrowphase Verify: FAILED. %d of %d trials mismatched."), NumMismatches, NumTrials);
+    }
+}
+
+static FAutoConsoleCommandWithArgs GCombatNarrowphaseVerifyCommand(
+    TEXT("CharacterSample.Narrowphase.Verify"),
+    TEXT("驗證掃掠球體對膠囊體的 SIMD 版本與純量版本輸出完全一致。參數：[測試次數]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunNarrowphaseVerify));
+
+// ====================================================================
+// >>> 控制台指令：吞吐量測試 <<<
+// 用法：CharacterSample.Narrowphase.Benchmark [膠囊數，預設 1024] [迭代次數，預設 10000]
+// 攻擊形狀與 PerformNormalAttackHitCheck 相同 (半徑 70，長度 150)
+// ====================================================================
+static void RunNarrowphaseBenchmark(const TArray<FString>& Args)
+{
+    const int32 NumCapsules = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1024;
+    const int32 NumIterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 10000;
+
+    FRandomStream RandomStream(0xBE7C);
+    FCombatCapsuleSoA Capsules;
+    Capsules.Reserve(NumCapsules);
+    for (int32 Index = 0; Index < NumCapsules; ++Index)
+    {
+        // 預設角色膠囊體：半徑 34，半高 88
+        Capsules.Add(FVector(RandomStream.FRandRange(-1000.0f, 1000.0f), RandomStream.FRandRange(-1000.0f, 1000.0f), 88.0f), 34.0f, 88.0f);
+    }
+
+    FCombatSweptSphere Sweep;
+    Sweep.Start = FVector3f(0.0f, 0.0f, 100.0f);
+    Sweep.End = Sweep.Start + FVector3f(150.0f, 0.0f, 0.0f);
+    Sweep.Radius = 70.0f;
+
+    TArray<int32> HitIndices;
+    HitIndices.Reserve(NumCapsules);
+    int64 ScalarHits = 0;
+    int64 SIMDHits = 0;
+
+    const double ScalarStartTime = FPlatformTime::Seconds();
+    for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+    {
+        HitIndices.Reset();
+        ScalarHits += CombatNarrowphase::SweptSphereVsCapsulesScalar(Sweep, Capsules, HitIndices);
+    }
+    const double ScalarSeconds = FPlatformTime::Seconds() - ScalarStartTime;
+
+    const double SIMDStartTime = FPlatformTime::Seconds();
+    for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+    {
+        HitIndices.Reset();
+        SIMDHits += CombatNarrowphase::SweptSphereVsCapsulesSIMD(Sweep, Capsules, HitIndices);
+    }
+    const double SIMDSeconds = FPlatformTime::Seconds() - SIMDStartTime;
+
+    const double TotalTests = static_cast<double>(NumCapsules) * NumIterations;
+    UE_LOG(LogTemp, Log, TEXT("Narrowphase Benchmark [%d capsules x %d iterations]: Scalar %.2f M capsules/s (%.2f ns/capsule) | SIMD %.2f M capsules/s (%.2f ns/capsule) | Speedup x%.2f | Hits %lld / %lld"),
+        NumCapsules, NumIterations,
+        TotalTests / ScalarSeconds / 1e6, ScalarSeconds * 1e9 / TotalTests,
+        TotalTests / SIMDSeconds / 1e6, SIMDSeconds * 1e9 / TotalTests,
+        SIMDSeconds > 0.0 ? ScalarSeconds / SIMDSeconds : 0.0,
+        ScalarHits, SIMDHits);
+}
+
+static FAutoConsoleCommandWithArgs GCombatNarrowphaseBenchmarkCommand(
+    TEXT("CharacterSample.Narrowphase.Benchmark"),
+    TEXT("量測掃掠球體對膠囊體窄相的純量與 SIMD 吞吐量。參數：[膠囊數] [迭代次數]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunNarrowphaseBenchmark));
@@ -0,0 +1,297 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/CombatSimulator.h"
+#include "Core/LatencyHistogram.h"
+#include "Player/PlayerCharacter.h"
+#include "Components/CombatComponent.h"
+#include "Components/EntranceAnimationComponent.h"
+#include "Subsystems/CombatHitQuerySubsystem.h"
+#include "Subsystems/CombatDamageSubsystem.h"
+#include "Subsystems/GameplayTimerSubsystem.h"
+#include "Subsystems/CharacterAssetPreloadSubsystem.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+
+namespace CombatSimulator
+{
+    // 藍圖角色帶有網格、動畫藍圖與攻擊蒙太奇；找不到時退回原生類別 (沒有蒙太奇，無法產生連擊)
+    static const TCHAR* PlayerCharacterClassPath = TEXT("/Game/ThirdPerson/Blueprints/PlayerCharacter/BP_PlayerCharacter.BP_PlayerCharacter_C");
+
+    static constexpr float PairSpacing = 1000.0f; // 每組對戰之間的距離，避免互相干擾
+    static constexpr float DuelDistance = 120.0f; // 同組兩個角色之間的距離，落在攻擊掃掠範圍內
+
+    // 每個模擬階段的耗時
+    struct FStageHistograms
+    {
+        FLatencyHistogram Input;     // 腳本輸入 (連擊狀態機)
+        FLatencyHistogram WorldTick; // 整個 UWorld::Tick
+        FLatencyHistogram Timers;    // 時間軸事件與連擊計時器
+        FLatencyHistogram HitQuery;  // 命中查詢
+        FLatencyHistogram Damage;    // 幀末傷害合併
+        FLatencyHistogram Step;      // 完整的一個固定步長
+    };
+
+    static UWorld* CreateSimulationWorld()
+    {
+        UWorld::InitializationValues InitValues;
+        InitValues
+            .AllowAudioPlayback(false)
+            .RequiresHitProxies(false)
+            .CreateNavigation(false)
+            .CreateAISystem(false)
+            .CreateFXSystem(false)
+            .ShouldSimulatePhysics(false)
+            .SetTransactional(false);
+
+        UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CombatSimWorld"), nullptr, true, ERHIFeatureLevel::Num, &InitValues);
+        if (!World)
+        {
+            return nullptr;
+        }
+
+        GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+
+        World->InitializeActorsForPlay(FURL());
+        World->BeginPlay();
+
+        // 沒有遊戲模式時不會經由 GameState 通知開始遊戲，需要手動讓後續生成的角色執行 BeginPlay
+        if (!World->HasBegunPlay())
+        {
+            World->GetWorldSettings()->NotifyBeginPlay();
+        }
+        return World;
+    }
+
+    static void DestroySimulationWorld(UWorld* World)
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+        World->RemoveFromRoot();
+    }
+
+    static APlayerCharacter* SpawnHeadlessCharacter(UWorld* World, UClass* CharacterClass, const FTransform& Transform)
+    {
+        APlayerCharacter* Character = World->SpawnActorDeferred<APlayerCharacter>(CharacterClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+        if (!Character)
+        {
+            return nullptr;
+        }
+
+        // 必須在 BeginPlay 之前設定：跳過入場動畫，並讓連擊改由時間軸事件驅動
+        if (Character->CombatComponent)
+        {
+            Character->CombatComponent->SetHeadless(true);
+        }
+        if (Character->EntranceAnimationComponent)
+        {
+            Character->EntranceAnimationComponent->EntranceMontage.Reset();
+        }
+
+        Character->FinishSpawning(Transform);
+
+        // 不需要動畫姿勢與移動模擬，只保留碰撞與戰鬥邏輯
+        if (USkeletalMeshComponent* Mesh = Character->GetMesh())
+        {
+            Mesh->SetComponentTickEnabled(false);
+        }
+        if (UCharacterMovementComponent* MovementComp = Character->GetCharacterMovement())
+        {
+            MovementComp->SetComponentTickEnabled(false);
+        }
+        return Character;
+    }
+
+    bool Run(const FSettings& Settings)
+    {
+        if (!GEngine)
+        {
+            return false;
+        }
+
+        const int32 NumPairs = FMath::Max(1, (Settings.NumCharacters + 1) / 2);
+        const float StepSeconds = 1.0f / FMath::Max(Settings.StepHz, 1.0f);
+        const int32 NumSteps = FMath::Max(1, FMath::CeilToInt32(Settings.DurationSeconds / StepSeconds));
+
+        UClass* CharacterClass = LoadClass<APlayerCharacter>(nullptr, PlayerCharacterClassPath);
+        if (!CharacterClass)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Sim.Run: %s not found, falling back to APlayerCharacter (no montages, no combos)."), PlayerCharacterClassPath);
+            CharacterClass = APlayerCharacter::StaticClass();
+        }
+
+        // 蒙太奇是軟引用，而模擬期間不會執行引擎主迴圈處理非同步載入：生成前同步載入，並在整個模擬期間持有
+        const TSharedPtr<FStreamableHandle> CharacterAssetsHandle = UCharacterAssetPreloadSubsystem::LoadCharacterAssetsSync(CharacterClass);
+
+        const FPlatformMemoryStats MemoryBefore = FPlatformMemory::GetStats();
+
+        UWorld* World = CreateSimulationWorld();
+        if (!World)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Sim.Run: failed to create the simulation world."));
+            return false;
+        }
+
+        // 生成期間角色與組件會輸出大量初始化日誌，暫時只保留錯誤
+        const ELogVerbosity::Type PreviousVerbosity = LogTemp.GetVerbosity();
+        LogTemp.SetVerbosity(ELogVerbosity::Error);
+
+        TArray<APlayerCharacter*> Characters;
+        Characters.Reserve(NumPairs * 2);
+
+        const int32 GridSize = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(NumPairs)));
+        for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+        {
+            const FVector PairCenter(
+                (PairIndex % GridSize) * PairSpacing,
+                (PairIndex / GridSize) * PairSpacing,
+                100.0f);
+
+            // 兩個角色面對面站立
+            const FVector Offset(DuelDistance * 0.5f, 0.0f, 0.0f);
+            APlayerCharacter* First = SpawnHeadlessCharacter(World, CharacterClass, FTransform(FRotator(0.0f, 0.0f, 0.0f), PairCenter - Offset));
+            APlayerCharacter* Second = SpawnHeadlessCharacter(World, CharacterClass, FTransform(FRotator(0.0f, 180.0f, 0.0f), PairCenter + Offset));
+            if (First && Second)
+            {
+                Characters.Add(First);
+                Characters.Add(Second);
+            }
+        }
+
+        LogTemp.SetVerbosity(PreviousVerbosity);
+
+        const FPlatformMemoryStats MemoryAfterSpawn = FPlatformMemory::GetStats();
+
+        UCombatHitQuerySubsystem* HitQuerySubsystem = World->GetSubsystem<UCombatHitQuerySubsystem>();
+        UCombatDamageSubsystem* DamageSubsystem = World->GetSubsystem<UCombatDamageSubsystem>();
+        UGameplayTimerSubsystem* TimerSubsystem = World->GetSubsystem<UGameplayTimerSubsystem>();
+
+        // 每個角色下一次輸入的模擬時間
+        FRandomStream RandomStream(Settings.Seed);
+        TArray<float> NextInputTimes;
+        NextInputTimes.SetNumUninitialized(Characters.Num());
+        for (float& NextInputTime : NextInputTimes)
+        {
+            NextInputTime = RandomStream.FRandRange(0.0f, Settings.MaxInputInterval);
+        }
+
+        const int64 DamageHitsBefore = DamageSubsystem ? DamageSubsystem->GetStats().TotalHits : 0;
+        const int64 QueriesBefore = HitQuerySubsystem ? HitQuerySubsystem->GetStats().TotalQueries : 0;
+
+        FStageHistograms Histograms;
+        int64 NumInputs = 0;
+        int32 NumDeaths = 0;
+
+        // ====================================================================
+        // >>> 固定步長迴圈 <<<
+        // ====================================================================
+        const double RunStartTime = FPlatformTime::Seconds();
+        for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+        {
+            const double StepStartTime = FPlatformTime::Seconds();
+            const float SimTime = StepIndex * StepSeconds;
+
+            for (int32 Index = 0; Index < Characters.Num(); ++Index)
+            {
+                if (SimTime < NextInputTimes[Index])
+                {
+                    continue;
+                }
+                NextInputTimes[Index] = SimTime + RandomStream.FRandRange(Settings.MinInputInterval, Settings.MaxInputInterval);
+
+                const EComboInput Input = RandomStream.FRand() < Settings.HeavyAttackChance ? EComboInput::Heavy : EComboInput::Light;
+                Characters[Index]->CombatComponent->HandleComboInput(Input);
+                ++NumInputs;
+            }
+
+            const double TickStartTime = FPlatformTime::Seconds();
+            World->Tick(LEVELTICK_All, StepSeconds);
+            const double TickEndTime = FPlatformTime::Seconds();
+
+            // 死亡的角色立即復活，維持固定的對戰數量
+            for (APlayerCharacter* Character : Characters)
+            {
+                if (Character->IsDead())
+                {
+                    Character->Revive();
+                    ++NumDeaths;
+                }
+            }
+
+            const double StepEndTime = FPlatformTime::Seconds();
+
+            Histograms.Input.AddSampleMs((TickStartTime - StepStartTime) * 1000.0);
+            Histograms.WorldTick.AddSampleMs((TickEndTime - TickStartTime) * 1000.0);
+            Histograms.Step.AddSampleMs((StepEndTime - StepStartTime) * 1000.0);
+            if (TimerSubsystem)
+            {
+                Histograms.Timers.AddSampleMs(TimerSubsystem->GetLastTickCostMs());
+            }
+            if (HitQuerySubsystem)
+            {
+                Histograms.HitQuery.AddSampleMs(HitQuerySubsystem->GetStats().LastFrameCostMs);
+            }
+            if (DamageSubsystem)
+            {
+                Histograms.Damage.AddSampleMs(DamageSubsystem->GetStats().LastFrameCostMs);
+            }
+        }
+        const double RunSeconds = FPlatformTime::Seconds() - RunStartTime;
+
+        const FPlatformMemoryStats MemoryAfterRun = FPlatformMemory::GetStats();
+        const int64 DamageHits = DamageSubsystem ? DamageSubsystem->GetStats().TotalHits - DamageHitsBefore : 0;
+        const int64 Queries = HitQuerySubsystem ? HitQuerySubsystem->GetStats().TotalQueries - QueriesBefore : 0;
+
+        // ====================================================================
+        // >>> 報告 <<<
+        // ====================================================================
+        constexpr double BytesToMB = 1.0 / (1024.0 * 1024.0);
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run: %d characters, %d steps @ %.0f Hz (%.1f simulated s) in %.3f s wall -> %.1f ticks/s (x%.1f realtime)"),
+            Characters.Num(), NumSteps, 1.0f / StepSeconds, NumSteps * StepSeconds, RunSeconds,
+            RunSeconds > 0.0 ? NumSteps / RunSeconds : 0.0, RunSeconds > 0.0 ? NumSteps * StepSeconds / RunSeconds : 0.0);
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run: inputs=%lld hit queries=%lld damage hits=%lld deaths=%d"),
+            NumInputs, Queries, DamageHits, NumDeaths);
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run: memory used spawn=%+.2f MB run=%+.2f MB peak=%.2f MB"),
+            (static_cast<double>(MemoryAfterSpawn.UsedPhysical) - MemoryBefore.UsedPhysical) * BytesToMB,
+            (static_cast<double>(MemoryAfterRun.UsedPhysical) - MemoryAfterSpawn.UsedPhysical) * BytesToMB,
+            MemoryAfterRun.PeakUsedPhysical * BytesToMB);
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run:   input     %s"), *Histograms.Input.ToString());
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run:   worldtick %s"), *Histograms.WorldTick.ToString());
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run:   timers    %s"), *Histograms.Timers.ToString());
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run:   hitquery  %s"), *Histograms.HitQuery.ToString());
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run:   damage    %s"), *Histograms.Damage.ToString());
+        UE_LOG(LogTemp, Log, TEXT("Sim.Run:   step      %s"), *Histograms.Step.ToString());
+
+        DestroySimulationWorld(World);
+        return true;
+    }
+}
+
+// ====================================================================
+// >>> 控制台指令：無頭戰鬥模擬 <<<
+// 用法：CharacterSample.Sim.Run [角色數量] [模擬秒數] [步長頻率]
+// ====================================================================
+static FAutoConsoleCommandWithArgs GCombatSimulatorRunCommand(
+    TEXT("CharacterSample.Sim.Run"),
+    TEXT("在獨立世界中以固定步長模擬成對對戰的角色，輸出每秒 Tick 數、記憶體與各階段延遲直方圖。用法：CharacterSample.Sim.Run [角色數量] [模擬秒數] [步長頻率]"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        CombatSimulator::FSettings Settings;
+        if (Args.Num() > 0)
+        {
+            Settings.NumCharacters = FMath::Max(2, FCString::Atoi(*Args[0]));
+        }
+        if (Args.Num() > 1)
+        {
+            Settings.DurationSeconds = FMath::Max(0.1f, FCString::Atof(*Args[1]));
+        }
+        if (Args.Num() > 2)
+        {
+            Settings.StepHz = FMath::Max(1.0f, FCString::Atof(*Args[2]));
+        }
+        CombatSimulator::Run(Settings);
+    }));
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/CrowdBenchmarkUtils.h"
+#include "Core/CharacterBase.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h" // 用於關閉移動組件的 Tick
+
+namespace CrowdBenchmark
+{
+    float GetCrowdHalfExtent(int32 Count, float Spacing)
+    {
+        // 每個角色平均佔用 Spacing x Spacing 的面積
+        return 0.5f * Spacing * FMath::Sqrt(static_cast<float>(FMath::Max(Count, 1)));
+    }
+
+    TArray<ACharacterBase*> SpawnCrowd(UWorld* World, int32 Count, const FVector& Center, float Spacing, FRandomStream& RandomStream)
+    {
+        TArray<ACharacterBase*> Crowd;
+        if (!World)
+        {
+            return Crowd;
+        }
+
+        const float HalfExtent = GetCrowdHalfExtent(Count, Spacing);
+
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn; // 測試時允許重疊
+
+        Crowd.Reserve(Count);
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const FVector Location = Center + FVector(
+                RandomStream.FRandRange(-HalfExtent, HalfExtent),
+                RandomStream.FRandRange(-HalfExtent, HalfExtent),
+                0.0f);
+
+            ACharacterBase* Character = World->SpawnActor<ACharacterBase>(ACharacterBase::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+            if (Character)
+            {
+                // 只需要碰撞與索引資料，關閉 Tick 避免干擾測量
+                Character->SetActorTickEnabled(false);
+                if (UCharacterMovementComponent* MovementComp = Character->GetCharacterMovement())
+                {
+                    MovementComp->SetComponentTickEnabled(false);
+                }
+                Crowd.Add(Character);
+            }
+        }
+
+        return Crowd;
+    }
+
+    void DestroyCrowd(TArray<ACharacterBase*>& Crowd)
+    {
+        for (ACharacterBase* Character : Crowd)
+        {
+            if (IsValid(Character))
+            {
+                Character->Destroy();
+            }
+        }
+        Crowd.Reset();
+    }
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/LatencyHistogram.h"
+
+void FLatencyHistogram::Reset()
+{
+    FMemory::Memzero(Buckets);
+    Count = 0;
+    SumMs = 0.0;
+    MinMs = TNumericLimits<double>::Max();
+    MaxMs = 0.0;
+}
+
+int32 FLatencyHistogram::GetBucketIndex(double Microseconds)
+{
+    // 第 i 個桶涵蓋 [2^(i / BucketsPerOctave), 2^((i + 1) / BucketsPerOctave)) 微秒，小於 1 微秒放在第 0 個桶
+    if (Microseconds <= 1.0)
+    {
+        return 0;
+    }
+    const int32 Index = FMath::FloorToInt32(FMath::Log2(Microseconds) * BucketsPerOctave);
+    return FMath::Clamp(Index, 0, NumBuckets - 1);
+}
+
+double FLatencyHistogram::GetBucketUpperBoundMs(int32 BucketIndex)
+{
+    return FMath::Pow(2.0, static_cast<double>(BucketIndex + 1) / BucketsPerOctave) / 1000.0;
+}
+
+void FLatencyHistogram::AddSampleMs(double Milliseconds)
+{
+    Milliseconds = FMath::Max(Milliseconds, 0.0);
+
+    ++Buckets[GetBucketIndex(Milliseconds * 1000.0)];
+    ++Count;
+    SumMs += Milliseconds;
+    MinMs = FMath::Min(MinMs, Milliseconds);
+    MaxMs = FMath::Max(MaxMs, Milliseconds);
+}
+
+void FLatencyHistogram::Merge(const FLatencyHistogram& Other)
+{
+    for (int32 Index = 0; Index < NumBuckets; ++Index)
+    {
+        Buckets[Index] += Other.Buckets[Index];
+    }
+    Count += Other.Count;
+    SumMs += Other.SumMs;
+    MinMs = FMath::Min(MinMs, Other.MinMs);
+    MaxMs = FMath::Max(MaxMs, Other.MaxMs);
+}
+
+double FLatencyHistogram::GetPercentileMs(double Percentile) const
+{
+    if (Count == 0)
+    {
+        return 0.0;
+    }
+
+    const int64 Rank = FMath::Clamp<int64>(FMath::CeilToInt64(Count * FMath::Clamp(Percentile, 0.0, 100.0) / 100.0), 1, Count);
+
+    int64 Accumulated = 0;
+    for (int32 Index = 0; Index < NumBuckets; ++Index)
+    {
+        Accumulated += Buckets[Index];
+        if (Accumulated >= Rank)
+        {
+            return FMath::Clamp(GetBucketUpperBoundMs(Index), MinMs, MaxMs);
+        }
+    }
+    return MaxMs;
+}
+
+FString FLatencyHistogram::ToString() const
+{
+    return FString::Printf(TEXT("n=%lld mean=%.4fms p50=%.4fms p90=%.4fms p99=%.4fms max=%.4fms"),
+        Count, GetMeanMs(), GetPercentileMs(50.0), GetPercentileMs(90.0), GetPercentileMs(99.0), GetMaxMs());
+}
@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Core/CharacterBase.h"
+#include "Core/WorldTickSampler.h"
+#include "Subsystems/CombatHitQuerySubsystem.h"
+#include "Subsystems/CombatDamageSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "EngineUtils.h" // TActorIterator
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace LoadTest
+{
+    // 一次負載測試的取樣狀態，以計時器週期性寫入一列
+    struct FRun
+    {
+        TWeakObjectPtr<UWorld> World;
+        TSharedPtr<FWorldTickSampler> Sampler;
+        FTimerHandle TimerHandle;
+        FDelegateHandle WorldCleanupHandle;
+        FString FilePath;
+        bool bQuitWhenDone = false;
+
+        double StartTime = 0.0;
+        double EndTime = 0.0;
+        double LastSampleTime = 0.0;
+        uint64 LastOutBytes = 0;
+        uint64 LastInBytes = 0;
+        int64 LastHitQueries = 0;
+        int64 LastDamageHits = 0;
+
+        TArray<FString> Rows;
+    };
+
+    static TSharedPtr<FRun> ActiveRun;
+
+    static const TCHAR* CsvHeader = TEXT("Time,Clients,Characters,WorldTickAvgMs,WorldTickMaxMs,FrameIntervalMs,OutKBps,InKBps,HitQueries,HitQueriesPerSec,DamageHits");
+
+    static void Finish(const TSharedRef<FRun>& Run)
+    {
+        FWorldDelegates::OnWorldCleanup.Remove(Run->WorldCleanupHandle);
+        Run->WorldCleanupHandle.Reset();
+        if (UWorld* World = Run->World.Get())
+        {
+            World->GetTimerManager().ClearTimer(Run->TimerHandle);
+        }
+        Run->Sampler->Stop();
+
+        if (FFileHelper::SaveStringArrayToFile(Run->Rows, *Run->FilePath))
+        {
+            UE_LOG(LogTemp, Log, TEXT("LoadTest Record: wrote %d samples to %s"), Run->Rows.Num() - 1, *FPaths::ConvertRelativePathToFull(Run->FilePath));
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("LoadTest Record: failed to write %s"), *Run->FilePath);
+        }
+
+        if (ActiveRun == Run)
+        {
+            ActiveRun.Reset();
+        }
+
+        if (Run->bQuitWhenDone)
+        {
+            FPlatformMisc::RequestExit(false, TEXT("LoadTest"));
+        }
+    }
+
+    static void Sample(const TSharedRef<FRun>& Run)
+    {
+        UWorld* World = Run->World.Get();
+        if (!World)
+        {
+            Finish(Run);
+            return;
+        }
+
+        const double Now = FPlatformTime::Seconds();
+        const double Seconds = FMath::Max(Now - Run->LastSampleTime, UE_SMALL_NUMBER);
+        const FWorldTickSampler::FSample TickSample = Run->Sampler->Consume();
+
+        int32 NumClients = 0;
+        uint64 OutBytes = Run->LastOutBytes;
+        uint64 InBytes = Run->LastInBytes;
+        if (const UNetDriver* NetDriver = World->GetNetDriver())
+        {
+            NumClients = NetDriver->ClientConnections.Num();
+            OutBytes = static_cast<uint64>(NetDriver->OutTotalBytes);
+            InBytes = static_cast<uint64>(NetDriver->InTotalBytes);
+        }
+
+        int32 NumCharacters = 0;
+        for (TActorIterator<ACharacterBase> It(World); It; ++It)
+        {
+            ++NumCharacters;
+        }
+
+        const UCombatHitQuerySubsystem* HitQuerySubsystem = World->GetSubsystem<UCombatHitQuerySubsystem>();
+        const UCombatDamageSubsystem* DamageSubsystem = World->GetSubsystem<UCombatDamageSubsystem>();
+        const int64 HitQueries = HitQuerySubsystem ? HitQuerySubsystem->GetStats().TotalQueries : 0;
+        const int64 DamageHits = DamageSubsystem ? DamageSubsystem->GetStats().TotalHits : 0;
+
+        Run->Rows.Add(FString::Printf(TEXT("%.2f,%d,%d,%.3f,%.3f,%.3f,%.2f,%.2f,%lld,%.1f,%lld"),
+            Now - Run->StartTime, NumClients, NumCharacters,
+            TickSample.AverageMs, TickSample.MaxMs, TickSample.FrameIntervalMs,
+            (OutBytes - Run->LastOutBytes) / 1024.0 / Seconds,
+            (InBytes - Run->LastInBytes) / 1024.0 / Seconds,
+            HitQueries - Run->LastHitQueries,
+            (HitQueries - Run->LastHitQueries) / Seconds,
+            DamageHits - Run->LastDamageHits));
+
+        Run->LastSampleTime = Now;
+        Run->LastOutBytes = OutBytes;
+        Run->LastInBytes = InBytes;
+        Run->LastHitQueries = HitQueries;
+        Run->LastDamageHits = DamageHits;
+
+        if (Now >= Run->EndTime)
+        {
+            Finish(Run);
+        }
+    }
+}
+
+// ====================================================================
+// >>> 控制台指令：負載測試的 CSV 記錄 <<<
+// 用法 (在伺服器上執行)：CharacterSample.LoadTest.Record [秒數，預設 60] [取樣間隔秒數，預設 1] [名稱，預設 LoadTest] [quit]
+// 每個取樣間隔寫入一列：客戶端數、角色數、世界 Tick 平均與最大時間、平均幀間隔、上下行流量、命中查詢數與傷害提交數。
+// 檔案寫到 Saved/Profiling/LoadTest/<名稱>-<時間>.csv；加上 quit 時寫完後結束行程 (供腳本使用)。
+// ====================================================================
+static void RecordLoadTest(const TArray<FString>& Args, UWorld* World)
+{
+    if (!World || World->GetNetMode() == NM_Client)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("LoadTest Record: must be run on the server."));
+        return;
+    }
+    // 世界已被銷毀但沒有收到清理通知的記錄視為已結束 (保險)
+    if (LoadTest::ActiveRun.IsValid() && !LoadTest::ActiveRun->World.IsValid())
+    {
+        LoadTest::Finish(LoadTest::ActiveRun.ToSharedRef());
+    }
+    if (LoadTest::ActiveRun.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("LoadTest Record: a run is already in progress (%s)."), *LoadTest::ActiveRun->FilePath);
+        return;
+    }
+
+    const float DurationSeconds = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 1.0f) : 60.0f;
+    const float IntervalSeconds = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), 0.1f) : 1.0f;
+    const FString RunName = Args.Num() > 2 ? Args[2] : TEXT("LoadTest");
+
+    TSharedRef<LoadTest::FRun> Run = MakeShared<LoadTest::FRun>();
+    Run->World = World;
+    Run->Sampler = MakeShared<FWorldTickSampler>(World);
+    Run->FilePath = FPaths::ProfilingDir() / TEXT("LoadTest") / FString::Printf(TEXT("%s-%s.csv"), *RunName, *FDateTime::Now().ToString());
+    Run->bQuitWhenDone = Args.Contains(TEXT("quit"));
+    Run->Rows.Add(LoadTest::CsvHeader);
+
+    Run->StartTime = FPlatformTime::Seconds();
+    Run->EndTime = Run->StartTime + DurationSeconds;
+    Run->LastSampleTime = Run->StartTime;
+    if (const UNetDriver* NetDriver = World->GetNetDriver())
+    {
+        Run->LastOutBytes = static_cast<uint64>(NetDriver->OutTotalBytes);
+        Run->LastInBytes = static_cast<uint64>(NetDriver->InTotalBytes);
+    }
+    if (const UCombatHitQuerySubsystem* HitQuerySubsystem = World->GetSubsystem<UCombatHitQuerySubsystem>())
+    {
+        Run->LastHitQueries = HitQuerySubsystem->GetStats().TotalQueries;
+    }
+    if (const UCombatDamageSubsystem* DamageSubsystem = World->GetSubsystem<UCombatDamageSubsystem>())
+    {
+        Run->LastDamageHits = DamageSubsystem->GetStats().TotalHits;
+    }
+
+    Run->Sampler->Start();
+    World->GetTimerManager().SetTimer(Run->TimerHandle, FTimerDelegate::CreateLambda([Run]()
+    {
+        // 最後一次取樣會清除計時器本身，先複製一份參考讓 Run 活過這次呼叫
+        const TSharedRef<LoadTest::FRun> KeepAlive = Run;
+        LoadTest::Sample(KeepAlive);
+    }), IntervalSeconds, true);
+
+    // 記錄途中世界被拆除 (切換地圖、停止 PIE) 時計時器會一起消失：寫出已取樣的部分並結束記錄
+    Run->WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda([Run](UWorld* CleanedWorld, bool bSessionEnded, bool bCleanupResources)
+    {
+        if (CleanedWorld == Run->World.Get())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("LoadTest Record: the world was torn down before the run ended; writing the samples recorded so far."));
+            const TSharedRef<LoadTest::FRun> KeepAlive = Run;
+            LoadTest::Finish(KeepAlive);
+        }
+    });
+
+    LoadTest::ActiveRun = Run;
+    UE_LOG(LogTemp, Log, TEXT("LoadTest Record: recording %.0f seconds every %.1f seconds to %s"), DurationSeconds, IntervalSeconds, *Run->FilePath);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GLoadTestRecordCommand(
+    TEXT("CharacterSample.LoadTest.Record"),
+    TEXT("將伺服器的幀時間、流量與命中查詢數定期寫入 CSV。參數：[秒數] [取樣間隔] [名稱] [quit]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RecordLoadTest));
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Core/CharacterBase.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "EngineUtils.h" // TActorIterator
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+
+// ====================================================================
+// >>> 控制台指令：每個角色每秒的複製流量 <<<
+// 用法 (在伺服器或 Listen Server 上執行)：CharacterSample.Net.BytesPerCharacter [取樣秒數，預設 10]
+// 量測伺服器 NetDriver 在取樣期間送出的總位元組，除以角色數與客戶端連線數。
+// 數字包含移動複製與封包標頭，屬性層級的細分請搭配 Network Insights (-NetTrace=1 -trace=net)。
+// ====================================================================
+static void MeasureBytesPerCharacter(const TArray<FString>& Args, UWorld* World)
+{
+    UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+    if (!NetDriver || !NetDriver->IsServer())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Net BytesPerCharacter: must be run on a server or listen server world."));
+        return;
+    }
+
+    const float SampleSeconds = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 1.0f) : 10.0f;
+    const uint64 StartBytes = NetDriver->OutTotalBytes;
+    const double StartTime = FPlatformTime::Seconds();
+
+    UE_LOG(LogTemp, Log, TEXT("Net BytesPerCharacter: sampling for %.1f seconds..."), SampleSeconds);
+
+    TWeakObjectPtr<UWorld> WeakWorld(World);
+    FTimerHandle TimerHandle;
+    World->GetTimerManager().SetTimer(TimerHandle, FTimerDelegate::CreateLambda([WeakWorld, StartBytes, StartTime]()
+    {
+        UWorld* SampledWorld = WeakWorld.Get();
+        UNetDriver* SampledDriver = SampledWorld ? SampledWorld->GetNetDriver() : nullptr;
+        if (!SampledDriver)
+        {
+            return;
+        }
+
+        const double Seconds = FPlatformTime::Seconds() - StartTime;
+        const uint64 SentBytes = static_cast<uint64>(SampledDriver->OutTotalBytes) - StartBytes;
+
+        int32 NumCharacters = 0;
+        for (TActorIterator<ACharacterBase> It(SampledWorld); It; ++It)
+        {
+            ++NumCharacters;
+        }
+        const int32 NumClients = SampledDriver->ClientConnections.Num();
+
+        const double BytesPerSecond = Seconds > 0.0 ? SentBytes / Seconds : 0.0;
+        const double BytesPerCharacterPerClient = (NumCharacters > 0 && NumClients > 0) ? BytesPerSecond / (NumCharacters * NumClients) : 0.0;
+
+        UE_LOG(LogTemp, Log, TEXT("Net BytesPerCharacter [%d characters, %d clients, %.1f s]: %.1f bytes/s total | %.1f bytes/s per client | %.2f bytes/s per character per client"),
+            NumCharacters, NumClients, Seconds,
+            BytesPerSecond,
+            NumClients > 0 ? BytesPerSecond / NumClients : 0.0,
+            BytesPerCharacterPerClient);
+    }), SampleSeconds, false);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GNetBytesPerCharacterCommand(
+    TEXT("CharacterSample.Net.BytesPerCharacter"),
+    TEXT("量測伺服器在一段時間內送出的流量，換算成每個角色每個客戶端每秒的位元組。參數：[取樣秒數]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&MeasureBytesPerCharacter));
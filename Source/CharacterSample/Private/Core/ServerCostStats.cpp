@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Core/WorldTickSampler.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "HAL/PlatformMemory.h"
+#include "UObject/UObjectArray.h" // GUObjectArray，用於統計物件數量
+
+namespace ServerCost
+{
+    static int32 GetNumUObjects()
+    {
+        return GUObjectArray.GetObjectArrayNumMinusAvailable();
+    }
+}
+
+// ====================================================================
+// >>> 控制台指令：每個角色的伺服器 Tick 成本與記憶體 <<<
+// 用法 (在專用伺服器或 Listen Server 上執行)：CharacterSample.Server.CharacterCost [角色數量，預設 200] [每階段取樣秒數，預設 5]
+// 先取樣目前世界的 Tick 時間作為基準，再生成 GameMode 的 DefaultPawnClass (完整的網格、動畫與戰鬥組件，保持 Tick)，
+// 以兩次取樣的差除以角色數得到每個角色的 Tick 成本；記憶體為生成前後的實體記憶體與 UObject 數量差。
+// 在伺服器目標與編輯器 -game 各跑一次即可比較被剔除的 UI 與表演路徑。
+// ====================================================================
+static void MeasureServerCharacterCost(const TArray<FString>& Args, UWorld* World)
+{
+    const AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+    if (!GameMode || !GameMode->DefaultPawnClass)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Server CharacterCost: must be run on a server world whose game mode has a DefaultPawnClass."));
+        return;
+    }
+
+    const int32 NumCharacters = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 200;
+    const float SampleSeconds = Args.Num() > 1 ? FMath::Max(FCString::Atof(*Args[1]), 1.0f) : 5.0f;
+    const TSubclassOf<APawn> PawnClass = GameMode->DefaultPawnClass;
+
+    TSharedRef<FWorldTickSampler> Sampler = MakeShared<FWorldTickSampler>(World);
+    Sampler->Start();
+
+    UE_LOG(LogTemp, Log, TEXT("Server CharacterCost: sampling baseline for %.1f seconds..."), SampleSeconds);
+
+    TWeakObjectPtr<UWorld> WeakWorld(World);
+    FTimerHandle BaselineTimerHandle;
+    World->GetTimerManager().SetTimer(BaselineTimerHandle, FTimerDelegate::CreateLambda([WeakWorld, Sampler, PawnClass, NumCharacters, SampleSeconds]()
+    {
+        UWorld* SampledWorld = WeakWorld.Get();
+        if (!SampledWorld)
+        {
+            Sampler->Stop();
+            return;
+        }
+
+        const double BaselineMs = Sampler->Consume().AverageMs;
+
+        const uint64 UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+        const int32 NumObjectsBefore = ServerCost::GetNumUObjects();
+
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumCharacters)));
+        constexpr float Spacing = 300.0f;
+
+        // 以第一個玩家 (或世界原點) 為中心排成方陣，讓角色站在地面上以步行而非下落的狀態 Tick
+        FVector Center = FVector::ZeroVector;
+        if (const APlayerController* PlayerController = SampledWorld->GetFirstPlayerController())
+        {
+            if (const APawn* PlayerPawn = PlayerController->GetPawn())
+            {
+                Center = PlayerPawn->GetActorLocation();
+            }
+        }
+        const FVector Origin = Center - FVector(GridSize * Spacing * 0.5f, GridSize * Spacing * 0.5f, 0.0f);
+
+        TArray<TWeakObjectPtr<APawn>> Spawned;
+        Spawned.Reserve(NumCharacters);
+        for (int32 Index = 0; Index < NumCharacters; ++Index)
+        {
+            const FVector Location = Origin + FVector((Index % GridSize) * Spacing, (Index / GridSize) * Spacing, 0.0f);
+            if (APawn* Pawn = SampledWorld->SpawnActor<APawn>(PawnClass, Location, FRotator::ZeroRotator, SpawnParams))
+            {
+                Spawned.Add(Pawn);
+            }
+        }
+
+        const int64 MemoryDelta = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(UsedPhysicalBefore);
+        const int32 ObjectDelta = ServerCost::GetNumUObjects() - NumObjectsBefore;
+
+        UE_LOG(LogTemp, Log, TEXT("Server CharacterCost: spawned %d %s, sampling for %.1f seconds..."), Spawned.Num(), *PawnClass->GetName(), SampleSeconds);
+
+        FTimerHandle CrowdTimerHandle;
+        SampledWorld->GetTimerManager().SetTimer(CrowdTimerHandle, FTimerDelegate::CreateLambda([Sampler, Spawned, BaselineMs, MemoryDelta, ObjectDelta]()
+        {
+            const double CrowdMs = Sampler->Consume().AverageMs;
+            Sampler->Stop();
+
+            const int32 NumSpawned = Spawned.Num();
+            for (const TWeakObjectPtr<APawn>& Pawn : Spawned)
+            {
+                if (Pawn.IsValid())
+                {
+                    Pawn->Destroy();
+                }
+            }
+
+            if (NumSpawned == 0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Server CharacterCost: no characters were spawned."));
+                return;
+            }
+
+            UE_LOG(LogTemp, Log, TEXT("Server CharacterCost [%d characters, %s]: world tick %.3f ms -> %.3f ms | %.2f us/character/frame | %.1f KB/character | %.1f UObjects/character"),
+                NumSpawned, IsRunningDedicatedServer() ? TEXT("dedicated server") : TEXT("non-dedicated"),
+                BaselineMs, CrowdMs,
+                (CrowdMs - BaselineMs) * 1000.0 / NumSpawned,
+                static_cast<double>(MemoryDelta) / 1024.0 / NumSpawned,
+                static_cast<double>(ObjectDelta) / NumSpawned);
+        }), SampleSeconds, false);
+    }), SampleSeconds, false);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GServerCharacterCostCommand(
+    TEXT("CharacterSample.Server.CharacterCost"),
+    TEXT("量測每個角色在伺服器上的世界 Tick 成本與記憶體。參數：[角色數量] [每階段取樣秒數]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&MeasureServerCharacterCost));
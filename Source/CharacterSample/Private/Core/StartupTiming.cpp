@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Core/StartupTiming.h"
+#include "CoreGlobals.h" // GStartTime
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/CoreDelegates.h" // OnEndFrame
+#include "UObject/UObjectGlobals.h" // PreLoadMap / PostLoadMapWithWorld
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+
+namespace StartupTiming
+{
+    // 自行程開始的秒數；< 0 表示尚未記錄
+    struct FStageTimes
+    {
+        double Begin = -1.0;
+        double End = -1.0;
+    };
+
+    static FStageTimes Stages[static_cast<int32>(EStage::Count)];
+    static double ClassLoadWaitMs = 0.0;
+
+    static FDelegateHandle PreLoadMapHandle;
+    static FDelegateHandle PostLoadMapHandle;
+    static FDelegateHandle EndFrameHandle;
+
+    static const TCHAR* StageNames[] = { TEXT("module startup"), TEXT("map load"), TEXT("class load"), TEXT("first possessed frame") };
+    static_assert(UE_ARRAY_COUNT(StageNames) == static_cast<int32>(EStage::Count), "StageNames must match EStage.");
+
+    static double SecondsSinceProcessStart()
+    {
+        return FPlatformTime::Seconds() - GStartTime;
+    }
+
+    static bool HasLocallyPossessedPawn()
+    {
+        for (const FWorldContext& Context : GEngine->GetWorldContexts())
+        {
+            const UWorld* World = Context.World();
+            if (!World || (Context.WorldType != EWorldType::Game && Context.WorldType != EWorldType::PIE))
+            {
+                continue;
+            }
+            const APlayerController* PlayerController = World->GetFirstPlayerController();
+            if (PlayerController && PlayerController->IsLocalController() && PlayerController->GetPawn())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 每幀結束時檢查一次，第一次有本地玩家擁有 Pawn 時記錄並停止監聽
+    static void OnEndFrame()
+    {
+        if (!GEngine || !HasLocallyPossessedPawn())
+        {
+            return;
+        }
+
+        BeginStage(EStage::FirstPossessedFrame);
+        EndStage(EStage::FirstPossessedFrame);
+        FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+        EndFrameHandle.Reset();
+
+        Report();
+
+        if (FParse::Param(FCommandLine::Get(), TEXT("CharacterSampleStartupBenchmark")))
+        {
+            FPlatformMisc::RequestExit(false, TEXT("StartupBenchmark"));
+        }
+    }
+
+    void Initialize()
+    {
+        // 模組階段從行程開始算起，涵蓋遊戲模組載入之前的引擎初始化
+        Stages[static_cast<int32>(EStage::ModuleStartup)].Begin = 0.0;
+        EndStage(EStage::ModuleStartup);
+
+        if (IsRunningCommandlet())
+        {
+            return;
+        }
+
+        PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddLambda([](const FString&)
+        {
+            BeginStage(EStage::MapLoad);
+        });
+        PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddLambda([](UWorld*)
+        {
+            EndStage(EStage::MapLoad);
+        });
+        EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&OnEndFrame);
+    }
+
+    void Shutdown()
+    {
+        FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+        FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+        FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+    }
+
+    void BeginStage(EStage Stage)
+    {
+        FStageTimes& Times = Stages[static_cast<int32>(Stage)];
+        if (Times.Begin < 0.0)
+        {
+            Times.Begin = SecondsSinceProcessStart();
+        }
+    }
+
+    void EndStage(EStage Stage)
+    {
+        FStageTimes& Times = Stages[static_cast<int32>(Stage)];
+        if (Times.End < 0.0)
+        {
+            Times.End = SecondsSinceProcessStart();
+            // 沒有明確開始點的階段 (例如第一個被擁有的幀) 視為瞬間
+            if (Times.Begin < 0.0)
+            {
+                Times.Begin = Times.End;
+            }
+        }
+    }
+
+    void AddClassLoadWaitMs(double WaitMs)
+    {
+        ClassLoadWaitMs += WaitMs;
+    }
+
+    void Report()
+    {
+        UE_LOG(LogTemp, Log, TEXT("Startup timing (ms since process start):"));
+
+        FString CsvRow;
+        for (int32 Index = 0; Index < static_cast<int32>(EStage::Count); ++Index)
+        {
+            const FStageTimes& Times = Stages[Index];
+            if (Times.End < 0.0)
+            {
+                UE_LOG(LogTemp, Log, TEXT("  %-22s not recorded"), StageNames[Index]);
+                CsvRow += TEXT(",,");
+                continue;
+            }
+            UE_LOG(LogTemp, Log, TEXT("  %-22s %9.1f -> %9.1f (%.1f ms)"), StageNames[Index], Times.Begin * 1000.0, Times.End * 1000.0, (Times.End - Times.Begin) * 1000.0);
+            CsvRow += FString::Printf(TEXT("%.1f,%.1f,"), Times.End * 1000.0, (Times.End - Times.Begin) * 1000.0);
+        }
+        UE_LOG(LogTemp, Log, TEXT("  class load wait at first login %.1f ms"), ClassLoadWaitMs);
+
+        // 供腳本收集：每個階段的結束時間與耗時，最後是登入時的等待
+        UE_LOG(LogTemp, Log, TEXT("StartupTiming CSV: ModuleEnd,ModuleMs,MapLoadEnd,MapLoadMs,ClassLoadEnd,ClassLoadMs,FirstPossessedFrameEnd,FirstPossessedFrameMs,ClassLoadWaitMs"));
+        UE_LOG(LogTemp, Log, TEXT("StartupTiming CSV: %s%.1f"), *CsvRow, ClassLoadWaitMs);
+    }
+}
+
+static FAutoConsoleCommand GStartupReportCommand(
+    TEXT("CharacterSample.Startup.Report"),
+    TEXT("輸出冷啟動各階段 (模組、地圖、類別載入、第一個被擁有的幀) 的時間。"),
+    FConsoleCommandDelegate::CreateStatic(&StartupTiming::Report));
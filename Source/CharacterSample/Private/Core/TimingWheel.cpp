@@ -0,0 +1,214 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/TimingWheel.h"
+
+FTimingWheel::FTimingWheel()
+{
+    for (int32& Head : SlotHeads)
+    {
+        Head = INDEX_NONE;
+    }
+}
+
+FTimingWheelHandle FTimingWheel::Arm(uint64 ExpireTick, FSimpleDelegate&& Callback)
+{
+    const int32 NodeIndex = FreeNodes.Num() > 0 ? FreeNodes.Pop(EAllowShrinking::No) : Nodes.AddDefaulted();
+
+    FNode& Node = Nodes[NodeIndex];
+    Node.Callback = MoveTemp(Callback);
+    Node.ExpireTick = ExpireTick;
+    Link(NodeIndex);
+    ++NumArmed;
+
+    FTimingWheelHandle Handle;
+    Handle.Index = NodeIndex;
+    Handle.Generation = Node.Generation;
+    return Handle;
+}
+
+bool FTimingWheel::Cancel(FTimingWheelHandle& Handle)
+{
+    const bool bWasArmed = IsArmed(Handle);
+    if (bWasArmed)
+    {
+        if (Nodes[Handle.Index].Slot != ExpiredSlot)
+        {
+            Unlink(Handle.Index);
+        }
+        Free(Handle.Index);
+    }
+
+    Handle.Invalidate();
+    return bWasArmed;
+}
+
+bool FTimingWheel::IsArmed(const FTimingWheelHandle& Handle) const
+{
+    return Nodes.IsValidIndex(Handle.Index)
+        && Nodes[Handle.Index].Generation == Handle.Generation
+        && Nodes[Handle.Index].Slot != INDEX_NONE;
+}
+
+// ====================================================================
+// >>> 推進時間輪 <<<
+// 每個刻度處理第 0 層的一個槽位；第 0 層轉完一圈 (槽位索引回到 0) 時，
+// 先把上一層目前槽位的節點往下分配，若上一層也剛好轉完一圈則繼續往上。
+// 到期的節點不在這裡釋放：同一批中較早執行的回調可能取消較晚的計時器，
+// 因此節點保留到 TakeExpired，屆時再以句柄的世代確認它仍未被取消。
+// ====================================================================
+void FTimingWheel::Advance(uint64 TargetTick, TArray<FTimingWheelHandle>& OutExpired)
+{
+    while (NextTick <= TargetTick)
+    {
+        // 沒有任何計時器時直接跳到目標刻度
+        if (NumArmed == 0)
+        {
+            NextTick = TargetTick + 1;
+            break;
+        }
+
+        const uint64 SlotIndex = NextTick & SlotMask;
+        if (SlotIndex == 0)
+        {
+            for (int32 Level = 1; Level < NumLevels; ++Level)
+            {
+                Cascade(Level);
+                if (((NextTick >> (SlotBits * Level)) & SlotMask) != 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        // 取下整個槽位的串列，標記為已到期並收集句柄
+        int32 NodeIndex = SlotHeads[SlotIndex];
+        SlotHeads[SlotIndex] = INDEX_NONE;
+        while (NodeIndex != INDEX_NONE)
+        {
+            FNode& Node = Nodes[NodeIndex];
+            const int32 NextNodeIndex = Node.Next;
+            Node.Slot = ExpiredSlot;
+            Node.Prev = INDEX_NONE;
+            Node.Next = INDEX_NONE;
+
+            FTimingWheelHandle& Handle = OutExpired.AddDefaulted_GetRef();
+            Handle.Index = NodeIndex;
+            Handle.Generation = Node.Generation;
+            NodeIndex = NextNodeIndex;
+        }
+
+        ++NextTick;
+    }
+}
+
+bool FTimingWheel::TakeExpired(const FTimingWheelHandle& Handle, FSimpleDelegate& OutCallback)
+{
+    if (!IsArmed(Handle) || Nodes[Handle.Index].Slot != ExpiredSlot)
+    {
+        return false;
+    }
+
+    OutCallback = MoveTemp(Nodes[Handle.Index].Callback);
+    Free(Handle.Index);
+    return true;
+}
+
+void FTimingWheel::ResetTick(uint64 Tick)
+{
+    check(NumArmed == 0);
+    NextTick = Tick;
+}
+
+void FTimingWheel::Reset()
+{
+    Nodes.Reset();
+    FreeNodes.Reset();
+    for (int32& Head : SlotHeads)
+    {
+        Head = INDEX_NONE;
+    }
+    NumArmed = 0;
+}
+
+void FTimingWheel::Link(int32 NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+
+    // 已經過期的計時器放進目前的槽位，下一次 Advance 立即到期；過遠的期限則截斷
+    if (Node.ExpireTick < NextTick)
+    {
+        Node.ExpireTick = NextTick;
+    }
+    else if (Node.ExpireTick - NextTick > MaxDelayTicks)
+    {
+        Node.ExpireTick = NextTick + MaxDelayTicks;
+    }
+
+    const uint64 Delta = Node.ExpireTick - NextTick;
+    int32 Level = 0;
+    while (Level < NumLevels - 1 && Delta >= (uint64(1) << (SlotBits * (Level + 1))))
+    {
+        ++Level;
+    }
+
+    const int32 Slot = Level * SlotsPerLevel + static_cast<int32>((Node.ExpireTick >> (SlotBits * Level)) & SlotMask);
+
+    Node.Slot = Slot;
+    Node.Prev = INDEX_NONE;
+    Node.Next = SlotHeads[Slot];
+    if (Node.Next != INDEX_NONE)
+    {
+        Nodes[Node.Next].Prev = NodeIndex;
+    }
+    SlotHeads[Slot] = NodeIndex;
+}
+
+void FTimingWheel::Unlink(int32 NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+
+    if (Node.Prev != INDEX_NONE)
+    {
+        Nodes[Node.Prev].Next = Node.Next;
+    }
+    else
+    {
+        SlotHeads[Node.Slot] = Node.Next;
+    }
+
+    if (Node.Next != INDEX_NONE)
+    {
+        Nodes[Node.Next].Prev = Node.Prev;
+    }
+
+    Node.Prev = INDEX_NONE;
+    Node.Next = INDEX_NONE;
+}
+
+void FTimingWheel::Free(int32 NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+    Node.Callback.Unbind();
+    Node.Slot = INDEX_NONE;
+    Node.Prev = INDEX_NONE;
+    Node.Next = INDEX_NONE;
+    ++Node.Generation;
+
+    FreeNodes.Add(NodeIndex);
+    --NumArmed;
+}
+
+void FTimingWheel::Cascade(int32 Level)
+{
+    const int32 Slot = Level * SlotsPerLevel + static_cast<int32>((NextTick >> (SlotBits * Level)) & SlotMask);
+
+    int32 NodeIndex = SlotHeads[Slot];
+    SlotHeads[Slot] = INDEX_NONE;
+    while (NodeIndex != INDEX_NONE)
+    {
+        const int32 NextNodeIndex = Nodes[NodeIndex].Next;
+        Link(NodeIndex); // 依新的目前刻度重新選擇層級
+        NodeIndex = NextNodeIndex;
+    }
+}
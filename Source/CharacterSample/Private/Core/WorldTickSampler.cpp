@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Core/WorldTickSampler.h"
+#include "Engine/World.h"
+
+FWorldTickSampler::FWorldTickSampler(UWorld* InWorld)
+    : World(InWorld)
+{
+}
+
+void FWorldTickSampler::Start()
+{
+    TickStartHandle = FWorldDelegates::OnWorldTickStart.AddSP(this, &FWorldTickSampler::HandleTickStart);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddSP(this, &FWorldTickSampler::HandlePostActorTick);
+    SampleStartTime = FPlatformTime::Seconds();
+}
+
+void FWorldTickSampler::Stop()
+{
+    FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    TickStartHandle.Reset();
+    PostActorTickHandle.Reset();
+}
+
+FWorldTickSampler::FSample FWorldTickSampler::Consume()
+{
+    const double Now = FPlatformTime::Seconds();
+
+    FSample Sample;
+    Sample.NumFrames = NumFrames;
+    if (NumFrames > 0)
+    {
+        Sample.AverageMs = TotalSeconds * 1000.0 / NumFrames;
+        Sample.MaxMs = MaxSeconds * 1000.0;
+        Sample.FrameIntervalMs = (Now - SampleStartTime) * 1000.0 / NumFrames;
+    }
+
+    TotalSeconds = 0.0;
+    MaxSeconds = 0.0;
+    NumFrames = 0;
+    SampleStartTime = Now;
+    return Sample;
+}
+
+void FWorldTickSampler::HandleTickStart(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (TickedWorld == World.Get())
+    {
+        TickStartTime = FPlatformTime::Seconds();
+    }
+}
+
+void FWorldTickSampler::HandlePostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (TickedWorld == World.Get() && TickStartTime > 0.0)
+    {
+        const double Seconds = FPlatformTime::Seconds() - TickStartTime;
+        TotalSeconds += Seconds;
+        MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+        ++NumFrames;
+    }
+}
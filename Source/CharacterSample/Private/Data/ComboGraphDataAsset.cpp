@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/ComboGraphDataAsset.h"
+#include "Animation/AnimMontage.h" // 編譯時讀取蒙太奇長度
+
+// ====================================================================
+// >>> FCompiledComboGraph 實作 <<<
+// ====================================================================
+
+static float GetMontageDuration(UAnimMontage* Montage, float PlayRate)
+{
+    if (!Montage)
+    {
+        return 0.0f;
+    }
+
+    // 確保蒙太奇的長度資料已經就緒 (資產載入順序不保證)
+    Montage->ConditionalPostLoad();
+    return Montage->GetPlayLength() / FMath::Max(PlayRate, UE_KINDA_SMALL_NUMBER);
+}
+
+// 從蒙太奇的具名 Notify 取出時間軸事件；名稱與 ABP_PlayerCharacter 中的 AnimNotify_* 事件一致
+static void ExtractTimeline(UAnimMontage* Montage, float PlayRate, TArray<FComboTimelineEntry>& OutTimeline)
+{
+    OutTimeline.Reset();
+    if (!Montage)
+    {
+        return;
+    }
+
+    static const FName HitCheckName(TEXT("HitCheck"));
+    static const FName NextComboName(TEXT("NextCombo"));
+    static const FName SaveAttackName(TEXT("SaveAttack"));
+    static const FName HitWindowName(TEXT("HitWindow"));
+
+    const float InvPlayRate = 1.0f / FMath::Max(PlayRate, UE_KINDA_SMALL_NUMBER);
+    for (const FAnimNotifyEvent& Notify : Montage->Notifies)
+    {
+        const float StartTime = Notify.GetTriggerTime() * InvPlayRate;
+
+        if (Notify.NotifyName == HitCheckName)
+        {
+            OutTimeline.Add({ StartTime, EComboTimelineEvent::HitCheck });
+        }
+        else if (Notify.NotifyName == NextComboName)
+        {
+            OutTimeline.Add({ StartTime, EComboTimelineEvent::OpenComboWindow });
+        }
+        else if (Notify.NotifyName == SaveAttackName)
+        {
+            OutTimeline.Add({ StartTime, EComboTimelineEvent::ConsumeBufferedInput });
+        }
+        else if (Notify.NotifyName == HitWindowName)
+        {
+            OutTimeline.Add({ StartTime, EComboTimelineEvent::BeginHitWindow });
+            OutTimeline.Add({ Notify.GetEndTriggerTime() * InvPlayRate, EComboTimelineEvent::EndHitWindow });
+        }
+    }
+
+    OutTimeline.StableSort([](const FComboTimelineEntry& A, const FComboTimelineEntry& B) { return A.Time < B.Time; });
+}
+
+void FCompiledComboGraph::Compile(const TArray<FComboSegmentDefinition>& SegmentDefinitions, const TArray<FComboTransition>& EntryTransitions, float ComboResetGrace, const UObject* Owner)
+{
+    Segments.Reset(SegmentDefinitions.Num());
+    TransitionTable.Reset();
+
+    // 段名稱 -> 索引
+    TMap<FName, int32> SegmentIndices;
+    for (int32 Index = 0; Index < SegmentDefinitions.Num(); ++Index)
+    {
+        const FComboSegmentDefinition& Definition = SegmentDefinitions[Index];
+        if (SegmentIndices.Contains(Definition.SegmentName))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ComboGraph %s: duplicate segment name '%s', later one is unreachable by name."), *GetNameSafe(Owner), *Definition.SegmentName.ToString());
+        }
+        else
+        {
+            SegmentIndices.Add(Definition.SegmentName, Index);
+        }
+
+        FCompiledComboSegment& Segment = Segments.AddDefaulted_GetRef();
+        Segment.Montage = Definition.Montage;
+        Segment.PlayRate = Definition.PlayRate;
+        Segment.Duration = GetMontageDuration(Definition.Montage, Definition.PlayRate);
+        Segment.CancelWindowStart = Definition.CancelWindowStart;
+        Segment.CancelWindowEnd = Definition.CancelWindowEnd >= 0.0f ? Definition.CancelWindowEnd : Segment.Duration;
+        Segment.RecoveryEnd = Segment.Duration + ComboResetGrace;
+        Segment.Damage = Definition.Damage;
+        Segment.HitRadius = Definition.HitShape.Radius;
+        Segment.HitReach = Definition.HitShape.Reach;
+        ExtractTimeline(Definition.Montage, Definition.PlayRate, Segment.Timeline);
+
+        if (!Definition.Montage)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ComboGraph %s: segment '%s' has no montage."), *GetNameSafe(Owner), *Definition.SegmentName.ToString());
+        }
+    }
+
+    // 轉移表：(段數 + 1) x 輸入數，預設皆無轉移
+    TransitionTable.Init(static_cast<int16>(INDEX_NONE), (Segments.Num() + 1) * NumInputs);
+
+    auto WriteRow = [&](int32 Row, const TArray<FComboTransition>& Transitions, const FName& SourceName)
+    {
+        for (const FComboTransition& Transition : Transitions)
+        {
+            if (const int32* TargetIndex = SegmentIndices.Find(Transition.TargetSegment))
+            {
+                TransitionTable[Row * NumInputs + static_cast<int32>(Transition.Input)] = static_cast<int16>(*TargetIndex);
+            }
+            else
+            {
+                UE_LOG(LogTemp, Warning, TEXT("ComboGraph %s: transition from '%s' targets unknown segment '%s'."), *GetNameSafe(Owner), *SourceName.ToString(), *Transition.TargetSegment.ToString());
+            }
+        }
+    };
+
+    WriteRow(0, EntryTransitions, TEXT("Idle"));
+    for (int32 Index = 0; Index < SegmentDefinitions.Num(); ++Index)
+    {
+        WriteRow(Index + 1, SegmentDefinitions[Index].Transitions, SegmentDefinitions[Index].SegmentName);
+    }
+}
+
+void FCompiledComboGraph::CompileLinear(const TArray<UAnimMontage*>& Montages, float ComboResetGrace)
+{
+    // 與舊版行為相同：依序播放、由 Anim Notify 開啟連擊窗口、固定傷害與命中形狀
+    const FComboSegmentDefinition Defaults;
+
+    Segments.Reset(Montages.Num());
+    for (UAnimMontage* Montage : Montages)
+    {
+        FCompiledComboSegment& Segment = Segments.AddDefaulted_GetRef();
+        Segment.Montage = Montage;
+        Segment.PlayRate = 1.0f;
+        Segment.Duration = GetMontageDuration(Montage, 1.0f);
+        Segment.CancelWindowStart = -1.0f;
+        Segment.CancelWindowEnd = Segment.Duration;
+        Segment.RecoveryEnd = Segment.Duration + ComboResetGrace;
+        Segment.Damage = Defaults.Damage;
+        Segment.HitRadius = Defaults.HitShape.Radius;
+        Segment.HitReach = Defaults.HitShape.Reach;
+        ExtractTimeline(Montage, 1.0f, Segment.Timeline);
+    }
+
+    TransitionTable.Init(static_cast<int16>(INDEX_NONE), (Segments.Num() + 1) * NumInputs);
+    for (int32 Row = 0; Row < Segments.Num(); ++Row)
+    {
+        // 第 Row 列 (待機或第 Row - 1 段) 按 Light 進入第 Row 段
+        TransitionTable[Row * NumInputs + static_cast<int32>(EComboInput::Light)] = static_cast<int16>(Row);
+    }
+}
+
+// ====================================================================
+// >>> UComboGraphDataAsset 實作 <<<
+// ====================================================================
+
+void UComboGraphDataAsset::Compile()
+{
+    CompiledGraph.Compile(Segments, EntryTransitions, ComboResetGrace, this);
+}
+
+void UComboGraphDataAsset::PostLoad()
+{
+    Super::PostLoad();
+    Compile();
+}
+
+#if WITH_EDITOR
+void UComboGraphDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    Compile();
+}
+#endif
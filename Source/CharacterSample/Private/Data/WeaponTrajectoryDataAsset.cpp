@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Data/WeaponTrajectoryDataAsset.h"
+
+static constexpr float MaxQuantizedValue = static_cast<float>(TNumericLimits<uint16>::Max());
+
+void FBakedWeaponTrajectory::Encode(const TArray<FVector>& Positions, float InSampleRate)
+{
+    SampleRate = InSampleRate;
+    QuantizedSamples.Reset();
+    if (Positions.Num() == 0)
+    {
+        QuantizationMin = FVector::ZeroVector;
+        QuantizationExtent = FVector::ZeroVector;
+        return;
+    }
+
+    const FBox Bounds(Positions);
+    QuantizationMin = Bounds.Min;
+    QuantizationExtent = Bounds.Max - Bounds.Min;
+
+    QuantizedSamples.Reserve(Positions.Num() * 3);
+    for (const FVector& Position : Positions)
+    {
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            const double Extent = QuantizationExtent[Axis];
+            const double Normalized = Extent > UE_SMALL_NUMBER ? (Position[Axis] - QuantizationMin[Axis]) / Extent : 0.0;
+            QuantizedSamples.Add(static_cast<uint16>(FMath::RoundToInt32(FMath::Clamp(Normalized, 0.0, 1.0) * MaxQuantizedValue)));
+        }
+    }
+}
+
+FVector FBakedWeaponTrajectory::DecodeSample(int32 SampleIndex) const
+{
+    const uint16* Sample = &QuantizedSamples[SampleIndex * 3];
+    return QuantizationMin + QuantizationExtent * FVector(Sample[0], Sample[1], Sample[2]) / MaxQuantizedValue;
+}
+
+FVector FBakedWeaponTrajectory::Evaluate(float MontageTime) const
+{
+    const int32 Count = NumSamples();
+    if (Count == 0)
+    {
+        return FVector::ZeroVector;
+    }
+
+    const float SamplePosition = FMath::Clamp(MontageTime * SampleRate, 0.0f, static_cast<float>(Count - 1));
+    const int32 Index = FMath::Min(FMath::FloorToInt32(SamplePosition), Count - 1);
+    const int32 NextIndex = FMath::Min(Index + 1, Count - 1);
+    return FMath::Lerp(DecodeSample(Index), DecodeSample(NextIndex), SamplePosition - Index);
+}
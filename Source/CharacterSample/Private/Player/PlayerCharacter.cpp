@@ -4,6 +4,7 @@
 #include "GameFramework/CharacterMovementComponent.h" // 用於控制角色移動
 #include "Components/CapsuleComponent.h" // 用於角色的碰撞體
 #include "Components/SkeletalMeshComponent.h" // 用於角色的網格模型
+#include "Animation/AnimInstance.h" // 角色池重用時停止蒙太奇
 #include "Kismet/KismetSystemLibrary.h" // 用於藍圖輔助函數，如 Sweep Trace
 #include "Engine/DamageEvents.h" // 用於處理傷害事件
 #include "Blueprint/UserWidget.h" // 用於 UI Widget 的創建
@@ -13,7 +14,11 @@
 #include "Components/CombatComponent.h" // 包含 CombatComponent 的頭檔
 #include "Components/CharacterInputManagerComponent.h" // 包含角色輸入管理組件的頭檔
 #include "Components/EntranceAnimationComponent.h" // 包含入場動畫組件的頭檔
+#include "Subsystems/CharacterAnimVariablesSubsystem.h" // 批次更新動畫變數
 #include "Engine/Engine.h" // 用於 GEngine->AddOnScreenDebugMessage
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Player Anim Variables"), STAT_PlayerAnimVariables, STATGROUP_CharacterSample);
 
 // ====================================================================
 // >>> 構造函數：APlayerCharacter::APlayerCharacter() <<<
@@ -21,10 +26,12 @@
 // ====================================================================
 APlayerCharacter::APlayerCharacter()
 {
-    // 啟用 Tick 函式：設定此角色每幀都會呼叫 Tick() 函式，用於持續更新邏輯。
-    // 如果不需要每幀更新，可以將其關閉以優化效能。
+    // 啟用 Tick 函式：動畫變數通常由 UCharacterAnimVariablesSubsystem 批次更新，
+    // BeginPlay 登錄成功後會關閉 Actor Tick；Tick 只作為沒有子系統時的備用路徑。
     PrimaryActorTick.bCanEverTick = true; 
 
+    AnimVariablesSubsystem = nullptr;
+
     // ====================================================================
     // >>> 角色移動設定，實現「無雙類」轉向 <<<
     // 透過禁用控制器對角色本體的旋轉控制，並啟用角色面向移動方向，來達到流暢轉向。
@@ -56,7 +63,7 @@ APlayerCharacter::APlayerCharacter()
     // --- 在這裡創建和初始化 CombatComponent ---
     CombatComponent = CreateDefaultSubobject<UCombatComponent>(TEXT("CombatComponent"));
     // 可以為組件設定一些預設值，但通常它的配置會在藍圖中進行，或者在 CombatComponent 自己的構造函數中。
-    // CombatComponent->SetIsReplicated(true); // 如果需要網路複製，可以在這裡設置
+    // 連擊狀態的網路複製在 CombatComponent 的構造函數中啟用 (SetIsReplicatedByDefault)
 
     // --- 在這裡創建和初始化 CharacterInputManagerComponent ---
     // 將其創建為子對象，以便可以在藍圖中訪問和配置其輸入屬性。
@@ -99,6 +106,29 @@ void APlayerCharacter::BeginPlay()
 {
     Super::BeginPlay(); // 呼叫父類 (ACharacter) 的 BeginPlay 函式
 
+    // ====================================================================
+    // >>> 專用伺服器：只保留影響遊戲邏輯的動畫 <<<
+    // 伺服器只需要蒙太奇與其 Notify (連擊窗口、命中窗口)，移動用的狀態機與動畫變數都是表演。
+    // 播放蒙太奇時仍刷新骨架，讓沒有烘焙軌跡的武器插槽位置保持正確。
+    // ====================================================================
+    const bool bIsDedicatedServer = IsNetMode(NM_DedicatedServer);
+    if (bIsDedicatedServer && GetMesh())
+    {
+        GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesAndRefreshBonesWhenPlayingMontages;
+    }
+
+    // 動畫變數改由子系統批次更新；藍圖有實作 Event Tick 時保留 Actor Tick
+    AnimVariablesSubsystem = bIsDedicatedServer ? nullptr : GetWorld()->GetSubsystem<UCharacterAnimVariablesSubsystem>();
+    if (AnimVariablesSubsystem)
+    {
+        AnimVariablesHandle = AnimVariablesSubsystem->RegisterCharacter(this);
+    }
+    if ((AnimVariablesSubsystem || bIsDedicatedServer)
+        && !GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick)))
+    {
+        SetActorTickEnabled(false);
+    }
+
     // ====================================================================
     // >>> 新增或修改以下程式碼區塊 <<<
     // 確保在遊戲開始時觸發入場動畫組件的邏輯
@@ -116,6 +146,76 @@ void APlayerCharacter::BeginPlay()
     }
 }
 
+void APlayerCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (AnimVariablesSubsystem)
+    {
+        AnimVariablesSubsystem->UnregisterCharacter(AnimVariablesHandle);
+    }
+    AnimVariablesHandle = INDEX_NONE;
+
+    Super::EndPlay(EndPlayReason);
+}
+
+// ====================================================================
+// >>> 角色池 <<<
+// 組件、輸入綁定與動畫實例都保留，只重設執行期狀態
+// ====================================================================
+void APlayerCharacter::OnReleasedToPool()
+{
+    Super::OnReleasedToPool();
+
+    // 池中的角色不需要每幀計算動畫變數
+    if (AnimVariablesSubsystem)
+    {
+        AnimVariablesSubsystem->UnregisterCharacter(AnimVariablesHandle);
+    }
+    AnimVariablesHandle = INDEX_NONE;
+}
+
+void APlayerCharacter::OnAcquiredFromPool(const FTransform& SpawnTransform)
+{
+    Super::OnAcquiredFromPool(SpawnTransform);
+
+    if (AnimVariablesSubsystem && AnimVariablesHandle == INDEX_NONE)
+    {
+        AnimVariablesHandle = AnimVariablesSubsystem->RegisterCharacter(this);
+    }
+
+    // 與 BeginPlay 相同：重用的角色同樣從入場動畫開始
+    if (EntranceAnimationComponent)
+    {
+        EntranceAnimationComponent->PlayEntranceAnimation();
+    }
+    else
+    {
+        SetPlayerInputEnabled(true);
+    }
+}
+
+void APlayerCharacter::ResetPooledState()
+{
+    // 先中止入場動畫與蒙太奇，再由 ResetCombo 與基底類別恢復移動
+    if (EntranceAnimationComponent)
+    {
+        EntranceAnimationComponent->ResetEntranceAnimation();
+    }
+    if (GetMesh() && GetMesh()->GetAnimInstance())
+    {
+        GetMesh()->GetAnimInstance()->StopAllMontages(0.0f);
+    }
+    if (CombatComponent)
+    {
+        CombatComponent->ResetCombo();
+    }
+
+    Super::ResetPooledState();
+
+    CurrentSpeed = 0.0f;
+    MovementDirection = 0.0f;
+    bIsFalling = false;
+}
+
 // ====================================================================
 // >>> Tick() 函式：每幀呼叫，更新角色的動畫狀態變數 <<<
 // 這些變數通常會被用於動畫藍圖 (Anim Blueprint) 中，來控制動畫的混合與播放。
@@ -124,42 +224,20 @@ void APlayerCharacter::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime); // 呼叫父類 (ACharacter) 的 Tick 函式
 
-    // 更新角色速度、是否下落以及移動方向等動畫相關變數。
-    if (GetCharacterMovement())
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_PlayerAnimVariables);
+
+    // 已登錄到 UCharacterAnimVariablesSubsystem 時由子系統批次更新，專用伺服器則完全不需要
+    // (此時 Tick 只會因藍圖的 Event Tick 而啟用)
+    if (AnimVariablesHandle != INDEX_NONE || IsNetMode(NM_DedicatedServer))
     {
-        CurrentSpeed = GetVelocity().Size(); // 取得當前水平速度
-        bIsFalling = GetCharacterMovement()->IsFalling(); // 判斷角色是否正在下落 (跳躍或掉落)
+        return;
+    }
 
-        // 計算移動方向的角度。由於 bOrientRotationToMovement 為 true，角色總是面向移動方向，
-        // 因此 MovementDirection 在角色的局部空間中通常會接近 0 (表示向前)。
-        // 這個變數在動畫藍圖中仍然有用，例如用於混合側身移動或後退動畫。
-        if (CurrentSpeed > KINDA_SMALL_NUMBER) // 如果有明顯的移動速度 (避免浮點數精度問題)
-        {
-            FVector WorldVelocity = GetVelocity();
-            WorldVelocity.Z = 0.f; // 忽略垂直速度，只考慮水平方向的速度
-
-            if (WorldVelocity.SizeSquared() > KINDA_SMALL_NUMBER) // 確保速度向量不是零向量
-            {
-                WorldVelocity.Normalize(); // 正規化速度向量，使其長度為 1
-
-                // 取得角色的當前 Yaw 旋轉 (只考慮水平旋轉)
-                const FRotator CharacterYawRotation(0, GetActorRotation().Yaw, 0);
-                // 將世界速度向量轉換為相對於角色自身局部空間的速度向量
-                FVector LocalVelocity = CharacterYawRotation.UnrotateVector(WorldVelocity);
-
-                // 計算移動方向的角度 (使用 Atan2(Y, X) 得到弧度，再轉換為角度)。
-                // 0 度表示向前，90 度表示向右，-90 度表示向左，180 度表示向後。
-                MovementDirection = FMath::RadiansToDegrees(FMath::Atan2(LocalVelocity.Y, LocalVelocity.X));
-            }
-            else
-            {
-                MovementDirection = 0.0f; // 沒有移動，方向為 0
-            }
-        }
-        else
-        {
-            MovementDirection = 0.0f; // 沒有移動，方向為 0
-        }
+    // 備用路徑：沒有子系統的世界中逐 Actor 更新速度、是否下落以及移動方向等動畫相關變數。
+    if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+    {
+        bIsFalling = MovementComp->IsFalling(); // 判斷角色是否正在下落 (跳躍或掉落)
+        UCharacterAnimVariablesSubsystem::ComputeAnimVariables(FVector3f(GetVelocity()), static_cast<float>(GetActorRotation().Yaw), CurrentSpeed, MovementDirection);
     }
 }
 
@@ -2,15 +2,23 @@
 
 
 #include "Player/PlayerCharacterController.h"
+#if !UE_SERVER
 #include "Blueprint/UserWidget.h" // 需要這個來使用 CreateWidget
 #include "UI/HealthBarBaseWidget.h" // 需要這個來訪問 UHealthBarBaseWidget 的成員
+#include "UI/SCrowdHealthBars.h" // 群眾血條
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#endif
 #include "Player/PlayerCharacter.h" // 需要這個來 Cast 到 PlayerCharacter
+#include "Components/CharacterBotInputComponent.h" // 負載測試的機器人輸入
 #include "EnhancedInputSubsystems.h" // 如果你還要在這裡放輸入設定，就需要這個
 #include "InputMappingContext.h" // 如果你還要在這裡放輸入設定，就需要這個
 
 
 APlayerCharacterController::APlayerCharacterController()
 {
+    BotInputComponent = nullptr;
+
     // 如果你沒有特定的初始化邏輯，這裡可以留空，或者放一些預設值設定
     // 例如：
     // bShowMouseCursor = true;
@@ -22,10 +30,17 @@ void APlayerCharacterController::BeginPlay()
 {
     Super::BeginPlay();
 
-    // 僅本地玩家才創建 UI
+    // 僅本地玩家才創建 UI (專用伺服器上沒有本地玩家，伺服器目標中血條程式碼整段不編譯)
     if (IsLocalPlayerController()) // 更精確的檢查是否為本地玩家控制器
     {
         CreateAndSetupHealthBarWidget(); // 呼叫輔助函式來創建血條
+        CreateCrowdHealthBars();
+
+        // 負載測試的客戶端以機器人注入輸入
+        if (UCharacterBotInputComponent::IsBotRequestedOnCommandLine())
+        {
+            SetBotInputEnabled(true);
+        }
         
         // --- 這裡可以放置輸入系統設定 ---
         // 取得 Enhanced Input Local Player 子系統。
@@ -39,10 +54,32 @@ void APlayerCharacterController::BeginPlay()
     }
 }
 
+void APlayerCharacterController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    RemoveCrowdHealthBars();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void APlayerCharacterController::SetBotInputEnabled(bool bEnabled)
+{
+    if (bEnabled && !BotInputComponent && IsLocalPlayerController())
+    {
+        BotInputComponent = NewObject<UCharacterBotInputComponent>(this, TEXT("BotInput"));
+        BotInputComponent->RegisterComponent();
+    }
+    else if (!bEnabled && BotInputComponent)
+    {
+        BotInputComponent->DestroyComponent();
+        BotInputComponent = nullptr;
+    }
+}
+
 void APlayerCharacterController::OnPossess(APawn* InPawn)
 {
     Super::OnPossess(InPawn);
 
+#if !UE_SERVER
     // 當控制器擁有一個 Pawn 時，更新血條 Widget 的擁有角色
     if (HealthBarWidgetInstance)
     {
@@ -53,12 +90,14 @@ void APlayerCharacterController::OnPossess(APawn* InPawn)
             UE_LOG(LogTemp, Log, TEXT("PlayerCharacterController possessed new Character and updated HealthBar."));
         }
     }
+#endif
 }
 
 void APlayerCharacterController::OnUnPossess()
 {
     Super::OnUnPossess();
 
+#if !UE_SERVER
     // 當控制器失去一個 Pawn 時，可以選擇清理血條 Widget
     if (HealthBarWidgetInstance)
     {
@@ -66,10 +105,12 @@ void APlayerCharacterController::OnUnPossess()
         HealthBarWidgetInstance = nullptr; // 清空指針
         UE_LOG(LogTemp, Log, TEXT("PlayerCharacterController unpossessed Character and cleared HealthBar."));
     }
+#endif
 }
 
 void APlayerCharacterController::CreateAndSetupHealthBarWidget()
 {
+#if !UE_SERVER
     if (HealthBarWidgetClass)
     {
         // 注意這裡的 Owner 是 this (PlayerController)
@@ -98,4 +139,38 @@ void APlayerCharacterController::CreateAndSetupHealthBarWidget()
     {
         UE_LOG(LogTemp, Warning, TEXT("HealthBarWidgetClass is not set in PlayerCharacterController."));
     }
+#endif
+}
+
+void APlayerCharacterController::CreateCrowdHealthBars()
+{
+#if !UE_SERVER
+    ULocalPlayer* LocalPlayer = GetLocalPlayer();
+    UGameViewportClient* ViewportClient = GetWorld()->GetGameViewport();
+    if (!SCrowdHealthBars::IsEnabled() || !LocalPlayer || !ViewportClient || CrowdHealthBars.IsValid())
+    {
+        return;
+    }
+
+    // 加在這個玩家的視口區域 (分割畫面時各自一個)，位於血條 Widget 之下
+    CrowdHealthBars = SNew(SCrowdHealthBars).PlayerController(this);
+    ViewportClient->AddViewportWidgetForPlayer(LocalPlayer, CrowdHealthBars.ToSharedRef(), -1);
+#endif
+}
+
+void APlayerCharacterController::RemoveCrowdHealthBars()
+{
+#if !UE_SERVER
+    if (!CrowdHealthBars.IsValid())
+    {
+        return;
+    }
+
+    UGameViewportClient* ViewportClient = GetWorld() ? GetWorld()->GetGameViewport() : nullptr;
+    if (ViewportClient && GetLocalPlayer())
+    {
+        ViewportClient->RemoveViewportWidgetForPlayer(GetLocalPlayer(), CrowdHealthBars.ToSharedRef());
+    }
+    CrowdHealthBars.Reset();
+#endif
 }
@@ -0,0 +1,408 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Replication/CharacterSampleReplicationGraph.h"
+#include "Core/CharacterBase.h"
+#include "Core/CrowdBenchmarkUtils.h" // 用於效能測試時生成群眾
+#include "Subsystems/CharacterSpatialIndexSubsystem.h" // 角色的空間雜湊
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/ChildConnection.h"
+#include "EngineUtils.h" // TActorIterator
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "UObject/UObjectIterator.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台變數與指令
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("RepGraph Replicate Actors"), STAT_RepGraphReplicateActors, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("RepGraph Gather Crowd"), STAT_RepGraphGatherCrowd, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RepGraph Gathered Characters"), STAT_RepGraphGatheredCharacters, STATGROUP_CharacterSample);
+
+namespace CrowdReplication
+{
+    static bool bEnable = true;
+    static FAutoConsoleVariableRef CVarEnable(
+        TEXT("CharacterSample.RepGraph.Enable"),
+        bEnable,
+        TEXT("建立遊戲 NetDriver 時是否使用專案的複製圖 (0 = 引擎預設的逐連線相關性檢查)。只影響之後建立的 NetDriver。"));
+
+    static float NearDistance = 2000.0f;
+    static FAutoConsoleVariableRef CVarNearDistance(
+        TEXT("CharacterSample.RepGraph.NearDistance"),
+        NearDistance,
+        TEXT("距離視角小於此值的角色每個複製幀都更新。"));
+
+    static float MidDistance = 5000.0f;
+    static FAutoConsoleVariableRef CVarMidDistance(
+        TEXT("CharacterSample.RepGraph.MidDistance"),
+        MidDistance,
+        TEXT("距離視角小於此值的角色每 2 個複製幀更新一次，更遠的每 4 幀一次。"));
+
+    static float CullDistance = 15000.0f;
+    static FAutoConsoleVariableRef CVarCullDistance(
+        TEXT("CharacterSample.RepGraph.CullDistance"),
+        CullDistance,
+        TEXT("超過此距離的角色不複製給該連線。"));
+
+    static constexpr uint16 NearPeriodFrames = 1;
+    static constexpr uint16 MidPeriodFrames = 2;
+    static constexpr uint16 FarPeriodFrames = 4;
+
+    // 效能測試用的群眾 (CharacterSample.RepGraph.SpawnCrowd)
+    static TArray<TWeakObjectPtr<ACharacterBase>> SpawnedCrowd;
+}
+
+// ====================================================================
+// >>> 控制台指令：複製成本統計與測試群眾 <<<
+// 用法：CharacterSample.RepGraph.SpawnCrowd [角色數量，預設 500]
+//       CharacterSample.RepGraph.ClearCrowd
+//       CharacterSample.RepGraph.Stats [reset]
+// ====================================================================
+static void SpawnReplicationCrowd(const TArray<FString>& Args, UWorld* World)
+{
+    if (!World || World->GetNetMode() == NM_Client)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("RepGraph SpawnCrowd: must be run on the server."));
+        return;
+    }
+
+    const int32 CrowdSize = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+
+    // 在第一個玩家附近生成，讓近、中、遠三種更新頻率都有角色
+    FVector Center = FVector::ZeroVector;
+    if (const APlayerController* PlayerController = World->GetFirstPlayerController())
+    {
+        if (const APawn* Pawn = PlayerController->GetPawn())
+        {
+            Center = Pawn->GetActorLocation();
+        }
+    }
+
+    FRandomStream RandomStream(CrowdSize);
+    for (ACharacterBase* Character : CrowdBenchmark::SpawnCrowd(World, CrowdSize, Center, 400.0f, RandomStream))
+    {
+        CrowdReplication::SpawnedCrowd.Add(Character);
+    }
+    UE_LOG(LogTemp, Log, TEXT("RepGraph SpawnCrowd: %d replication test characters in the world."), CrowdReplication::SpawnedCrowd.Num());
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GRepGraphSpawnCrowdCommand(
+    TEXT("CharacterSample.RepGraph.SpawnCrowd"),
+    TEXT("在伺服器上第一個玩家附近生成複製測試用的角色。參數：[角色數量]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SpawnReplicationCrowd));
+
+static FAutoConsoleCommand GRepGraphClearCrowdCommand(
+    TEXT("CharacterSample.RepGraph.ClearCrowd"),
+    TEXT("銷毀 CharacterSample.RepGraph.SpawnCrowd 生成的角色。"),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        // 世界可能已經切換，只銷毀仍然存在的角色
+        TArray<ACharacterBase*> Crowd;
+        for (const TWeakObjectPtr<ACharacterBase>& Character : CrowdReplication::SpawnedCrowd)
+        {
+            if (Character.IsValid())
+            {
+                Crowd.Add(Character.Get());
+            }
+        }
+        CrowdBenchmark::DestroyCrowd(Crowd);
+        CrowdReplication::SpawnedCrowd.Reset();
+    }));
+
+static void DumpReplicationGraphStats(const TArray<FString>& Args, UWorld* World)
+{
+    UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+    UCharacterSampleReplicationGraph* Graph = NetDriver ? Cast<UCharacterSampleReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr;
+    if (!Graph)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("RepGraph Stats: this world's NetDriver is not using UCharacterSampleReplicationGraph (use stat Net for the default path)."));
+        return;
+    }
+
+    int32 NumCharacters = 0;
+    for (TActorIterator<ACharacterBase> It(World); It; ++It)
+    {
+        ++NumCharacters;
+    }
+
+    const FLatencyHistogram& Histogram = Graph->GetReplicateActorsHistogram();
+    UE_LOG(LogTemp, Log, TEXT("RepGraph Stats [%d characters, %d clients]: ServerReplicateActors %s | %.3f us/character/frame"),
+        NumCharacters, NetDriver->ClientConnections.Num(),
+        *Histogram.ToString(),
+        NumCharacters > 0 ? Histogram.GetMeanMs() * 1000.0 / NumCharacters : 0.0);
+
+    if (Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+    {
+        Graph->ResetStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GRepGraphStatsCommand(
+    TEXT("CharacterSample.RepGraph.Stats"),
+    TEXT("輸出伺服器每幀 ServerReplicateActors 的成本分佈。參數：[reset]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpReplicationGraphStats));
+
+// ====================================================================
+// >>> UCharacterCrowdReplicationGraphNode <<<
+// ====================================================================
+
+void UCharacterCrowdReplicationGraphNode::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_RepGraphGatherCrowd);
+
+    if (!SpatialIndexSubsystem)
+    {
+        UWorld* World = GraphGlobals.IsValid() ? GraphGlobals->World : nullptr;
+        SpatialIndexSubsystem = World ? World->GetSubsystem<UCharacterSpatialIndexSubsystem>() : nullptr;
+        if (!SpatialIndexSubsystem)
+        {
+            return;
+        }
+    }
+
+    const float NearDistanceSquared = FMath::Square(CrowdReplication::NearDistance);
+    const float MidDistanceSquared = FMath::Square(CrowdReplication::MidDistance);
+    const float CullDistanceSquared = FMath::Square(CrowdReplication::CullDistance);
+
+    GatheredCharacters.Reset();
+    for (const FNetViewer& Viewer : Params.Viewers)
+    {
+        // 寬相：空間雜湊的半徑查詢；距離與頻率在這裡逐角色精確計算
+        ScratchCandidates.Reset();
+        SpatialIndexSubsystem->QueryRadius(Viewer.ViewLocation, CrowdReplication::CullDistance, ScratchCandidates);
+
+        for (ACharacterBase* Character : ScratchCandidates)
+        {
+            const float DistanceSquared = FVector::DistSquared(Viewer.ViewLocation, Character->GetActorLocation());
+            if (DistanceSquared > CullDistanceSquared)
+            {
+                continue;
+            }
+
+            const uint16 PeriodFrames = DistanceSquared < NearDistanceSquared ? CrowdReplication::NearPeriodFrames
+                : DistanceSquared < MidDistanceSquared ? CrowdReplication::MidPeriodFrames
+                : CrowdReplication::FarPeriodFrames;
+
+            // 分割畫面有多個視角時，以最近的視角 (最短週期) 為準
+            FConnectionReplicationActorInfo& ConnectionInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Character);
+            if (Params.Viewers.Num() == 1 || !GatheredCharacters.Contains(Character))
+            {
+                ConnectionInfo.ReplicationPeriodFrame = PeriodFrames;
+                ConnectionInfo.SetCullDistanceSquared(CullDistanceSquared);
+                GatheredCharacters.Add(Character);
+            }
+            else
+            {
+                ConnectionInfo.ReplicationPeriodFrame = FMath::Min(ConnectionInfo.ReplicationPeriodFrame, PeriodFrames);
+            }
+        }
+    }
+
+    SET_DWORD_STAT(STAT_RepGraphGatheredCharacters, GatheredCharacters.Num());
+    Params.OutGatheredReplicationLists.AddReplicationActorList(GatheredCharacters);
+}
+
+// ====================================================================
+// >>> UCharacterOwnerReplicationGraphNode <<<
+// ====================================================================
+
+void UCharacterOwnerReplicationGraphNode::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+    ReplicationActorList.Reset();
+    for (const FNetViewer& Viewer : Params.Viewers)
+    {
+        if (Viewer.InViewer)
+        {
+            ReplicationActorList.ConditionalAdd(Viewer.InViewer);
+        }
+        if (Viewer.ViewTarget)
+        {
+            ReplicationActorList.ConditionalAdd(Viewer.ViewTarget);
+        }
+        if (const APlayerController* PlayerController = Cast<APlayerController>(Viewer.InViewer))
+        {
+            if (APawn* Pawn = PlayerController->GetPawn())
+            {
+                ReplicationActorList.ConditionalAdd(Pawn);
+            }
+        }
+    }
+    for (AActor* Actor : OwnerOnlyActors)
+    {
+        ReplicationActorList.ConditionalAdd(Actor);
+    }
+
+    Super::GatherActorListsForConnection(Params);
+}
+
+// ====================================================================
+// >>> UCharacterSampleReplicationGraph <<<
+// ====================================================================
+
+UReplicationDriver* UCharacterSampleReplicationGraph::CreateForNetDriver(UNetDriver* ForNetDriver, const FURL& URL, UWorld* World)
+{
+    if (!CrowdReplication::bEnable || !ForNetDriver || ForNetDriver->NetDriverName != NAME_GameNetDriver)
+    {
+        return nullptr;
+    }
+    return NewObject<UCharacterSampleReplicationGraph>(GetTransientPackage());
+}
+
+void UCharacterSampleReplicationGraph::InitGlobalActorClassSettings()
+{
+    Super::InitGlobalActorClassSettings();
+
+    // 其他類別沿用 CDO 的 NetUpdateFrequency 與 NetCullDistanceSquared，與預設的相關性檢查一致
+    for (TObjectIterator<UClass> It; It; ++It)
+    {
+        UClass* Class = *It;
+        const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+        if (!ActorCDO || !ActorCDO->GetIsReplicated())
+        {
+            continue;
+        }
+
+        // 略過藍圖編譯過程中的暫時類別
+        const FString ClassName = Class->GetName();
+        if (ClassName.StartsWith(TEXT("SKEL_")) || ClassName.StartsWith(TEXT("REINST_")))
+        {
+            continue;
+        }
+
+        FClassReplicationInfo ClassInfo;
+        ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->GetNetUpdateFrequency());
+        ClassInfo.SetCullDistanceSquared(ActorCDO->GetNetCullDistanceSquared());
+
+        // 角色的頻率與剔除距離由群眾節點依連線逐一設定，這裡只給預設值
+        if (Class->IsChildOf(ACharacterBase::StaticClass()))
+        {
+            ClassInfo.ReplicationPeriodFrame = CrowdReplication::NearPeriodFrames;
+            ClassInfo.SetCullDistanceSquared(FMath::Square(CrowdReplication::CullDistance));
+        }
+
+        GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+    }
+}
+
+void UCharacterSampleReplicationGraph::InitGlobalGraphNodes()
+{
+    GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+    AddGlobalGraphNode(GridNode);
+
+    AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+    AddGlobalGraphNode(AlwaysRelevantNode);
+
+    CrowdNode = CreateNewNode<UCharacterCrowdReplicationGraphNode>();
+    AddGlobalGraphNode(CrowdNode);
+}
+
+void UCharacterSampleReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+    Super::InitConnectionGraphNodes(RepGraphConnection);
+
+    UCharacterOwnerReplicationGraphNode* OwnerNode = CreateNewNode<UCharacterOwnerReplicationGraphNode>();
+    AddConnectionGraphNode(OwnerNode, RepGraphConnection);
+    OwnerNodes.Add(RepGraphConnection->NetConnection, OwnerNode);
+}
+
+void UCharacterSampleReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
+{
+    OwnerNodes.Remove(NetConnection);
+
+    Super::RemoveClientConnection(NetConnection);
+}
+
+bool UCharacterSampleReplicationGraph::RouteOwnerOnlyActor(AActor* Actor)
+{
+    UNetConnection* Connection = Actor->GetNetConnection();
+    if (const UChildConnection* ChildConnection = Cast<UChildConnection>(Connection))
+    {
+        Connection = ChildConnection->Parent; // 分割畫面的玩家共用主連線的節點
+    }
+
+    UCharacterOwnerReplicationGraphNode** OwnerNode = Connection ? OwnerNodes.Find(Connection) : nullptr;
+    if (!OwnerNode)
+    {
+        return false;
+    }
+
+    (*OwnerNode)->AddOwnerOnlyActor(Actor);
+    return true;
+}
+
+void UCharacterSampleReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+    AActor* Actor = ActorInfo.Actor;
+
+    // 角色由群眾節點透過空間索引收集，不需要另外登錄
+    if (Actor->IsA<ACharacterBase>())
+    {
+        return;
+    }
+
+    if (Actor->bAlwaysRelevant)
+    {
+        AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+        return;
+    }
+
+    // 只對擁有者相關的 Actor 只交給擁有連線的專屬節點
+    if (Actor->bOnlyRelevantToOwner)
+    {
+        if (!RouteOwnerOnlyActor(Actor))
+        {
+            PendingOwnerOnlyActors.Add(Actor);
+        }
+        return;
+    }
+
+    GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+}
+
+void UCharacterSampleReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+    AActor* Actor = ActorInfo.Actor;
+    if (Actor->IsA<ACharacterBase>())
+    {
+        return;
+    }
+
+    // 移除時擁有連線可能已經關閉，從所有連線的節點與等待清單中移除
+    if (Actor->bOnlyRelevantToOwner)
+    {
+        PendingOwnerOnlyActors.RemoveSwap(Actor, EAllowShrinking::No);
+        for (TPair<UNetConnection*, UCharacterOwnerReplicationGraphNode*>& Pair : OwnerNodes)
+        {
+            Pair.Value->RemoveOwnerOnlyActor(Actor);
+        }
+        return;
+    }
+
+    if (Actor->bAlwaysRelevant)
+    {
+        AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+        return;
+    }
+
+    GridNode->RemoveActor_Dynamic(ActorInfo);
+}
+
+int32 UCharacterSampleReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_RepGraphReplicateActors);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    for (int32 Index = PendingOwnerOnlyActors.Num() - 1; Index >= 0; --Index)
+    {
+        if (RouteOwnerOnlyActor(PendingOwnerOnlyActors[Index]))
+        {
+            PendingOwnerOnlyActors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        }
+    }
+
+    const int32 Result = Super::ServerReplicateActors(DeltaSeconds);
+    ReplicateActorsHistogram.AddSampleMs((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return Result;
+}
@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CharacterAnimVariablesSubsystem.h"
+#include "Player/PlayerCharacter.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台變數
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Anim Variables Gather"), STAT_AnimVariablesGather, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Anim Variables Compute"), STAT_AnimVariablesCompute, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Anim Variables Scatter"), STAT_AnimVariablesScatter, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim Variables Characters"), STAT_AnimVariablesCharacters, STATGROUP_CharacterSample);
+
+namespace AnimVariables
+{
+    static bool bParallel = true;
+    static FAutoConsoleVariableRef CVarParallel(
+        TEXT("CharacterSample.AnimVariables.Parallel"),
+        bParallel,
+        TEXT("動畫變數的計算是否以 ParallelFor 分散到工作執行緒 (0 = 只在遊戲執行緒上計算)。"));
+
+    // 每個工作批次的最少角色數，太小時排程成本會超過計算本身
+    static constexpr int32 MinBatchSize = 256;
+}
+
+bool UCharacterAnimVariablesSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacterAnimVariablesSubsystem::Deinitialize()
+{
+    Characters.Empty();
+    MovementComponents.Empty();
+    Velocities.Empty();
+    ActorYaws.Empty();
+    Speeds.Empty();
+    Directions.Empty();
+    FreeList.Empty();
+    NumRegistered = 0;
+
+    Super::Deinitialize();
+}
+
+TStatId UCharacterAnimVariablesSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacterAnimVariablesSubsystem, STATGROUP_Tickables);
+}
+
+int32 UCharacterAnimVariablesSubsystem::RegisterCharacter(APlayerCharacter* Character)
+{
+    if (!Character)
+    {
+        return INDEX_NONE;
+    }
+
+    int32 Handle;
+    if (FreeList.Num() > 0)
+    {
+        Handle = FreeList.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        Handle = Characters.AddDefaulted();
+        MovementComponents.AddDefaulted();
+        Velocities.AddZeroed();
+        ActorYaws.AddZeroed();
+        Speeds.AddZeroed();
+        Directions.AddZeroed();
+    }
+
+    Characters[Handle] = Character;
+    MovementComponents[Handle] = Character->GetCharacterMovement();
+
+    ++NumRegistered;
+    return Handle;
+}
+
+void UCharacterAnimVariablesSubsystem::UnregisterCharacter(int32 Handle)
+{
+    if (!Characters.IsValidIndex(Handle) || !Characters[Handle])
+    {
+        return;
+    }
+
+    Characters[Handle] = nullptr;
+    MovementComponents[Handle] = nullptr;
+    Velocities[Handle] = FVector3f::ZeroVector;
+
+    FreeList.Add(Handle);
+    --NumRegistered;
+}
+
+void UCharacterAnimVariablesSubsystem::ComputeAnimVariables(const FVector3f& Velocity, float ActorYaw, float& OutSpeed, float& OutDirection)
+{
+    OutSpeed = Velocity.Size();
+
+    // 只看水平速度。Atan2 與向量長度無關，因此不需要正規化；
+    // 世界空間的速度角度減去角色 Yaw，等同於先把速度轉到角色的局部空間再取角度
+    const float HorizontalSizeSquared = Velocity.X * Velocity.X + Velocity.Y * Velocity.Y;
+    if (OutSpeed > UE_KINDA_SMALL_NUMBER && HorizontalSizeSquared > UE_KINDA_SMALL_NUMBER)
+    {
+        OutDirection = FRotator3f::NormalizeAxis(FMath::RadiansToDegrees(FMath::Atan2(Velocity.Y, Velocity.X)) - ActorYaw);
+    }
+    else
+    {
+        OutDirection = 0.0f;
+    }
+}
+
+// ====================================================================
+// >>> Tick：收集 -> 平行計算 -> 寫回 <<<
+// 收集與寫回會存取 UObject，必須在遊戲執行緒；只有純數學的計算階段分散到工作執行緒
+// ====================================================================
+void UCharacterAnimVariablesSubsystem::Tick(float DeltaTime)
+{
+    if (NumRegistered == 0)
+    {
+        return;
+    }
+
+    const int32 NumSlots = Characters.Num();
+    SET_DWORD_STAT(STAT_AnimVariablesCharacters, NumRegistered);
+
+    {
+        CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_AnimVariablesGather);
+        for (int32 Index = 0; Index < NumSlots; ++Index)
+        {
+            if (const APlayerCharacter* Character = Characters[Index])
+            {
+                Velocities[Index] = FVector3f(Character->GetVelocity());
+                ActorYaws[Index] = static_cast<float>(Character->GetActorRotation().Yaw);
+            }
+        }
+    }
+
+    {
+        CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_AnimVariablesCompute);
+        ParallelFor(TEXT("CharacterSample.AnimVariables"), NumSlots, AnimVariables::MinBatchSize, [this](int32 Index)
+        {
+            ComputeAnimVariables(Velocities[Index], ActorYaws[Index], Speeds[Index], Directions[Index]);
+        }, AnimVariables::bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+    }
+
+    {
+        CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_AnimVariablesScatter);
+        for (int32 Index = 0; Index < NumSlots; ++Index)
+        {
+            if (APlayerCharacter* Character = Characters[Index])
+            {
+                Character->CurrentSpeed = Speeds[Index];
+                Character->MovementDirection = Directions[Index];
+                Character->bIsFalling = MovementComponents[Index] && MovementComponents[Index]->IsFalling();
+            }
+        }
+    }
+}
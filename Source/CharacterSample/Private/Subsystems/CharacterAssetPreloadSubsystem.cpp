@@ -0,0 +1,263 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/CharacterAssetPreloadSubsystem.h"
+#include "Player/PlayerCharacter.h"
+#include "CharacterSampleGameMode.h"
+#include "Components/CombatComponent.h"
+#include "Components/EntranceAnimationComponent.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
+#include "Algo/AllOf.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台變數與指令
+
+namespace CharacterAssetPreload
+{
+    static bool bAsyncLoad = true;
+    static FAutoConsoleVariableRef CVarAsyncLoad(
+        TEXT("CharacterSample.Preload.Async"),
+        bAsyncLoad,
+        TEXT("以非同步串流載入角色的蒙太奇等表演資產 (0 = 同步載入，等同原本的硬引用，用於比較卡頓)。"));
+}
+
+bool UCharacterAssetPreloadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // 只在實際遊戲世界中運作 (包含 PIE)，編輯器預覽世界不需要
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacterAssetPreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // GameMode 在 PreInitializeComponents 廣播，此時還沒有任何玩家登入或生成角色
+    GameModeInitializedHandle = FGameModeEvents::GameModeInitializedEvent.AddUObject(this, &UCharacterAssetPreloadSubsystem::OnGameModeInitialized);
+
+    // 客戶端沒有 GameMode：在 GameState 從伺服器複製過來時開始預載
+    GameStateSetHandle = GetWorld()->GameStateSetEvent.AddUObject(this, &UCharacterAssetPreloadSubsystem::OnGameStateSet);
+}
+
+void UCharacterAssetPreloadSubsystem::Deinitialize()
+{
+    FGameModeEvents::GameModeInitializedEvent.Remove(GameModeInitializedHandle);
+    GetWorld()->GameStateSetEvent.Remove(GameStateSetHandle);
+
+    for (TPair<TObjectKey<UClass>, TSharedPtr<FStreamableHandle>>& Pair : ClassHandles)
+    {
+        if (Pair.Value.IsValid())
+        {
+            Pair.Value->ReleaseHandle();
+        }
+    }
+    ClassHandles.Reset();
+    PawnClassHandle.Reset();
+
+    Super::Deinitialize();
+}
+
+void UCharacterAssetPreloadSubsystem::OnGameStateSet(AGameStateBase* GameState)
+{
+    TryPreloadFromGameState();
+}
+
+// ====================================================================
+// >>> 客戶端預載 <<<
+// GameState 在 PostInitializeComponents 設定到世界，此時複製的屬性 (GameModeClass) 可能還沒套用；
+// 還沒到達時在下一幀重試，直到 GameModeClass 複製過來或 GameState 被移除
+// ====================================================================
+void UCharacterAssetPreloadSubsystem::TryPreloadFromGameState()
+{
+    UWorld* World = GetWorld();
+    const AGameStateBase* GameState = World->GetGameState();
+    if (bClientPreloadStarted || World->GetAuthGameMode() || !GameState)
+    {
+        return;
+    }
+    if (!GameState->GameModeClass)
+    {
+        World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &UCharacterAssetPreloadSubsystem::TryPreloadFromGameState));
+        return;
+    }
+    bClientPreloadStarted = true;
+
+    // 專案的 GameMode 以軟類別指定角色，預設物件上只有後備類別：先串流角色類別本身再預載
+    const AGameModeBase* GameModeCDO = GameState->GameModeClass->GetDefaultObject<AGameModeBase>();
+    if (const ACharacterSampleGameMode* CharacterSampleGameModeCDO = Cast<ACharacterSampleGameMode>(GameModeCDO))
+    {
+        const TSoftClassPtr<APawn> PawnSoftClass = CharacterSampleGameModeCDO->GetDefaultPawnSoftClass();
+        if (!PawnSoftClass.IsNull())
+        {
+            PawnClassHandle = RequestAssets({ PawnSoftClass.ToSoftObjectPath() }, FStreamableDelegate::CreateWeakLambda(this, [this, PawnSoftClass]()
+            {
+                PreloadCharacterClass(PawnSoftClass.Get());
+            }));
+            return;
+        }
+    }
+    PreloadCharacterClass(GameModeCDO->DefaultPawnClass);
+}
+
+void UCharacterAssetPreloadSubsystem::OnGameModeInitialized(AGameModeBase* GameMode)
+{
+    if (GameMode && GameMode->GetWorld() == GetWorld())
+    {
+        PreloadCharacterClass(GameMode->DefaultPawnClass);
+    }
+}
+
+TSharedPtr<FStreamableHandle> UCharacterAssetPreloadSubsystem::PreloadCharacterClass(const UClass* CharacterClass)
+{
+    if (!CharacterClass)
+    {
+        return nullptr;
+    }
+    if (const TSharedPtr<FStreamableHandle>* ExistingHandle = ClassHandles.Find(CharacterClass))
+    {
+        return *ExistingHandle;
+    }
+
+    TArray<FSoftObjectPath> Paths;
+    GatherCharacterAssets(CharacterClass, Paths, GetWorld());
+
+    if (Paths.Num() > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("CharacterAssetPreload: preloading %d assets for %s (%s)."),
+            Paths.Num(), *CharacterClass->GetName(), CharacterAssetPreload::bAsyncLoad ? TEXT("async") : TEXT("sync"));
+    }
+
+    TSharedPtr<FStreamableHandle> Handle = RequestAssets(MoveTemp(Paths));
+    ClassHandles.Add(CharacterClass, Handle);
+    return Handle;
+}
+
+TSharedPtr<FStreamableHandle> UCharacterAssetPreloadSubsystem::RequestAssets(TArray<FSoftObjectPath> Paths, FStreamableDelegate OnLoaded)
+{
+    if (Paths.Num() == 0)
+    {
+        OnLoaded.ExecuteIfBound();
+        return nullptr;
+    }
+
+    FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+    if (!CharacterAssetPreload::bAsyncLoad)
+    {
+        TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestSyncLoad(MoveTemp(Paths));
+        OnLoaded.ExecuteIfBound();
+        return Handle;
+    }
+    return StreamableManager.RequestAsyncLoad(MoveTemp(Paths), MoveTemp(OnLoaded), FStreamableManager::AsyncLoadHighPriority);
+}
+
+TSharedPtr<FStreamableHandle> UCharacterAssetPreloadSubsystem::LoadCharacterAssetsSync(const UClass* CharacterClass)
+{
+    TArray<FSoftObjectPath> Paths;
+    GatherCharacterAssets(CharacterClass, Paths);
+    return Paths.Num() > 0 ? UAssetManager::GetStreamableManager().RequestSyncLoad(MoveTemp(Paths)) : nullptr;
+}
+
+void UCharacterAssetPreloadSubsystem::GatherCharacterAssets(const UClass* CharacterClass, TArray<FSoftObjectPath>& OutPaths, const UWorld* World)
+{
+    const APlayerCharacter* CharacterCDO = CharacterClass ? Cast<APlayerCharacter>(CharacterClass->GetDefaultObject()) : nullptr;
+    if (!CharacterCDO)
+    {
+        return;
+    }
+
+    if (CharacterCDO->CombatComponent)
+    {
+        CharacterCDO->CombatComponent->GetPreloadAssets(OutPaths);
+    }
+    if (CharacterCDO->EntranceAnimationComponent)
+    {
+        CharacterCDO->EntranceAnimationComponent->GetPreloadAssets(OutPaths, World);
+    }
+}
+
+bool UCharacterAssetPreloadSubsystem::AreCharacterAssetsLoaded(const UClass* CharacterClass, const UWorld* World)
+{
+    TArray<FSoftObjectPath> Paths;
+    GatherCharacterAssets(CharacterClass, Paths, World);
+    return Algo::AllOf(Paths, [](const FSoftObjectPath& Path) { return Path.ResolveObject() != nullptr; });
+}
+
+// ====================================================================
+// >>> 控制台指令：生成角色時的卡頓 <<<
+// 用法 (在伺服器或單機上執行)：CharacterSample.Preload.SpawnHitch [角色類別路徑，預設為 GameMode 的 DefaultPawnClass]
+// 依序計時：載入角色類別、預載階段 (非同步時只是發出請求)、生成角色 (包含 BeginPlay)，三者合計為這一幀被阻塞的時間；
+// 非同步時再輪詢句柄，回報資產在生成後多久載入完成 (入場動畫在這段期間等待)。
+// 在新的行程中以 CharacterSample.Preload.Async 0 與 1 各執行一次，比較硬引用與串流預載的卡頓。
+// ====================================================================
+static void MeasureSpawnHitch(const TArray<FString>& Args, UWorld* World)
+{
+    UCharacterAssetPreloadSubsystem* PreloadSubsystem = World ? World->GetSubsystem<UCharacterAssetPreloadSubsystem>() : nullptr;
+    const AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+    if (!PreloadSubsystem || !GameMode)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Preload SpawnHitch: must be run on a server or standalone game world."));
+        return;
+    }
+
+    const double ClassLoadStart = FPlatformTime::Seconds();
+    UClass* CharacterClass = Args.Num() > 0 ? LoadClass<APlayerCharacter>(nullptr, *Args[0]) : GameMode->DefaultPawnClass.Get();
+    const double ClassLoadMs = (FPlatformTime::Seconds() - ClassLoadStart) * 1000.0;
+    if (!CharacterClass || !CharacterClass->IsChildOf<APlayerCharacter>())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Preload SpawnHitch: %s is not an APlayerCharacter class."), Args.Num() > 0 ? *Args[0] : *GetNameSafe(CharacterClass));
+        return;
+    }
+
+    const bool bWasResident = UCharacterAssetPreloadSubsystem::AreCharacterAssetsLoaded(CharacterClass, World);
+
+    const double PreloadStart = FPlatformTime::Seconds();
+    const TSharedPtr<FStreamableHandle> Handle = PreloadSubsystem->PreloadCharacterClass(CharacterClass);
+    const double PreloadMs = (FPlatformTime::Seconds() - PreloadStart) * 1000.0;
+
+    // 生成在第一個玩家前方 (或世界原點)
+    FTransform SpawnTransform;
+    if (const APlayerController* PlayerController = World->GetFirstPlayerController())
+    {
+        if (const APawn* PlayerPawn = PlayerController->GetPawn())
+        {
+            SpawnTransform.SetLocation(PlayerPawn->GetActorLocation() + PlayerPawn->GetActorForwardVector() * 300.0f);
+        }
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+    const double SpawnStart = FPlatformTime::Seconds();
+    World->SpawnActor<APlayerCharacter>(CharacterClass, SpawnTransform, SpawnParams);
+    const double SpawnMs = (FPlatformTime::Seconds() - SpawnStart) * 1000.0;
+
+    const FString Summary = FString::Printf(TEXT("Preload SpawnHitch [%s, %s, assets %s]: class load %.2f ms + preload %.2f ms + spawn %.2f ms = %.2f ms blocking"),
+        *CharacterClass->GetName(), CharacterAssetPreload::bAsyncLoad ? TEXT("async") : TEXT("sync"), bWasResident ? TEXT("already resident") : TEXT("not resident"),
+        ClassLoadMs, PreloadMs, SpawnMs, ClassLoadMs + PreloadMs + SpawnMs);
+
+    if (!Handle.IsValid() || Handle->HasLoadCompleted())
+    {
+        UE_LOG(LogTemp, Log, TEXT("%s | assets ready at spawn"), *Summary);
+        return;
+    }
+
+    // 輪詢句柄直到載入完成，最多等待 10 秒
+    const double ReadyPollStart = FPlatformTime::Seconds();
+    TSharedRef<FTimerHandle> PollTimerHandle = MakeShared<FTimerHandle>();
+    World->GetTimerManager().SetTimer(*PollTimerHandle, FTimerDelegate::CreateWeakLambda(World, [World, Handle, Summary, ReadyPollStart, PollTimerHandle]()
+    {
+        const double WaitedMs = (FPlatformTime::Seconds() - ReadyPollStart) * 1000.0;
+        if (Handle->HasLoadCompleted() || WaitedMs > 10000.0)
+        {
+            UE_LOG(LogTemp, Log, TEXT("%s | assets %s %.1f ms after spawn"), *Summary, Handle->HasLoadCompleted() ? TEXT("ready") : TEXT("still loading"), WaitedMs);
+            // 最後一次呼叫會清除計時器本身，先複製一份參考讓句柄活過這次呼叫
+            const TSharedRef<FTimerHandle> KeepAlive = PollTimerHandle;
+            World->GetTimerManager().ClearTimer(*KeepAlive);
+        }
+    }), 0.01f, true);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GPreloadSpawnHitchCommand(
+    TEXT("CharacterSample.Preload.SpawnHitch"),
+    TEXT("量測生成一個角色時阻塞遊戲執行緒的時間與資產載入完成的時間。參數：[角色類別路徑]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&MeasureSpawnHitch));
@@ -0,0 +1,529 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CharacterHealthSubsystem.h"
+#include "Core/CharacterBase.h"
+#include "Core/CrowdBenchmarkUtils.h" // 用於效能測試時生成群眾
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Health Passes"), STAT_HealthPasses, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Health Notify"), STAT_HealthNotify, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health Changed"), STAT_HealthChanged, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Health Notify Flush"), STAT_HealthNotifyFlush, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health Notify Requested"), STAT_HealthNotifyRequested, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health Notify Sent"), STAT_HealthNotifySent, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health Notify Suppressed"), STAT_HealthNotifySuppressed, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health Notify Pending"), STAT_HealthNotifyPending, STATGROUP_CharacterSample);
+
+namespace HealthNotify
+{
+    // 畫面外角色的廣播頻率 (次/秒)；0 表示畫面外也每幀廣播
+    static float OffscreenNotifyRate = 4.0f;
+    static FAutoConsoleVariableRef CVarOffscreenNotifyRate(
+        TEXT("CharacterSample.Health.OffscreenNotifyRate"),
+        OffscreenNotifyRate,
+        TEXT("開啟合併通知的角色在畫面外時，生命值廣播的最高頻率 (次/秒，0 = 與畫面內相同，每幀一次)。"));
+
+    // 判定為「畫面內」的最近渲染時間容許值 (秒)
+    static constexpr float RecentlyRenderedTolerance = 0.2f;
+}
+
+// ====================================================================
+// >>> 控制台指令：逐 Actor 與 SoA 生命值處理的效能比較 <<<
+// 用法：CharacterSample.Health.Benchmark [角色數量，預設 10000] [回合數，預設 100]
+// 兩條路徑執行相同的運算 (治療、回復、傷害、無敵與死亡偵測)，差別只在資料位於各個 Actor 或緊密陣列中；
+// 兩者都以相同的模擬時間推進，結束時比對每個角色的生命值與死亡數，確保量測的是同一份工作
+// ====================================================================
+static void RunHealthBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    UCharacterHealthSubsystem* HealthSubsystem = World ? World->GetSubsystem<UCharacterHealthSubsystem>() : nullptr;
+    if (!HealthSubsystem)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Health Benchmark: CharacterHealthSubsystem is not available in this world."));
+        return;
+    }
+
+    const int32 CrowdSize = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+    const int32 NumRounds = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100;
+    const float DeltaTime = 1.0f / 60.0f;
+
+    FRandomStream RandomStream(CrowdSize);
+    TArray<ACharacterBase*> Crowd = CrowdBenchmark::SpawnCrowd(World, CrowdSize, FVector(0.0f, 0.0f, 10000.0f), 300.0f, RandomStream);
+
+    // 預先產生每回合的傷害與治療，讓兩條路徑處理完全一樣的輸入
+    TArray<float> Damages;
+    TArray<float> Heals;
+    Damages.SetNumUninitialized(Crowd.Num());
+    Heals.SetNumUninitialized(Crowd.Num());
+    for (int32 Index = 0; Index < Crowd.Num(); ++Index)
+    {
+        Damages[Index] = RandomStream.FRand() < 0.3f ? RandomStream.FRandRange(1.0f, 10.0f) : 0.0f;
+        Heals[Index] = RandomStream.FRand() < 0.1f ? RandomStream.FRandRange(1.0f, 5.0f) : 0.0f;
+    }
+
+    // 兩條路徑從同一個起點開始：逐 Actor 的欄位以子系統目前的資料為準
+    TArray<int32> Handles;
+    Handles.Reserve(Crowd.Num());
+    for (ACharacterBase* Character : Crowd)
+    {
+        const int32 Handle = Character->GetHealthHandle();
+        Handles.Add(Handle);
+        HealthSubsystem->SetRegenPerSecond(Handle, 1.0f);
+        Character->CurrentHealth = HealthSubsystem->GetCurrentHealth(Handle);
+        Character->bIsDead = HealthSubsystem->IsDead(Handle);
+    }
+
+    // --- 對照組：逐 Actor 處理 (原本資料分散在每個角色物件中的存取方式) ---
+    struct FActorHealthState
+    {
+        double InvincibleUntil = 0.0;
+    };
+    TArray<FActorHealthState> ActorStates;
+    ActorStates.SetNum(Crowd.Num());
+
+    int32 ActorDeaths = 0;
+    double Now = 0.0;
+    const double ActorStartTime = FPlatformTime::Seconds();
+    for (int32 Round = 0; Round < NumRounds; ++Round, Now += DeltaTime)
+    {
+        for (int32 Index = 0; Index < Crowd.Num(); ++Index)
+        {
+            ACharacterBase* Character = Crowd[Index];
+            if (Character->bIsDead)
+            {
+                continue;
+            }
+
+            const float HealAmount = Heals[Index] + 1.0f * DeltaTime; // 與 SoA 的加總順序相同，結果逐位元一致
+            Character->CurrentHealth = FMath::Min(Character->CurrentHealth + HealAmount, Character->MaxHealth);
+            if (Damages[Index] > 0.0f && Now >= ActorStates[Index].InvincibleUntil)
+            {
+                Character->CurrentHealth = FMath::Max(Character->CurrentHealth - Damages[Index], 0.0f);
+                ActorStates[Index].InvincibleUntil = Now + Character->InvincibilityDuration;
+            }
+            if (Character->CurrentHealth <= 0.0f)
+            {
+                Character->bIsDead = true;
+                ++ActorDeaths;
+            }
+        }
+    }
+    const double ActorSeconds = FPlatformTime::Seconds() - ActorStartTime;
+
+    // --- SoA：排入佇列後以線性掃描處理 (不通知角色，只比較資料處理) ---
+    // 基準測試在同一幀內執行，世界時間不會前進；以模擬時間覆寫，無敵時間才會與對照組一樣到期
+    Now = 0.0;
+    const double SoAStartTime = FPlatformTime::Seconds();
+    for (int32 Round = 0; Round < NumRounds; ++Round, Now += DeltaTime)
+    {
+        for (int32 Index = 0; Index < Handles.Num(); ++Index)
+        {
+            if (Damages[Index] > 0.0f)
+            {
+                HealthSubsystem->QueueDamage(Handles[Index], Damages[Index]);
+            }
+            if (Heals[Index] > 0.0f)
+            {
+                HealthSubsystem->QueueHeal(Handles[Index], Heals[Index]);
+            }
+        }
+        HealthSubsystem->RunHealthPasses(DeltaTime, false, Now);
+    }
+    const double SoASeconds = FPlatformTime::Seconds() - SoAStartTime;
+
+    // 比對兩條路徑的結果
+    int32 SoADeaths = 0;
+    int32 NumMismatches = 0;
+    for (int32 Index = 0; Index < Crowd.Num(); ++Index)
+    {
+        const ACharacterBase* Character = Crowd[Index];
+        const bool bSoADead = HealthSubsystem->IsDead(Handles[Index]);
+        SoADeaths += bSoADead ? 1 : 0;
+        if (bSoADead != Character->bIsDead || !FMath::IsNearlyEqual(HealthSubsystem->GetCurrentHealth(Handles[Index]), Character->CurrentHealth))
+        {
+            if (NumMismatches < 10)
+            {
+                UE_LOG(LogTemp, Error, TEXT("Health Benchmark: character %d mismatch (per-actor %.3f%s, SoA %.3f%s)."), Index,
+                    Character->CurrentHealth, Character->bIsDead ? TEXT(" dead") : TEXT(""),
+                    HealthSubsystem->GetCurrentHealth(Handles[Index]), bSoADead ? TEXT(" dead") : TEXT(""));
+            }
+            ++NumMismatches;
+        }
+    }
+    if (NumMismatches > 0 || SoADeaths != ActorDeaths)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Health Benchmark: FAILED. %d of %d characters mismatched, deaths per-actor %d vs SoA %d."),
+            NumMismatches, Crowd.Num(), ActorDeaths, SoADeaths);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Health Benchmark [%d characters, %d rounds]: Per-actor %.3f us/round (%d deaths) | SoA %.3f us/round (%d deaths) | Speedup x%.1f"),
+        Crowd.Num(), NumRounds,
+        ActorSeconds * 1e6 / NumRounds, ActorDeaths,
+        SoASeconds * 1e6 / NumRounds, SoADeaths,
+        SoASeconds > 0.0 ? ActorSeconds / SoASeconds : 0.0);
+
+    CrowdBenchmark::DestroyCrowd(Crowd);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GCharacterHealthBenchmarkCommand(
+    TEXT("CharacterSample.Health.Benchmark"),
+    TEXT("比較逐 Actor 與 SoA 生命值處理 (治療、回復、傷害、死亡偵測) 的成本。參數：[角色數量] [回合數]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunHealthBenchmark));
+
+// ====================================================================
+// >>> 控制台指令：合併通知的統計 <<<
+// 用法：CharacterSample.Health.NotifyStats [reset]
+// ====================================================================
+static void DumpHealthNotifyStats(const TArray<FString>& Args, UWorld* World)
+{
+    UCharacterHealthSubsystem* HealthSubsystem = World ? World->GetSubsystem<UCharacterHealthSubsystem>() : nullptr;
+    if (!HealthSubsystem)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Health NotifyStats: CharacterHealthSubsystem is not available in this world."));
+        return;
+    }
+
+    const UCharacterHealthSubsystem::FNotifyStats& Stats = HealthSubsystem->GetNotifyStats();
+    UE_LOG(LogTemp, Log, TEXT("Health NotifyStats: Requested %llu | Sent %llu | Suppressed %llu (%.1f%%) | Pending %d | OffscreenNotifyRate %.1f Hz"),
+        Stats.Requested, Stats.Sent, Stats.Suppressed,
+        Stats.Requested > 0 ? 100.0 * Stats.Suppressed / Stats.Requested : 0.0,
+        HealthSubsystem->GetNumPendingNotifications(),
+        HealthNotify::OffscreenNotifyRate);
+
+    if (Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+    {
+        HealthSubsystem->ResetNotifyStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GCharacterHealthNotifyStatsCommand(
+    TEXT("CharacterSample.Health.NotifyStats"),
+    TEXT("輸出合併生命值通知的請求、實際廣播與被合併掉的次數。參數：[reset]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpHealthNotifyStats));
+
+// ====================================================================
+// >>> UCharacterHealthSubsystem 實作 <<<
+// ====================================================================
+
+bool UCharacterHealthSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacterHealthSubsystem::Deinitialize()
+{
+    CurrentHealth.Empty();
+    MaxHealth.Empty();
+    RegenPerSecond.Empty();
+    PendingDamage.Empty();
+    PendingHeal.Empty();
+    InvincibleUntil.Empty();
+    StateFlags.Empty();
+    InvincibilityDuration.Empty();
+    Characters.Empty();
+    LastNotifyTime.Empty();
+    FreeList.Empty();
+    ChangedHandles.Empty();
+    PendingNotifyHandles.Empty();
+    NumRegistered = 0;
+
+    Super::Deinitialize();
+}
+
+TStatId UCharacterHealthSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacterHealthSubsystem, STATGROUP_Tickables);
+}
+
+int32 UCharacterHealthSubsystem::RegisterCharacter(ACharacterBase* Character, float InMaxHealth, float InCurrentHealth, float InInvincibilityDuration, float InRegenPerSecond)
+{
+    int32 Handle;
+    if (FreeList.Num() > 0)
+    {
+        Handle = FreeList.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        Handle = StateFlags.Num();
+        CurrentHealth.AddUninitialized();
+        MaxHealth.AddUninitialized();
+        RegenPerSecond.AddUninitialized();
+        PendingDamage.AddUninitialized();
+        PendingHeal.AddUninitialized();
+        InvincibleUntil.AddUninitialized();
+        StateFlags.AddUninitialized();
+        InvincibilityDuration.AddUninitialized();
+        Characters.AddDefaulted();
+        LastNotifyTime.AddUninitialized();
+    }
+
+    MaxHealth[Handle] = InMaxHealth;
+    CurrentHealth[Handle] = FMath::Clamp(InCurrentHealth, 0.0f, InMaxHealth);
+    RegenPerSecond[Handle] = FMath::Max(InRegenPerSecond, 0.0f);
+    PendingDamage[Handle] = 0.0f;
+    PendingHeal[Handle] = 0.0f;
+    InvincibleUntil[Handle] = 0.0;
+    StateFlags[Handle] = EStateFlags::Registered;
+    InvincibilityDuration[Handle] = InInvincibilityDuration;
+    Characters[Handle] = Character;
+    LastNotifyTime[Handle] = 0.0;
+
+    ++NumRegistered;
+    return Handle;
+}
+
+void UCharacterHealthSubsystem::UnregisterCharacter(int32 Handle)
+{
+    if (!IsValidHandle(Handle))
+    {
+        return;
+    }
+
+    // 清空槽位，讓批次掃描自然略過 (未登錄的槽位沒有待處理的值也不會回復)
+    // NotifyPending 一併清除，PendingNotifyHandles 中殘留的項目在送出時會被略過
+    StateFlags[Handle] = 0;
+    PendingDamage[Handle] = 0.0f;
+    PendingHeal[Handle] = 0.0f;
+    RegenPerSecond[Handle] = 0.0f;
+    Characters[Handle].Reset();
+
+    FreeList.Add(Handle);
+    --NumRegistered;
+}
+
+void UCharacterHealthSubsystem::SetMaxHealth(int32 Handle, float NewMaxHealth)
+{
+    MaxHealth[Handle] = NewMaxHealth;
+    CurrentHealth[Handle] = FMath::Min(CurrentHealth[Handle], NewMaxHealth);
+}
+
+bool UCharacterHealthSubsystem::ApplyDamage(int32 Handle, float Amount)
+{
+    if (IsDead(Handle))
+    {
+        return false;
+    }
+
+    CurrentHealth[Handle] = FMath::Clamp(CurrentHealth[Handle] - Amount, 0.0f, MaxHealth[Handle]);
+    if (CurrentHealth[Handle] <= 0.0f)
+    {
+        StateFlags[Handle] |= EStateFlags::Dead;
+        return true;
+    }
+
+    StartInvincibility(Handle);
+    return false;
+}
+
+void UCharacterHealthSubsystem::ApplyHeal(int32 Handle, float Amount)
+{
+    if (!IsDead(Handle))
+    {
+        CurrentHealth[Handle] = FMath::Clamp(CurrentHealth[Handle] + Amount, 0.0f, MaxHealth[Handle]);
+    }
+}
+
+void UCharacterHealthSubsystem::StartInvincibility(int32 Handle)
+{
+    if (!IsInvincible(Handle))
+    {
+        InvincibleUntil[Handle] = GetWorld()->GetTimeSeconds() + InvincibilityDuration[Handle];
+    }
+}
+
+void UCharacterHealthSubsystem::Revive(int32 Handle)
+{
+    CurrentHealth[Handle] = MaxHealth[Handle];
+    PendingDamage[Handle] = 0.0f;
+    PendingHeal[Handle] = 0.0f;
+    InvincibleUntil[Handle] = 0.0;
+    StateFlags[Handle] &= static_cast<uint8>(~EStateFlags::Dead);
+}
+
+void UCharacterHealthSubsystem::SetReplicatedHealth(int32 Handle, float Health, bool bDead)
+{
+    CurrentHealth[Handle] = FMath::Clamp(Health, 0.0f, MaxHealth[Handle]);
+    PendingDamage[Handle] = 0.0f;
+    PendingHeal[Handle] = 0.0f;
+    if (bDead)
+    {
+        StateFlags[Handle] |= EStateFlags::Dead;
+    }
+    else
+    {
+        StateFlags[Handle] &= static_cast<uint8>(~EStateFlags::Dead);
+    }
+}
+
+void UCharacterHealthSubsystem::MarkChanged(int32 Handle)
+{
+    if (!(StateFlags[Handle] & EStateFlags::Changed))
+    {
+        StateFlags[Handle] |= EStateFlags::Changed;
+        ChangedHandles.Add(Handle);
+    }
+}
+
+void UCharacterHealthSubsystem::Tick(float DeltaTime)
+{
+    RunHealthPasses(DeltaTime);
+
+    // 批次通知也可能產生合併請求，因此在其後送出
+    FlushHealthNotifications();
+}
+
+void UCharacterHealthSubsystem::RequestHealthNotification(int32 Handle)
+{
+    if (!IsValidHandle(Handle))
+    {
+        return;
+    }
+
+    ++NotifyStats.Requested;
+    INC_DWORD_STAT(STAT_HealthNotifyRequested);
+
+    if (StateFlags[Handle] & EStateFlags::NotifyPending)
+    {
+        // 已在等待中：廣播時會讀取最新的生命值，這次請求直接合併
+        ++NotifyStats.Suppressed;
+        INC_DWORD_STAT(STAT_HealthNotifySuppressed);
+        return;
+    }
+
+    StateFlags[Handle] |= EStateFlags::NotifyPending;
+    PendingNotifyHandles.Add(Handle);
+}
+
+// ====================================================================
+// >>> 送出合併的廣播 <<<
+// 畫面內的角色每幀最多一次；畫面外的角色在距離上次廣播未滿 1 / OffscreenNotifyRate 秒時保留到之後的幀。
+// 廣播的回呼可能再次請求通知 (例如藍圖在事件中補血)，因此先把旗標清除，新的請求會進入下一幀。
+// ====================================================================
+void UCharacterHealthSubsystem::FlushHealthNotifications()
+{
+    if (PendingNotifyHandles.Num() == 0)
+    {
+        SET_DWORD_STAT(STAT_HealthNotifyPending, 0);
+        return;
+    }
+
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_HealthNotifyFlush);
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    const double OffscreenInterval = HealthNotify::OffscreenNotifyRate > 0.0f ? 1.0 / HealthNotify::OffscreenNotifyRate : 0.0;
+
+    TArray<ACharacterBase*, TInlineAllocator<64>> ToBroadcast;
+    int32 NumKept = 0;
+    for (int32 Index = 0; Index < PendingNotifyHandles.Num(); ++Index)
+    {
+        const int32 Handle = PendingNotifyHandles[Index];
+        if (!(StateFlags[Handle] & EStateFlags::NotifyPending))
+        {
+            continue; // 已移除登錄的槽位
+        }
+
+        ACharacterBase* Character = Characters[Handle].Get();
+        if (!Character)
+        {
+            StateFlags[Handle] &= static_cast<uint8>(~EStateFlags::NotifyPending);
+            continue;
+        }
+
+        const bool bOnScreen = Character->WasRecentlyRendered(HealthNotify::RecentlyRenderedTolerance);
+        if (!bOnScreen && Now - LastNotifyTime[Handle] < OffscreenInterval)
+        {
+            PendingNotifyHandles[NumKept++] = Handle; // 保留到下一幀
+            continue;
+        }
+
+        StateFlags[Handle] &= static_cast<uint8>(~EStateFlags::NotifyPending);
+        LastNotifyTime[Handle] = Now;
+        ToBroadcast.Add(Character);
+    }
+    PendingNotifyHandles.SetNum(NumKept, EAllowShrinking::No);
+
+    NotifyStats.Sent += ToBroadcast.Num();
+    INC_DWORD_STAT_BY(STAT_HealthNotifySent, ToBroadcast.Num());
+    SET_DWORD_STAT(STAT_HealthNotifyPending, PendingNotifyHandles.Num());
+
+    for (ACharacterBase* Character : ToBroadcast)
+    {
+        Character->BroadcastHealthChanged();
+    }
+}
+
+// ====================================================================
+// >>> 批次處理 <<<
+// 每個階段都是對緊密陣列的一次線性掃描；死亡與未登錄的槽位以旗標略過。
+// 順序與逐次呼叫一致：先治療與回復，再扣血 (受無敵時間限制)，最後偵測死亡。
+// ====================================================================
+void UCharacterHealthSubsystem::RunHealthPasses(float DeltaTime, bool bNotifyCharacters, double TimeOverride)
+{
+    {
+        CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_HealthPasses);
+
+        const int32 NumSlots = StateFlags.Num();
+        const double Now = TimeOverride >= 0.0 ? TimeOverride : GetWorld()->GetTimeSeconds();
+        constexpr uint8 SkipMask = EStateFlags::Dead;
+
+        // 治療與回復
+        for (int32 Index = 0; Index < NumSlots; ++Index)
+        {
+            const float Amount = PendingHeal[Index] + RegenPerSecond[Index] * DeltaTime;
+            PendingHeal[Index] = 0.0f;
+            if (Amount > 0.0f && !(StateFlags[Index] & SkipMask) && CurrentHealth[Index] < MaxHealth[Index])
+            {
+                CurrentHealth[Index] = FMath::Min(CurrentHealth[Index] + Amount, MaxHealth[Index]);
+                MarkChanged(Index);
+            }
+        }
+
+        // 扣血與無敵時間
+        for (int32 Index = 0; Index < NumSlots; ++Index)
+        {
+            const float Amount = PendingDamage[Index];
+            if (Amount <= 0.0f)
+            {
+                continue;
+            }
+            PendingDamage[Index] = 0.0f;
+
+            if (!(StateFlags[Index] & SkipMask) && Now >= InvincibleUntil[Index])
+            {
+                CurrentHealth[Index] = FMath::Max(CurrentHealth[Index] - Amount, 0.0f);
+                InvincibleUntil[Index] = Now + InvincibilityDuration[Index];
+                MarkChanged(Index);
+            }
+        }
+
+        // 死亡偵測
+        for (int32 Index = 0; Index < NumSlots; ++Index)
+        {
+            if ((StateFlags[Index] & (EStateFlags::Registered | EStateFlags::Dead)) == EStateFlags::Registered && CurrentHealth[Index] <= 0.0f)
+            {
+                StateFlags[Index] |= EStateFlags::Dead | EStateFlags::JustDied;
+                MarkChanged(Index);
+            }
+        }
+    }
+
+    INC_DWORD_STAT_BY(STAT_HealthChanged, ChangedHandles.Num());
+
+    // 只通知有變化的角色 (廣播與藍圖事件仍在遊戲執行緒上逐一執行)
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_HealthNotify);
+    for (const int32 Handle : ChangedHandles)
+    {
+        const bool bDied = (StateFlags[Handle] & EStateFlags::JustDied) != 0;
+        StateFlags[Handle] &= static_cast<uint8>(~(EStateFlags::Changed | EStateFlags::JustDied));
+        if (bNotifyCharacters)
+        {
+            if (ACharacterBase* Character = Characters[Handle].Get())
+            {
+                Character->HandleBatchedHealthChange(bDied);
+            }
+        }
+    }
+    ChangedHandles.Reset();
+}
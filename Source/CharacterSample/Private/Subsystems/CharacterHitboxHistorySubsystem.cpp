@@ -0,0 +1,292 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CharacterHitboxHistorySubsystem.h"
+#include "Core/CharacterBase.h"
+#include "Core/CrowdBenchmarkUtils.h" // 用於效能測試時生成群眾
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Hitbox History Record"), STAT_HitboxHistoryRecord, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitbox History Characters"), STAT_HitboxHistoryCharacters, STATGROUP_CharacterSample);
+
+// ====================================================================
+// >>> 控制台指令：命中框歷史的記憶體與回溯查詢成本 <<<
+// 用法：CharacterSample.HitboxHistory.Benchmark [角色數量，預設 1000] [查詢次數，預設 100000]
+// ====================================================================
+static void RunHitboxHistoryBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    UCharacterHitboxHistorySubsystem* HistorySubsystem = World ? World->GetSubsystem<UCharacterHitboxHistorySubsystem>() : nullptr;
+    if (!HistorySubsystem)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("HitboxHistory Benchmark: CharacterHitboxHistorySubsystem is not available in this world."));
+        return;
+    }
+
+    const int32 CrowdSize = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+    const int32 NumQueries = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100000;
+    constexpr double FrameInterval = 1.0 / 60.0;
+    constexpr int32 NumFrames = UCharacterHitboxHistorySubsystem::HistoryCapacity * 4; // 讓環形緩衝區繞回數次
+
+    FRandomStream RandomStream(CrowdSize);
+    TArray<ACharacterBase*> Crowd = CrowdBenchmark::SpawnCrowd(World, CrowdSize, FVector(0.0f, 0.0f, 10000.0f), 300.0f, RandomStream);
+
+    TArray<int32> Handles;
+    Handles.Reserve(Crowd.Num());
+    for (const ACharacterBase* Character : Crowd)
+    {
+        if (HistorySubsystem->IsValidHandle(Character->GetHitboxHistoryHandle()))
+        {
+            Handles.Add(Character->GetHitboxHistoryHandle());
+        }
+    }
+    if (Handles.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("HitboxHistory Benchmark: no characters were registered (history is recorded on the server only)."));
+        CrowdBenchmark::DestroyCrowd(Crowd);
+        return;
+    }
+
+    // 以獨立的時間軸記錄，結束後清除，不影響遊戲中的歷史
+    HistorySubsystem->ResetHistory();
+
+    const double RecordStartTime = FPlatformTime::Seconds();
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        HistorySubsystem->RecordFrame(Frame * FrameInterval);
+    }
+    const double RecordSeconds = FPlatformTime::Seconds() - RecordStartTime;
+    const SIZE_T AllocatedSize = HistorySubsystem->GetAllocatedSize();
+
+    double Oldest = 0.0;
+    double Newest = 0.0;
+    HistorySubsystem->GetHistoryTimeRange(Oldest, Newest);
+
+    // 預先產生查詢，讓計時只包含回溯本身
+    TArray<TPair<int32, double>> Queries;
+    Queries.SetNumUninitialized(NumQueries);
+    for (TPair<int32, double>& Query : Queries)
+    {
+        Query.Key = Handles[RandomStream.RandHelper(Handles.Num())];
+        Query.Value = FMath::Lerp(Oldest, Newest, static_cast<double>(RandomStream.FRand()));
+    }
+
+    FVector Accumulated = FVector::ZeroVector; // 避免查詢被最佳化掉
+    const double QueryStartTime = FPlatformTime::Seconds();
+    for (const TPair<int32, double>& Query : Queries)
+    {
+        FVector Location;
+        if (HistorySubsystem->GetLocationAtTime(Query.Key, Query.Value, Location))
+        {
+            Accumulated += Location;
+        }
+    }
+    const double QuerySeconds = FPlatformTime::Seconds() - QueryStartTime;
+
+    UE_LOG(LogTemp, Log, TEXT("HitboxHistory Benchmark [%d characters, %d frames, %d queries]: %.1f bytes/character (%d frames x %d bytes) | Record %.3f us/frame | Rewind %.1f ns/query (checksum %.1f)"),
+        Handles.Num(), NumFrames, NumQueries,
+        static_cast<double>(AllocatedSize) / HistorySubsystem->GetNumRegistered(),
+        UCharacterHitboxHistorySubsystem::HistoryCapacity, static_cast<int32>(sizeof(FVector3f)),
+        RecordSeconds * 1e6 / NumFrames,
+        QuerySeconds * 1e9 / NumQueries,
+        Accumulated.X);
+
+    HistorySubsystem->ResetHistory();
+    CrowdBenchmark::DestroyCrowd(Crowd);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GHitboxHistoryBenchmarkCommand(
+    TEXT("CharacterSample.HitboxHistory.Benchmark"),
+    TEXT("量測命中框歷史每個角色的記憶體、每幀記錄成本與回溯查詢成本。參數：[角色數量] [查詢次數]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunHitboxHistoryBenchmark));
+
+// ====================================================================
+// >>> UCharacterHitboxHistorySubsystem 實作 <<<
+// ====================================================================
+
+bool UCharacterHitboxHistorySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacterHitboxHistorySubsystem::Deinitialize()
+{
+    FrameTimes.Empty();
+    Locations.Empty();
+    RegisteredSerials.Empty();
+    Characters.Empty();
+    FreeList.Empty();
+    NumRegistered = 0;
+    NextFrameSerial = 0;
+    HistoryStartSerial = 0;
+
+    Super::Deinitialize();
+}
+
+TStatId UCharacterHitboxHistorySubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacterHitboxHistorySubsystem, STATGROUP_Tickables);
+}
+
+int32 UCharacterHitboxHistorySubsystem::RegisterCharacter(ACharacterBase* Character)
+{
+    if (!Character)
+    {
+        return INDEX_NONE;
+    }
+
+    if (FrameTimes.Num() == 0)
+    {
+        FrameTimes.SetNumZeroed(HistoryCapacity);
+    }
+
+    int32 Handle;
+    if (FreeList.Num() > 0)
+    {
+        Handle = FreeList.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        // 一次配置整段歷史，之後的記錄不會再配置
+        Handle = Characters.AddDefaulted();
+        RegisteredSerials.AddUninitialized();
+        Locations.AddUninitialized(HistoryCapacity);
+    }
+
+    Characters[Handle] = Character;
+    RegisteredSerials[Handle] = NextFrameSerial;
+
+    ++NumRegistered;
+    return Handle;
+}
+
+void UCharacterHitboxHistorySubsystem::UnregisterCharacter(int32 Handle)
+{
+    if (!IsValidHandle(Handle))
+    {
+        return;
+    }
+
+    Characters[Handle] = nullptr;
+    FreeList.Add(Handle);
+    --NumRegistered;
+}
+
+void UCharacterHitboxHistorySubsystem::Tick(float DeltaTime)
+{
+    // 只有伺服器 (與單機) 需要回溯；客戶端的角色本來就不會登錄
+    if (NumRegistered > 0)
+    {
+        RecordFrame(GetWorld()->GetTimeSeconds());
+    }
+}
+
+void UCharacterHitboxHistorySubsystem::RecordFrame(double Time)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_HitboxHistoryRecord);
+    SET_DWORD_STAT(STAT_HitboxHistoryCharacters, NumRegistered);
+
+    if (FrameTimes.Num() == 0)
+    {
+        return;
+    }
+
+    const int32 FrameIndex = static_cast<int32>(NextFrameSerial & HistoryMask);
+    FrameTimes[FrameIndex] = Time;
+
+    // 槽位連續存放，逐槽位跳 HistoryCapacity 寫入同一個幀索引
+    FVector3f* Slot = Locations.GetData() + FrameIndex;
+    for (int32 Handle = 0; Handle < Characters.Num(); ++Handle, Slot += HistoryCapacity)
+    {
+        if (const ACharacterBase* Character = Characters[Handle])
+        {
+            *Slot = FVector3f(Character->GetActorLocation());
+        }
+    }
+
+    ++NextFrameSerial;
+}
+
+uint64 UCharacterHitboxHistorySubsystem::GetFirstValidSerial(int32 Handle) const
+{
+    const uint64 OldestInRing = NextFrameSerial > static_cast<uint64>(HistoryCapacity) ? NextFrameSerial - HistoryCapacity : 0;
+    return FMath::Max3(OldestInRing, HistoryStartSerial, RegisteredSerials[Handle]);
+}
+
+bool UCharacterHitboxHistorySubsystem::GetHistoryTimeRange(double& OutOldest, double& OutNewest) const
+{
+    const uint64 OldestInRing = NextFrameSerial > static_cast<uint64>(HistoryCapacity) ? NextFrameSerial - HistoryCapacity : 0;
+    const uint64 First = FMath::Max(OldestInRing, HistoryStartSerial);
+    if (NextFrameSerial <= First)
+    {
+        return false;
+    }
+
+    OutOldest = FrameTimes[First & HistoryMask];
+    OutNewest = FrameTimes[(NextFrameSerial - 1) & HistoryMask];
+    return true;
+}
+
+// ====================================================================
+// >>> 回溯查詢 <<<
+// 在角色可用的幀序號範圍內以二分搜尋找到夾住 Time 的兩幀，再線性插值
+// ====================================================================
+bool UCharacterHitboxHistorySubsystem::GetLocationAtTime(int32 Handle, double Time, FVector& OutLocation) const
+{
+    if (!IsValidHandle(Handle))
+    {
+        return false;
+    }
+
+    uint64 Low = GetFirstValidSerial(Handle);
+    uint64 High = NextFrameSerial - 1;
+    if (NextFrameSerial <= Low)
+    {
+        return false;
+    }
+
+    const FVector3f* Slot = Locations.GetData() + Handle * HistoryCapacity;
+
+    if (Time <= FrameTimes[Low & HistoryMask])
+    {
+        OutLocation = FVector(Slot[Low & HistoryMask]);
+        return true;
+    }
+    if (Time >= FrameTimes[High & HistoryMask])
+    {
+        OutLocation = FVector(Slot[High & HistoryMask]);
+        return true;
+    }
+
+    // 不變式：Time(Low) < Time <= ... < Time(High)
+    while (High - Low > 1)
+    {
+        const uint64 Mid = Low + (High - Low) / 2;
+        if (FrameTimes[Mid & HistoryMask] <= Time)
+        {
+            Low = Mid;
+        }
+        else
+        {
+            High = Mid;
+        }
+    }
+
+    const double LowTime = FrameTimes[Low & HistoryMask];
+    const double HighTime = FrameTimes[High & HistoryMask];
+    const float Alpha = HighTime > LowTime ? static_cast<float>((Time - LowTime) / (HighTime - LowTime)) : 0.0f;
+    OutLocation = FVector(FMath::Lerp(Slot[Low & HistoryMask], Slot[High & HistoryMask], Alpha));
+    return true;
+}
+
+void UCharacterHitboxHistorySubsystem::ResetHistory()
+{
+    HistoryStartSerial = NextFrameSerial;
+}
+
+SIZE_T UCharacterHitboxHistorySubsystem::GetAllocatedSize() const
+{
+    return FrameTimes.GetAllocatedSize() + Locations.GetAllocatedSize() + RegisteredSerials.GetAllocatedSize()
+        + Characters.GetAllocatedSize() + FreeList.GetAllocatedSize();
+}
@@ -0,0 +1,280 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/CharacterPoolSubsystem.h"
+#include "Core/CharacterBase.h"
+#include "Core/CrowdBenchmarkUtils.h" // 基準測試的群眾範圍
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Character Pool Acquire"), STAT_CharacterPoolAcquire, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Character Pool Release"), STAT_CharacterPoolRelease, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Character Pool Misses"), STAT_CharacterPoolMisses, STATGROUP_CharacterSample);
+
+namespace CharacterPool
+{
+    // 池中角色的存放位置：遠在地圖下方，移動已停用所以不會觸發 KillZ
+    static const FVector StashLocation(0.0f, 0.0f, -100000.0f);
+}
+
+bool UCharacterPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCharacterPoolSubsystem::Deinitialize()
+{
+    // 池中的角色屬於關卡，隨世界一起銷毀
+    Buckets.Reset();
+
+    Super::Deinitialize();
+}
+
+ACharacterBase* UCharacterPoolSubsystem::SpawnPooledCharacter(UClass* CharacterClass, FCharacterPoolBucket& Bucket)
+{
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn; // 池中的角色疊在同一點
+
+    ACharacterBase* Character = GetWorld()->SpawnActor<ACharacterBase>(CharacterClass, FTransform(CharacterPool::StashLocation), SpawnParams);
+    if (Character)
+    {
+        ++Bucket.NumCreated;
+        Character->OnReleasedToPool();
+        Bucket.Available.Add(Character);
+    }
+    return Character;
+}
+
+int32 UCharacterPoolSubsystem::Prewarm(TSubclassOf<ACharacterBase> CharacterClass, int32 Count)
+{
+    UWorld* World = GetWorld();
+    if (!CharacterClass || Count <= 0 || !World)
+    {
+        return 0;
+    }
+
+    // 世界開始遊戲前生成的角色會延後 BeginPlay，停用會在子系統登錄之前發生
+    if (!World->HasBegunPlay())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("CharacterPool: cannot prewarm %s before the world has begun play."), *CharacterClass->GetName());
+        return 0;
+    }
+    if (World->GetNetMode() == NM_Client)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("CharacterPool: characters are spawned by the server; prewarming on a client is ignored."));
+        return 0;
+    }
+
+    FCharacterPoolBucket& Bucket = Buckets.FindOrAdd(CharacterClass.Get());
+    Bucket.Available.RemoveAll([](const ACharacterBase* Character) { return !IsValid(Character); });
+
+    int32 NumSpawned = 0;
+    while (Bucket.Available.Num() < Count)
+    {
+        if (!SpawnPooledCharacter(CharacterClass, Bucket))
+        {
+            break;
+        }
+        ++NumSpawned;
+    }
+    return NumSpawned;
+}
+
+ACharacterBase* UCharacterPoolSubsystem::AcquireCharacter(TSubclassOf<ACharacterBase> CharacterClass, const FTransform& SpawnTransform)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CharacterPoolAcquire);
+
+    if (!CharacterClass)
+    {
+        return nullptr;
+    }
+
+    FCharacterPoolBucket& Bucket = Buckets.FindOrAdd(CharacterClass.Get());
+    while (Bucket.Available.Num() > 0)
+    {
+        ACharacterBase* Character = Bucket.Available.Pop(EAllowShrinking::No);
+        if (IsValid(Character))
+        {
+            Character->OnAcquiredFromPool(SpawnTransform);
+            return Character;
+        }
+    }
+
+    // 池空了：退回一般生成 (等同沒有池時的成本)，stat 與 DumpStats 會顯示預熱數量不足
+    INC_DWORD_STAT(STAT_CharacterPoolMisses);
+    ++Bucket.NumMisses;
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+    ACharacterBase* Character = GetWorld()->SpawnActor<ACharacterBase>(CharacterClass, SpawnTransform, SpawnParams);
+    if (Character)
+    {
+        ++Bucket.NumCreated;
+    }
+    return Character;
+}
+
+void UCharacterPoolSubsystem::ReleaseCharacter(ACharacterBase* Character)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CharacterPoolRelease);
+
+    if (!IsValid(Character) || Character->IsInPool())
+    {
+        return;
+    }
+    if (Character->IsPlayerControlled())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("CharacterPool: %s is controlled by a player and cannot be released to the pool."), *Character->GetName());
+        return;
+    }
+
+    // AI 控制器保持擁有 (重用時不需要重新生成控制器)，只停止它發出的移動
+    if (AController* Controller = Character->GetController())
+    {
+        Controller->StopMovement();
+    }
+
+    Character->OnReleasedToPool();
+    Character->SetActorLocation(CharacterPool::StashLocation, false, nullptr, ETeleportType::ResetPhysics);
+
+    // 不是由池生成的角色也可以放回，之後同樣能被取出
+    Buckets.FindOrAdd(Character->GetClass()).Available.Add(Character);
+}
+
+int32 UCharacterPoolSubsystem::GetNumAvailable(TSubclassOf<ACharacterBase> CharacterClass) const
+{
+    const FCharacterPoolBucket* Bucket = Buckets.Find(CharacterClass.Get());
+    return Bucket ? Bucket->Available.Num() : 0;
+}
+
+void UCharacterPoolSubsystem::DumpStats() const
+{
+    UE_LOG(LogTemp, Log, TEXT("CharacterPool: %d classes"), Buckets.Num());
+    for (const TPair<UClass*, FCharacterPoolBucket>& Pair : Buckets)
+    {
+        UE_LOG(LogTemp, Log, TEXT("  %-40s available %4d | created %4d | misses %4d"),
+            *GetNameSafe(Pair.Key), Pair.Value.Available.Num(), Pair.Value.NumCreated, Pair.Value.NumMisses);
+    }
+}
+
+// ====================================================================
+// >>> 控制台指令：池的狀態 <<<
+// 用法：CharacterSample.Pool.Stats
+// ====================================================================
+static void DumpCharacterPoolStats(const TArray<FString>& Args, UWorld* World)
+{
+    if (const UCharacterPoolSubsystem* PoolSubsystem = World ? World->GetSubsystem<UCharacterPoolSubsystem>() : nullptr)
+    {
+        PoolSubsystem->DumpStats();
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GCharacterPoolStatsCommand(
+    TEXT("CharacterSample.Pool.Stats"),
+    TEXT("輸出角色池每個類別的可用數量、生成總數與未命中次數。"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&DumpCharacterPoolStats));
+
+// ====================================================================
+// >>> 控制台指令：生成 / 銷毀與池取出 / 放回的成本比較 <<<
+// 用法 (在伺服器或單機上執行)：CharacterSample.Pool.Benchmark [角色數量，預設 100] [角色類別路徑，預設為 GameMode 的 DefaultPawnClass]
+// 兩條路徑把同一批角色放到相同位置：一條以 SpawnActor 生成再 Destroy，另一條以預熱過的池取出再放回。
+// 預熱的時間另外列出，這部分在地圖載入期間支付，不計入遊戲中的一波。
+// ====================================================================
+static void RunCharacterPoolBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    UCharacterPoolSubsystem* PoolSubsystem = World ? World->GetSubsystem<UCharacterPoolSubsystem>() : nullptr;
+    const AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+    if (!PoolSubsystem || !GameMode)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Pool Benchmark: must be run on a server or standalone game world."));
+        return;
+    }
+
+    const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+    UClass* CharacterClass = Args.Num() > 1 ? LoadClass<ACharacterBase>(nullptr, *Args[1]) : GameMode->DefaultPawnClass.Get();
+    if (!CharacterClass || !CharacterClass->IsChildOf<ACharacterBase>())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Pool Benchmark: %s is not an ACharacterBase class."), Args.Num() > 1 ? *Args[1] : *GetNameSafe(CharacterClass));
+        return;
+    }
+
+    // 在第一個玩家前方 (或世界原點) 排出一群位置，兩條路徑使用相同的位置
+    FVector Center = FVector::ZeroVector;
+    if (const APlayerController* PlayerController = World->GetFirstPlayerController())
+    {
+        if (const APawn* PlayerPawn = PlayerController->GetPawn())
+        {
+            Center = PlayerPawn->GetActorLocation() + PlayerPawn->GetActorForwardVector() * 1000.0f;
+        }
+    }
+    FRandomStream RandomStream(12345);
+    const float HalfExtent = CrowdBenchmark::GetCrowdHalfExtent(Count, 200.0f);
+    TArray<FTransform> Transforms;
+    Transforms.Reserve(Count);
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        Transforms.Emplace(FVector(Center.X + RandomStream.FRandRange(-HalfExtent, HalfExtent), Center.Y + RandomStream.FRandRange(-HalfExtent, HalfExtent), Center.Z));
+    }
+
+    TArray<ACharacterBase*> Characters;
+    Characters.Reserve(Count);
+
+    // --- 沒有池：SpawnActor / Destroy ---
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    double StartTime = FPlatformTime::Seconds();
+    for (const FTransform& Transform : Transforms)
+    {
+        if (ACharacterBase* Character = World->SpawnActor<ACharacterBase>(CharacterClass, Transform, SpawnParams))
+        {
+            Characters.Add(Character);
+        }
+    }
+    const double SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+    StartTime = FPlatformTime::Seconds();
+    for (ACharacterBase* Character : Characters)
+    {
+        Character->Destroy();
+    }
+    const double DestroyMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    Characters.Reset();
+
+    // --- 池：預熱 (載入期間) 後取出 / 放回 ---
+    StartTime = FPlatformTime::Seconds();
+    PoolSubsystem->Prewarm(CharacterClass, Count);
+    const double PrewarmMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+    StartTime = FPlatformTime::Seconds();
+    for (const FTransform& Transform : Transforms)
+    {
+        if (ACharacterBase* Character = PoolSubsystem->AcquireCharacter(CharacterClass, Transform))
+        {
+            Characters.Add(Character);
+        }
+    }
+    const double AcquireMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+    StartTime = FPlatformTime::Seconds();
+    for (ACharacterBase* Character : Characters)
+    {
+        PoolSubsystem->ReleaseCharacter(Character);
+    }
+    const double ReleaseMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+    const double PerCharacter = 1.0 / Count;
+    UE_LOG(LogTemp, Log, TEXT("Pool Benchmark [%s x %d]"), *CharacterClass->GetName(), Count);
+    UE_LOG(LogTemp, Log, TEXT("  spawn   %8.2f ms (%.3f ms each) | destroy %8.2f ms (%.3f ms each)"), SpawnMs, SpawnMs * PerCharacter, DestroyMs, DestroyMs * PerCharacter);
+    UE_LOG(LogTemp, Log, TEXT("  acquire %8.2f ms (%.3f ms each) | release %8.2f ms (%.3f ms each)"), AcquireMs, AcquireMs * PerCharacter, ReleaseMs, ReleaseMs * PerCharacter);
+    UE_LOG(LogTemp, Log, TEXT("  prewarm %8.2f ms (paid during loading) | wave speedup %.1fx"),
+        PrewarmMs, (SpawnMs + DestroyMs) / FMath::Max(AcquireMs + ReleaseMs, UE_SMALL_NUMBER));
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GCharacterPoolBenchmarkCommand(
+    TEXT("CharacterSample.Pool.Benchmark"),
+    TEXT("比較 SpawnActor / Destroy 與角色池取出 / 放回的成本。參數：[角色數量] [角色類別路徑]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunCharacterPoolBenchmark));
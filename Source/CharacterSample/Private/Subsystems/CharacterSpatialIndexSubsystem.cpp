@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CharacterSpatialIndexSubsystem.h"
+#include "Core/CharacterBase.h"
+#include "Core/CrowdBenchmarkUtils.h" // 用於效能測試時生成群眾
+#include "Components/CapsuleComponent.h" // 讀取膠囊體尺寸
+#include "Engine/World.h" // 用於物理掃掠對照組
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+
+// ====================================================================
+// >>> 控制台指令：空間索引與物理掃掠的效能比較 <<<
+// 用法：CharacterSample.SpatialIndex.Benchmark [每組查詢次數，預設 1000]
+// 依序以 100、1k、10k 個角色，比較原本的 Pawn 球體掃掠與空間索引線段查詢
+// ====================================================================
+static void RunSpatialIndexBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    UCharacterSpatialIndexSubsystem* SpatialIndex = World ? World->GetSubsystem<UCharacterSpatialIndexSubsystem>() : nullptr;
+    if (!SpatialIndex)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("SpatialIndex Benchmark: CharacterSpatialIndexSubsystem is not available in this world."));
+        return;
+    }
+
+    const int32 NumQueries = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+    const float Spacing = 300.0f;      // 角色平均間距
+    const float SweepRadius = 70.0f;   // 與 PerformNormalAttackHitCheck 相同的攻擊形狀
+    const float SweepLength = 150.0f;
+    const FVector Center(0.0f, 0.0f, 10000.0f); // 遠離關卡幾何，只量測 Pawn
+
+    const int32 CrowdSizes[] = { 100, 1000, 10000 };
+    for (const int32 CrowdSize : CrowdSizes)
+    {
+        FRandomStream RandomStream(CrowdSize);
+        TArray<ACharacterBase*> Crowd = CrowdBenchmark::SpawnCrowd(World, CrowdSize, Center, Spacing, RandomStream);
+        const float HalfExtent = CrowdBenchmark::GetCrowdHalfExtent(CrowdSize, Spacing);
+
+        // 預先產生相同的查詢，讓兩條路徑處理完全一樣的輸入
+        TArray<FVector> Starts;
+        TArray<FVector> Ends;
+        Starts.Reserve(NumQueries);
+        Ends.Reserve(NumQueries);
+        for (int32 Index = 0; Index < NumQueries; ++Index)
+        {
+            const FVector Start = Center + FVector(RandomStream.FRandRange(-HalfExtent, HalfExtent), RandomStream.FRandRange(-HalfExtent, HalfExtent), 0.0f);
+            const FVector Direction = FRotator(0.0f, RandomStream.FRandRange(0.0f, 360.0f), 0.0f).Vector();
+            Starts.Add(Start);
+            Ends.Add(Start + Direction * SweepLength);
+        }
+
+        // --- 對照組：原本的物理掃掠 ---
+        int64 TraceHits = 0;
+        TArray<FHitResult> HitResults;
+        const FCollisionObjectQueryParams ObjectQueryParams(ECC_Pawn);
+        const FCollisionShape Sphere = FCollisionShape::MakeSphere(SweepRadius);
+        const double TraceStartTime = FPlatformTime::Seconds();
+        for (int32 Index = 0; Index < NumQueries; ++Index)
+        {
+            HitResults.Reset();
+            World->SweepMultiByObjectType(HitResults, Starts[Index], Ends[Index], FQuat::Identity, ObjectQueryParams, Sphere);
+            TraceHits += HitResults.Num();
+        }
+        const double TraceSeconds = FPlatformTime::Seconds() - TraceStartTime;
+
+        // --- 空間索引 ---
+        int64 IndexCandidates = 0;
+        TArray<ACharacterBase*> Candidates;
+        const double IndexStartTime = FPlatformTime::Seconds();
+        for (int32 Index = 0; Index < NumQueries; ++Index)
+        {
+            Candidates.Reset();
+            SpatialIndex->QuerySegment(Starts[Index], Ends[Index], SweepRadius, Candidates);
+            IndexCandidates += Candidates.Num();
+        }
+        const double IndexSeconds = FPlatformTime::Seconds() - IndexStartTime;
+
+        UE_LOG(LogTemp, Log, TEXT("SpatialIndex Benchmark [%5d characters, %d queries]: Trace %.3f us/query (%lld hits) | Index %.3f us/query (%lld candidates) | Speedup x%.1f"),
+            Crowd.Num(), NumQueries,
+            TraceSeconds * 1e6 / NumQueries, TraceHits,
+            IndexSeconds * 1e6 / NumQueries, IndexCandidates,
+            IndexSeconds > 0.0 ? TraceSeconds / IndexSeconds : 0.0);
+
+        CrowdBenchmark::DestroyCrowd(Crowd);
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GCharacterSpatialIndexBenchmarkCommand(
+    TEXT("CharacterSample.SpatialIndex.Benchmark"),
+    TEXT("以 100 / 1k / 10k 個角色比較物理掃掠與空間索引查詢的成本。參數：[每組查詢次數]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunSpatialIndexBenchmark));
+
+// ====================================================================
+// >>> UCharacterSpatialIndexSubsystem 實作 <<<
+// ====================================================================
+
+UCharacterSpatialIndexSubsystem::UCharacterSpatialIndexSubsystem()
+    : SpatialHash(500.0f) // 格子大小約為攻擊範圍的兩倍，單次攻擊通常只需檢查 2x2 ~ 3x3 個格子
+{
+}
+
+bool UCharacterSpatialIndexSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UCharacterSpatialIndexSubsystem::RegisterCharacter(ACharacterBase* Character)
+{
+    if (!Character)
+    {
+        return INDEX_NONE;
+    }
+
+    float Radius = 0.0f;
+    float HalfHeight = 0.0f;
+    if (UCapsuleComponent* Capsule = Character->GetCapsuleComponent())
+    {
+        Capsule->GetScaledCapsuleSize(Radius, HalfHeight);
+    }
+
+    return SpatialHash.Add(Character, Character->GetActorLocation(), Radius, HalfHeight);
+}
+
+void UCharacterSpatialIndexSubsystem::UnregisterCharacter(int32 Handle)
+{
+    if (Handle != INDEX_NONE)
+    {
+        SpatialHash.Remove(Handle);
+    }
+}
+
+void UCharacterSpatialIndexSubsystem::UpdateCharacter(int32 Handle, ACharacterBase* Character)
+{
+    if (Handle == INDEX_NONE || !Character)
+    {
+        return;
+    }
+
+    SpatialHash.Update(Handle, Character->GetActorLocation());
+}
+
+void UCharacterSpatialIndexSubsystem::UpdateCharacterShape(int32 Handle, ACharacterBase* Character)
+{
+    UCapsuleComponent* Capsule = Character ? Character->GetCapsuleComponent() : nullptr;
+    if (Handle == INDEX_NONE || !Capsule)
+    {
+        return;
+    }
+
+    float Radius = 0.0f;
+    float HalfHeight = 0.0f;
+    Capsule->GetScaledCapsuleSize(Radius, HalfHeight);
+    SpatialHash.UpdateShape(Handle, Radius, HalfHeight);
+}
+
+TArray<ACharacterBase*> UCharacterSpatialIndexSubsystem::GetCharactersInRadius(FVector Center, float Radius) const
+{
+    TArray<ACharacterBase*> Characters;
+    SpatialHash.QueryRadius(Center, Radius, Characters);
+    return Characters;
+}
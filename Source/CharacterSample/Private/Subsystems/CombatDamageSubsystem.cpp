@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CombatDamageSubsystem.h"
+#include "Core/CharacterBase.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Combat Damage Apply"), STAT_CombatDamageApply, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Damage Hits"), STAT_CombatDamageHits, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Damage Targets"), STAT_CombatDamageTargets, STATGROUP_CharacterSample);
+
+// ====================================================================
+// >>> 控制台指令：輸出傷害管線統計 <<<
+// 用法：CharacterSample.Damage.Stats
+// ====================================================================
+static FAutoConsoleCommandWithWorld GCombatDamageStatsCommand(
+    TEXT("CharacterSample.Damage.Stats"),
+    TEXT("輸出 CombatDamageSubsystem 的每幀命中數、合併後的目標數與成本。"),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+    {
+        if (UCombatDamageSubsystem* Subsystem = World ? World->GetSubsystem<UCombatDamageSubsystem>() : nullptr)
+        {
+            Subsystem->LogStats();
+        }
+    }));
+
+bool UCombatDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // 只在實際遊戲世界中運作 (包含 PIE)，編輯器預覽世界不需要
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatDamageSubsystem::Deinitialize()
+{
+    // 世界關閉時丟棄所有尚未套用的傷害
+    PendingDamage.Empty();
+    ScratchMerged.Reset();
+    ScratchTargetToIndex.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UCombatDamageSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDamageSubsystem, STATGROUP_Tickables);
+}
+
+// ====================================================================
+// >>> 提交傷害 <<<
+// 只寫入佇列，不觸碰目標的任何狀態，因此可以從任何執行緒呼叫
+// ====================================================================
+void UCombatDamageSubsystem::SubmitDamage(ACharacterBase* Target, float Damage, AController* EventInstigator, AActor* DamageCauser)
+{
+    if (!Target || Damage <= 0.0f)
+    {
+        return;
+    }
+
+    FCombatDamageSubmission Submission;
+    Submission.Target = Target;
+    Submission.Damage = Damage;
+    Submission.EventInstigator = EventInstigator;
+    Submission.DamageCauser = DamageCauser;
+    PendingDamage.Enqueue(MoveTemp(Submission));
+}
+
+// ====================================================================
+// >>> Tick：取出本幀所有傷害，依目標合併後一次套用 <<<
+// ====================================================================
+void UCombatDamageSubsystem::Tick(float DeltaTime)
+{
+    if (PendingDamage.IsEmpty())
+    {
+        Stats.HitsLastFrame = 0;
+        Stats.TargetsLastFrame = 0;
+        Stats.LastFrameCostMs = 0.0;
+        return;
+    }
+
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CombatDamageApply);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    // 第一階段：依目標與來源合併，保持第一次命中的順序
+    int32 NumHits = 0;
+    FCombatDamageSubmission Submission;
+    while (PendingDamage.Dequeue(Submission))
+    {
+        ++NumHits;
+
+        ACharacterBase* Target = Submission.Target.Get();
+        if (!Target)
+        {
+            continue; // 目標在提交後已被銷毀
+        }
+
+        int32& MergedIndex = ScratchTargetToIndex.FindOrAdd(Target, INDEX_NONE);
+        if (MergedIndex == INDEX_NONE)
+        {
+            MergedIndex = ScratchMerged.AddDefaulted();
+            ScratchMerged[MergedIndex].Target = Submission.Target;
+        }
+
+        FMergedDamage& Merged = ScratchMerged[MergedIndex];
+        FCoalescedDamageSource* Source = Merged.Sources.FindByPredicate([&Submission](const FCoalescedDamageSource& Existing)
+        {
+            return Existing.EventInstigator == Submission.EventInstigator && Existing.DamageCauser == Submission.DamageCauser;
+        });
+        if (!Source)
+        {
+            Source = &Merged.Sources.AddDefaulted_GetRef();
+            Source->EventInstigator = Submission.EventInstigator;
+            Source->DamageCauser = Submission.DamageCauser;
+        }
+        Source->Damage += Submission.Damage;
+        ++Source->HitCount;
+    }
+
+    // 第二階段：每個目標只套用一次，只廣播一次生命值變更
+    // 套用過程中觸發的事件可能再提交傷害，這些會留到下一次 Tick
+    const int32 NumTargets = ScratchMerged.Num();
+    for (const FMergedDamage& Merged : ScratchMerged)
+    {
+        if (ACharacterBase* Target = Merged.Target.Get())
+        {
+            Target->ApplyCoalescedDamage(Merged.Sources);
+        }
+    }
+
+    ScratchMerged.Reset();
+    ScratchTargetToIndex.Reset();
+
+    INC_DWORD_STAT_BY(STAT_CombatDamageHits, NumHits);
+    INC_DWORD_STAT_BY(STAT_CombatDamageTargets, NumTargets);
+
+    Stats.HitsLastFrame = NumHits;
+    Stats.TargetsLastFrame = NumTargets;
+    Stats.TotalHits += NumHits;
+    Stats.TotalTargets += NumTargets;
+    Stats.LastFrameCostMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
+
+void UCombatDamageSubsystem::LogStats() const
+{
+    UE_LOG(LogTemp, Log, TEXT("CombatDamageSubsystem: LastFrameHits=%d LastFrameTargets=%d TotalHits=%lld TotalTargets=%lld (broadcasts saved=%lld) LastFrameCost=%.3fms"),
+        Stats.HitsLastFrame,
+        Stats.TargetsLastFrame,
+        Stats.TotalHits,
+        Stats.TotalTargets,
+        Stats.TotalHits - Stats.TotalTargets,
+        Stats.LastFrameCostMs);
+}
@@ -0,0 +1,259 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/CombatHitQuerySubsystem.h"
+#include "Engine/World.h" // 用於 AsyncSweepByObjectType
+#include "Subsystems/CharacterSpatialIndexSubsystem.h" // 角色空間索引 (寬相)
+#include "Subsystems/CharacterHitboxHistorySubsystem.h" // 延遲補償的歷史位置
+#include "Core/CharacterBase.h"
+#include "Components/CapsuleComponent.h" // 窄相需要角色的膠囊體
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Combat Hit Query Tick"), STAT_CombatHitQueryTick, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Combat Hit Query Index Resolve"), STAT_CombatHitQueryIndexResolve, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Hit Queries"), STAT_CombatHitQueries, STATGROUP_CharacterSample);
+
+namespace HitQueryRewind
+{
+    // 允許回溯的最長時間；超過時夾到這個值，避免高延遲或偽造的時間戳記擴大判定範圍
+    static float MaxRewindSeconds = 0.25f;
+    static FAutoConsoleVariableRef CVarMaxRewindSeconds(
+        TEXT("CharacterSample.HitQuery.MaxRewindSeconds"),
+        MaxRewindSeconds,
+        TEXT("命中查詢延遲補償最多回溯的秒數。"));
+
+    // 寬相以目前位置查詢，因此依回溯時間放大半徑，涵蓋目標在這段時間內可能的移動距離 (公分/秒)
+    static constexpr float MaxTargetSpeed = 1200.0f;
+}
+
+// ====================================================================
+// >>> 控制台指令：輸出命中查詢統計 <<<
+// 用法：CharacterSample.HitQuery.Stats
+// ====================================================================
+static FAutoConsoleCommandWithWorld GCombatHitQueryStatsCommand(
+    TEXT("CharacterSample.HitQuery.Stats"),
+    TEXT("輸出 CombatHitQuerySubsystem 的每幀查詢數與總成本。"),
+    FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+    {
+        if (UCombatHitQuerySubsystem* Subsystem = World ? World->GetSubsystem<UCombatHitQuerySubsystem>() : nullptr)
+        {
+            Subsystem->LogStats();
+        }
+    }));
+
+bool UCombatHitQuerySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // 只在實際遊戲世界中運作 (包含 PIE)，編輯器預覽世界不需要
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatHitQuerySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // 確保空間索引子系統先初始化
+    SpatialIndexSubsystem = Collection.InitializeDependency<UCharacterSpatialIndexSubsystem>();
+    HitboxHistorySubsystem = Collection.InitializeDependency<UCharacterHitboxHistorySubsystem>();
+}
+
+void UCombatHitQuerySubsystem::Deinitialize()
+{
+    // 世界關閉時丟棄所有尚未送達的結果
+    PendingRequests.Reset();
+    IssuingRequests.Reset();
+    InFlightCallbacks.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UCombatHitQuerySubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatHitQuerySubsystem, STATGROUP_Tickables);
+}
+
+// ====================================================================
+// >>> 提交請求 <<<
+// 只將請求放入本幀佇列，真正的查詢在 Tick 中批次發出
+// ====================================================================
+void UCombatHitQuerySubsystem::SubmitSphereSweep(FCombatHitQueryRequest&& Request)
+{
+    PendingRequests.Add(MoveTemp(Request));
+}
+
+// ====================================================================
+// >>> Tick：批次發出本幀收集到的所有請求 <<<
+// 子系統在所有 Actor Tick 之後才被呼叫，因此能收集到本幀所有 Anim Notify 的請求
+// ====================================================================
+void UCombatHitQuerySubsystem::Tick(float DeltaTime)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CombatHitQueryTick);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    UWorld* World = GetWorld();
+    const int32 NumQueries = PendingRequests.Num();
+    INC_DWORD_STAT_BY(STAT_CombatHitQueries, NumQueries);
+
+    if (World && NumQueries > 0)
+    {
+        if (!TraceDelegate.IsBound())
+        {
+            TraceDelegate.BindUObject(this, &UCombatHitQuerySubsystem::HandleTraceComplete);
+        }
+
+        // 只查詢 Pawn 物件類型，與原本的 SphereTraceMultiForObjects 行為一致
+        const FCollisionObjectQueryParams ObjectQueryParams(ECC_Pawn);
+
+        // 先交換出來再處理：空間索引路徑會同步執行回調，回調中可能再提交新的請求
+        Swap(PendingRequests, IssuingRequests);
+
+        for (FCombatHitQueryRequest& Request : IssuingRequests)
+        {
+            if (Request.bResolveWithCharacterIndex && SpatialIndexSubsystem)
+            {
+                ResolveWithCharacterIndex(Request);
+                continue;
+            }
+
+            // 膠囊體是簡單碰撞，不需要 bTraceComplex
+            FCollisionQueryParams Params(SCENE_QUERY_STAT(CombatHitQuery), false);
+            if (AActor* IgnoredActor = Request.IgnoredActor.Get())
+            {
+                Params.AddIgnoredActor(IgnoredActor);
+            }
+
+            const uint32 RequestId = NextRequestId++;
+            if (NextRequestId == 0)
+            {
+                NextRequestId = 1; // 0 保留為無效值
+            }
+
+            World->AsyncSweepByObjectType(
+                EAsyncTraceType::Multi,
+                Request.Start,
+                Request.End,
+                FQuat::Identity,
+                ObjectQueryParams,
+                FCollisionShape::MakeSphere(Request.Radius),
+                Params,
+                &TraceDelegate,
+                RequestId
+            );
+
+            InFlightCallbacks.Add(RequestId, MoveTemp(Request.OnComplete));
+        }
+
+        IssuingRequests.Reset();
+    }
+
+    // 更新統計：提交成本加上上一輪派送結果的成本
+    const double FrameCostSeconds = (FPlatformTime::Seconds() - StartTime) + PendingDeliveryCostSeconds;
+    PendingDeliveryCostSeconds = 0.0;
+
+    Stats.QueriesLastFrame = NumQueries;
+    Stats.PeakQueriesPerFrame = FMath::Max(Stats.PeakQueriesPerFrame, NumQueries);
+    Stats.TotalQueries += NumQueries;
+    Stats.LastFrameCostMs = FrameCostSeconds * 1000.0;
+    Stats.TotalCostMs += Stats.LastFrameCostMs;
+}
+
+// ====================================================================
+// >>> 空間索引路徑 <<<
+// 寬相：空間索引的線段查詢；窄相：打包成 SoA 後以 SIMD 測試掃掠球體對膠囊體
+// ====================================================================
+void UCombatHitQuerySubsystem::ResolveWithCharacterIndex(FCombatHitQueryRequest& Request)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CombatHitQueryIndexResolve);
+
+    // 延遲補償：限制回溯時間，並放大寬相半徑以涵蓋目標當時的位置
+    const double Now = GetWorld()->GetTimeSeconds();
+    const bool bRewind = Request.RewindTime >= 0.0 && HitboxHistorySubsystem && Request.RewindTime < Now;
+    const double RewindTime = bRewind ? FMath::Max(Request.RewindTime, Now - HitQueryRewind::MaxRewindSeconds) : Now;
+    const float BroadphaseMargin = bRewind ? static_cast<float>(Now - RewindTime) * HitQueryRewind::MaxTargetSpeed : 0.0f;
+
+    ScratchCandidates.Reset();
+    SpatialIndexSubsystem->QuerySegment(Request.Start, Request.End, Request.Radius + BroadphaseMargin, ScratchCandidates);
+
+    const AActor* IgnoredActor = Request.IgnoredActor.Get();
+
+    // 移除被忽略的角色並打包膠囊體，保持候選陣列與膠囊索引一一對應。
+    // 與物理路徑的 ECC_Pawn 物件查詢一致：關閉查詢碰撞 (例如入場動畫期間) 或物件類型不是 Pawn 的膠囊體不會被命中
+    ScratchCapsules.Reset();
+    ScratchCapsules.Reserve(ScratchCandidates.Num());
+    for (int32 Index = ScratchCandidates.Num() - 1; Index >= 0; --Index)
+    {
+        const UCapsuleComponent* Capsule = ScratchCandidates[Index]->GetCapsuleComponent();
+        if (ScratchCandidates[Index] == IgnoredActor || !Capsule
+            || !Capsule->IsQueryCollisionEnabled() || Capsule->GetCollisionObjectType() != ECC_Pawn)
+        {
+            ScratchCandidates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        }
+    }
+    for (const ACharacterBase* Candidate : ScratchCandidates)
+    {
+        const UCapsuleComponent* Capsule = Candidate->GetCapsuleComponent();
+        FVector RewoundLocation;
+        if (bRewind && HitboxHistorySubsystem->GetLocationAtTime(Candidate->GetHitboxHistoryHandle(), RewindTime, RewoundLocation))
+        {
+            ScratchCapsules.Add(RewoundLocation, Capsule->GetScaledCapsuleRadius(), Capsule->GetScaledCapsuleHalfHeight());
+        }
+        else
+        {
+            ScratchCapsules.Add(Capsule);
+        }
+    }
+
+    FCombatSweptSphere Sweep;
+    Sweep.Start = FVector3f(Request.Start);
+    Sweep.End = FVector3f(Request.End);
+    Sweep.Radius = Request.Radius;
+
+    ScratchHitIndices.Reset();
+    CombatNarrowphase::SweptSphereVsCapsulesSIMD(Sweep, ScratchCapsules, ScratchHitIndices);
+
+    ScratchHitResults.Reset();
+    for (const int32 HitIndex : ScratchHitIndices)
+    {
+        ACharacterBase* HitCharacter = ScratchCandidates[HitIndex];
+        UCapsuleComponent* Capsule = HitCharacter->GetCapsuleComponent();
+        const FVector CapsuleLocation(ScratchCapsules.CenterX[HitIndex], ScratchCapsules.CenterY[HitIndex], ScratchCapsules.CenterZ[HitIndex]); // 回溯時為當時的位置
+        ScratchHitResults.Emplace(HitCharacter, Capsule, CapsuleLocation, (Request.Start - CapsuleLocation).GetSafeNormal());
+    }
+
+    ++Stats.TotalIndexQueries;
+    Request.OnComplete.ExecuteIfBound(ScratchHitResults);
+}
+
+// ====================================================================
+// >>> 非同步結果回調 <<<
+// 由引擎在下一幀派送，找到對應的請求回調並轉交結果
+// ====================================================================
+void UCombatHitQuerySubsystem::HandleTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    FOnCombatHitQueryComplete OnComplete;
+    if (InFlightCallbacks.RemoveAndCopyValue(TraceDatum.UserData, OnComplete))
+    {
+        // 攻擊者可能在等待期間被銷毀，委託會自動失效
+        OnComplete.ExecuteIfBound(TraceDatum.OutHits);
+    }
+
+    PendingDeliveryCostSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void UCombatHitQuerySubsystem::LogStats() const
+{
+    const double AverageCostMs = Stats.TotalQueries > 0 ? Stats.TotalCostMs / Stats.TotalQueries : 0.0;
+
+    UE_LOG(LogTemp, Log, TEXT("CombatHitQuerySubsystem: LastFrame=%d Peak=%d Total=%lld (Index=%lld) InFlight=%d LastFrameCost=%.3fms TotalCost=%.3fms AvgPerQuery=%.4fms"),
+        Stats.QueriesLastFrame,
+        Stats.PeakQueriesPerFrame,
+        Stats.TotalQueries,
+        Stats.TotalIndexQueries,
+        InFlightCallbacks.Num(),
+        Stats.LastFrameCostMs,
+        Stats.TotalCostMs,
+        AverageCostMs);
+}
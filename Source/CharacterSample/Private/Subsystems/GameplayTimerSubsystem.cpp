@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/GameplayTimerSubsystem.h"
+#include "Engine/World.h"
+#include "TimerManager.h" // 基準測試用的 FTimerManager
+#include "HAL/IConsoleManager.h" // 用於註冊控制台指令
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Gameplay Timers Tick"), STAT_GameplayTimersTick, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay Timers Fired"), STAT_GameplayTimersFired, STATGROUP_CharacterSample);
+
+// ====================================================================
+// >>> 控制台指令：FTimerManager 與時間輪的設定 / 取消成本比較 <<<
+// 模擬每次攻擊與受擊時「清除後重新設定」的使用方式
+// 用法：CharacterSample.Timers.Benchmark [計時器數量]
+// ====================================================================
+static FAutoConsoleCommandWithWorldAndArgs GGameplayTimerBenchmarkCommand(
+    TEXT("CharacterSample.Timers.Benchmark"),
+    TEXT("比較 FTimerManager 與時間輪在大量計時器反覆設定與取消時的成本。用法：CharacterSample.Timers.Benchmark [計時器數量]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (!World)
+        {
+            return;
+        }
+
+        const int32 NumTimers = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+        constexpr int32 NumRounds = 8;
+
+        FRandomStream Random(1234);
+        TArray<float> Delays;
+        Delays.SetNumUninitialized(NumTimers);
+        for (float& Delay : Delays)
+        {
+            Delay = Random.FRandRange(0.3f, 2.0f); // 連擊窗口與無敵時間的典型長度
+        }
+
+        // FTimerManager：清除後重新設定
+        FTimerManager& TimerManager = World->GetTimerManager();
+        TArray<FTimerHandle> TimerHandles;
+        TimerHandles.SetNum(NumTimers);
+        const FTimerDelegate EmptyTimerDelegate = FTimerDelegate::CreateLambda([]() {});
+
+        double StartTime = FPlatformTime::Seconds();
+        for (int32 Round = 0; Round < NumRounds; ++Round)
+        {
+            for (int32 Index = 0; Index < NumTimers; ++Index)
+            {
+                TimerManager.ClearTimer(TimerHandles[Index]);
+                TimerManager.SetTimer(TimerHandles[Index], EmptyTimerDelegate, Delays[Index], false);
+            }
+        }
+        const double TimerManagerMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        for (FTimerHandle& Handle : TimerHandles)
+        {
+            TimerManager.ClearTimer(Handle);
+        }
+
+        // 時間輪：使用獨立的實例，不影響子系統中的計時器
+        FTimingWheel TimingWheel;
+        TArray<FTimingWheelHandle> WheelHandles;
+        WheelHandles.SetNum(NumTimers);
+
+        StartTime = FPlatformTime::Seconds();
+        for (int32 Round = 0; Round < NumRounds; ++Round)
+        {
+            for (int32 Index = 0; Index < NumTimers; ++Index)
+            {
+                TimingWheel.Cancel(WheelHandles[Index]);
+                const uint64 ExpireTick = FMath::CeilToInt64(Delays[Index] / UGameplayTimerSubsystem::TickSeconds);
+                WheelHandles[Index] = TimingWheel.Arm(ExpireTick, FSimpleDelegate::CreateLambda([]() {}));
+            }
+        }
+        const double TimingWheelMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+        UE_LOG(LogTemp, Log, TEXT("Timers.Benchmark: %d timers x %d re-arms | FTimerManager %.3f ms | TimingWheel %.3f ms | speedup x%.2f"),
+            NumTimers, NumRounds, TimerManagerMs, TimingWheelMs, TimingWheelMs > 0.0 ? TimerManagerMs / TimingWheelMs : 0.0);
+    }));
+
+bool UGameplayTimerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    // 只在實際遊戲世界中運作 (包含 PIE)，編輯器預覽世界不需要
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGameplayTimerSubsystem::Deinitialize()
+{
+    // 世界關閉時丟棄所有尚未到期的計時器
+    TimingWheel.Reset();
+    ExpiredTimers.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UGameplayTimerSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UGameplayTimerSubsystem, STATGROUP_Tickables);
+}
+
+FTimingWheelHandle UGameplayTimerSubsystem::SetTimer(float DelaySeconds, FSimpleDelegate&& Callback)
+{
+    // 無條件進位到刻度，確保不會提早到期
+    const double ExpireTime = GetWorld()->GetTimeSeconds() + FMath::Max(DelaySeconds, 0.0f);
+    const uint64 ExpireTick = static_cast<uint64>(FMath::CeilToDouble(ExpireTime / TickSeconds));
+    return TimingWheel.Arm(ExpireTick, MoveTemp(Callback));
+}
+
+// ====================================================================
+// >>> Tick：推進時間輪並批次執行到期的回調 <<<
+// ====================================================================
+void UGameplayTimerSubsystem::Tick(float DeltaTime)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_GameplayTimersTick);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    const uint64 CurrentTick = static_cast<uint64>(FMath::FloorToDouble(GetWorld()->GetTimeSeconds() / TickSeconds));
+    TimingWheel.Advance(CurrentTick, ExpiredTimers);
+
+    if (ExpiredTimers.Num() == 0)
+    {
+        LastTickCostMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        return;
+    }
+
+    // 每個回調執行前才取出並釋放節點：同一批中較早的回調清除的計時器不會再執行，
+    // 回調中也可以安全地重新設定計時器 (新的計時器最早在下一次 Tick 到期)
+    TArray<FTimingWheelHandle> Expired = MoveTemp(ExpiredTimers);
+    int32 NumFired = 0;
+    for (const FTimingWheelHandle& Handle : Expired)
+    {
+        FSimpleDelegate Callback;
+        if (TimingWheel.TakeExpired(Handle, Callback))
+        {
+            Callback.ExecuteIfBound();
+            ++NumFired;
+        }
+    }
+
+    INC_DWORD_STAT_BY(STAT_GameplayTimersFired, NumFired);
+
+    Expired.Reset();
+    ExpiredTimers = MoveTemp(Expired); // 保留容量供下一次使用
+
+    LastTickCostMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/CrowdHealthBarsWidget.h"
+#include "UI/SCrowdHealthBars.h"
+
+TSharedRef<SWidget> UCrowdHealthBarsWidget::RebuildWidget()
+{
+    CrowdHealthBars = SNew(SCrowdHealthBars)
+        .PlayerController(GetOwningPlayer())
+        .BarSize(FVector2f(BarSize))
+        .HeadOffset(HeadOffset);
+    return CrowdHealthBars.ToSharedRef();
+}
+
+void UCrowdHealthBarsWidget::ReleaseSlateResources(bool bReleaseChildren)
+{
+    Super::ReleaseSlateResources(bReleaseChildren);
+
+    CrowdHealthBars.Reset();
+}
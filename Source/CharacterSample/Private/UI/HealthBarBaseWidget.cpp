@@ -7,17 +7,50 @@
 
 void UHealthBarBaseWidget::SetOwnerCharacterAndInitialize(ACharacterBase* NewOwnerCharacter)
 {
+    // 重新指定擁有者時先解除舊的綁定，避免舊角色的變化繼續更新這個血條
+    UnbindOwnerCharacter();
+
     OwnerCharacter = NewOwnerCharacter;
 
     if (OwnerCharacter)
     {
-        // 綁定到 OwnerCharacter 的 OnHealthChanged 委託
+        // 綁定到 OwnerCharacter 的原生委託 (不經過反射)，只有數值真的變化時才進入藍圖
         // 注意：這裡如果 OwnerCharacter 是 nullptr，這個綁定會失敗，所以要檢查
-        OwnerCharacter->OnHealthChanged.AddDynamic(this, &UHealthBarBaseWidget::K2_UpdateHealthBarUI);
+        HealthChangedHandle = OwnerCharacter->OnHealthChangedNative.AddUObject(this, &UHealthBarBaseWidget::HandleHealthChanged);
 
         // 立即呼叫一次藍圖事件以更新初始顯示
-        K2_UpdateHealthBarUI(OwnerCharacter->GetCurrentHealth(), OwnerCharacter->GetMaxHealth());
+        DisplayedHealth = OwnerCharacter->GetCurrentHealth();
+        DisplayedMaxHealth = OwnerCharacter->GetMaxHealth();
+        K2_UpdateHealthBarUI(DisplayedHealth, DisplayedMaxHealth);
+    }
+}
+
+void UHealthBarBaseWidget::HandleHealthChanged(float CurrentHealth, float MaxHealth)
+{
+    if (CurrentHealth == DisplayedHealth && MaxHealth == DisplayedMaxHealth)
+    {
+        return;
+    }
+
+    DisplayedHealth = CurrentHealth;
+    DisplayedMaxHealth = MaxHealth;
+    K2_UpdateHealthBarUI(CurrentHealth, MaxHealth);
+}
+
+void UHealthBarBaseWidget::UnbindOwnerCharacter()
+{
+    if (OwnerCharacter && HealthChangedHandle.IsValid())
+    {
+        OwnerCharacter->OnHealthChangedNative.Remove(HealthChangedHandle);
     }
+    HealthChangedHandle.Reset();
+}
+
+void UHealthBarBaseWidget::NativeDestruct()
+{
+    UnbindOwnerCharacter();
+
+    Super::NativeDestruct();
 }
 
 void UHealthBarBaseWidget::NativeConstruct()
@@ -0,0 +1,265 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UI/SCrowdHealthBars.h"
+#include "Core/CharacterBase.h"
+#include "Core/CrowdBenchmarkUtils.h" // 基準測試的群眾生成
+#include "Subsystems/CharacterHealthSubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h" // GetViewProjectionMatrix
+#include "Rendering/DrawElements.h"
+#include "Rendering/SlateRenderer.h" // GetResourceHandle
+#include "Styling/CoreStyle.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h" // 用於註冊控制台變數與指令
+#include "CharacterSample.h" // STATGROUP_CharacterSample
+
+DECLARE_CYCLE_STAT(TEXT("Crowd Health Bars Gather"), STAT_CrowdHealthBarsGather, STATGROUP_CharacterSample);
+DECLARE_CYCLE_STAT(TEXT("Crowd Health Bars Build"), STAT_CrowdHealthBarsBuild, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Health Bars Drawn"), STAT_CrowdHealthBarsDrawn, STATGROUP_CharacterSample);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Health Bars Culled"), STAT_CrowdHealthBarsCulled, STATGROUP_CharacterSample);
+
+namespace CrowdHealthBars
+{
+    static bool bEnabled = true;
+    static FAutoConsoleVariableRef CVarEnabled(
+        TEXT("CharacterSample.UI.CrowdHealthBars"),
+        bEnabled,
+        TEXT("本地玩家控制器開始遊戲時是否建立群眾血條 (在一次繪製中畫出所有受傷角色的血條)。"));
+
+    static const FColor BackgroundColor(0, 0, 0, 160);
+    static const FLinearColor EmptyColor(0.8f, 0.05f, 0.05f);
+    static const FLinearColor FullColor(0.1f, 0.8f, 0.1f);
+
+    static void AddQuad(const FSlateRenderTransform& RenderTransform, const FVector2f& Min, const FVector2f& Max, const FColor& Color,
+        TArray<FSlateVertex>& OutVertices, TArray<SlateIndex>& OutIndices)
+    {
+        const SlateIndex Base = static_cast<SlateIndex>(OutVertices.Num());
+        OutVertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(Min.X, Min.Y), FVector2f(0.0f, 0.0f), Color));
+        OutVertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(Max.X, Min.Y), FVector2f(1.0f, 0.0f), Color));
+        OutVertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(Max.X, Max.Y), FVector2f(1.0f, 1.0f), Color));
+        OutVertices.Add(FSlateVertex::Make<ESlateVertexRounding::Disabled>(RenderTransform, FVector2f(Min.X, Max.Y), FVector2f(0.0f, 1.0f), Color));
+
+        OutIndices.Add(Base);
+        OutIndices.Add(Base + 1);
+        OutIndices.Add(Base + 2);
+        OutIndices.Add(Base);
+        OutIndices.Add(Base + 2);
+        OutIndices.Add(Base + 3);
+    }
+}
+
+void SCrowdHealthBars::Construct(const FArguments& InArgs)
+{
+    PlayerController = InArgs._PlayerController;
+    BarSize = InArgs._BarSize;
+    HeadOffset = InArgs._HeadOffset;
+    WhiteBrush = FCoreStyle::Get().GetBrush(TEXT("GenericWhiteBox"));
+
+    // 內容每幀都會變化：每幀 Tick 收集並重新繪製，不參與失效快取
+    SetCanTick(true);
+    ForceVolatile(true);
+    SetVisibility(EVisibility::HitTestInvisible);
+}
+
+bool SCrowdHealthBars::IsEnabled()
+{
+    return CrowdHealthBars::bEnabled;
+}
+
+FVector2D SCrowdHealthBars::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+    // 大小由所在的插槽決定 (鋪滿視口)
+    return FVector2D::ZeroVector;
+}
+
+bool SCrowdHealthBars::GetViewProjection(const APlayerController* InPlayerController, const FVector2f& ViewportSize, FMatrix& OutViewProjection)
+{
+    const APlayerCameraManager* CameraManager = InPlayerController ? InPlayerController->PlayerCameraManager.Get() : nullptr;
+    if (!CameraManager || ViewportSize.X <= 0.0f || ViewportSize.Y <= 0.0f)
+    {
+        return false;
+    }
+
+    FMinimalViewInfo ViewInfo = CameraManager->GetCameraCacheView();
+    ViewInfo.AspectRatio = ViewportSize.X / ViewportSize.Y;
+
+    FMatrix ViewMatrix;
+    FMatrix ProjectionMatrix;
+    UGameplayStatics::GetViewProjectionMatrix(ViewInfo, ViewMatrix, ProjectionMatrix, OutViewProjection);
+    return true;
+}
+
+int32 SCrowdHealthBars::GatherInstances(const UCharacterHealthSubsystem& HealthSubsystem, const FMatrix& ViewProjection, const AActor* IgnoredActor,
+    float InHeadOffset, FVector2f InBarSize, const FVector2f& ViewportSize, TArray<FCrowdHealthBarInstance>& OutInstances)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CrowdHealthBarsGather);
+
+    OutInstances.Reset();
+
+    // 血條中心離開畫面超過一條血條的寬度才剔除，避免在邊緣突然消失
+    const float MarginX = 2.0f * InBarSize.X / FMath::Max(ViewportSize.X, 1.0f);
+    const float MarginY = 2.0f * InBarSize.Y / FMath::Max(ViewportSize.Y, 1.0f);
+
+    int32 NumDamaged = 0;
+    HealthSubsystem.ForEachDamagedCharacter([&](const ACharacterBase* Character, float HealthRatio)
+    {
+        ++NumDamaged;
+        if (Character == IgnoredActor || Character->IsHidden())
+        {
+            return;
+        }
+
+        const FVector HeadLocation = Character->GetActorLocation() + FVector(0.0f, 0.0f, Character->GetSimpleCollisionHalfHeight() + InHeadOffset);
+        const FPlane ClipPosition = ViewProjection.TransformFVector4(FVector4(HeadLocation, 1.0f));
+        if (ClipPosition.W <= 0.0f) // 在攝影機後方
+        {
+            return;
+        }
+
+        const float NdcX = static_cast<float>(ClipPosition.X / ClipPosition.W);
+        const float NdcY = static_cast<float>(ClipPosition.Y / ClipPosition.W);
+        if (FMath::Abs(NdcX) > 1.0f + MarginX || FMath::Abs(NdcY) > 1.0f + MarginY)
+        {
+            return;
+        }
+
+        OutInstances.Add({ FVector2f(0.5f + 0.5f * NdcX, 0.5f - 0.5f * NdcY), HealthRatio });
+    });
+
+    SET_DWORD_STAT(STAT_CrowdHealthBarsDrawn, OutInstances.Num());
+    SET_DWORD_STAT(STAT_CrowdHealthBarsCulled, HealthSubsystem.GetNumRegistered() - OutInstances.Num());
+    return NumDamaged;
+}
+
+void SCrowdHealthBars::BuildBarVertices(TConstArrayView<FCrowdHealthBarInstance> InInstances, const FVector2f& LocalSize, FVector2f InBarSize,
+    const FSlateRenderTransform& RenderTransform, TArray<FSlateVertex>& OutVertices, TArray<SlateIndex>& OutIndices)
+{
+    CHARACTERSAMPLE_SCOPE_CYCLE_COUNTER(STAT_CrowdHealthBarsBuild);
+
+    OutVertices.Reset(InInstances.Num() * 8);
+    OutIndices.Reset(InInstances.Num() * 12);
+
+    const FVector2f HalfSize = InBarSize * 0.5f;
+    for (const FCrowdHealthBarInstance& Instance : InInstances)
+    {
+        const FVector2f Center = Instance.ViewportPosition * LocalSize;
+        const FVector2f Min = Center - HalfSize;
+        const FVector2f Max = Center + HalfSize;
+        CrowdHealthBars::AddQuad(RenderTransform, Min, Max, CrowdHealthBars::BackgroundColor, OutVertices, OutIndices);
+
+        const FColor FillColor = FMath::Lerp(CrowdHealthBars::EmptyColor, CrowdHealthBars::FullColor, Instance.HealthRatio).ToFColor(true);
+        CrowdHealthBars::AddQuad(RenderTransform, Min, FVector2f(Min.X + InBarSize.X * Instance.HealthRatio, Max.Y), FillColor, OutVertices, OutIndices);
+    }
+}
+
+void SCrowdHealthBars::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+    const APlayerController* OwningPlayer = PlayerController.Get();
+    const UWorld* World = OwningPlayer ? OwningPlayer->GetWorld() : nullptr;
+    const UCharacterHealthSubsystem* HealthSubsystem = World ? World->GetSubsystem<UCharacterHealthSubsystem>() : nullptr;
+
+    // 投影使用視口的長寬比；元件鋪滿視口，所以與自己的大小相同
+    const FVector2f LocalSize = FVector2f(AllottedGeometry.GetLocalSize());
+    FMatrix ViewProjection;
+    if (!HealthSubsystem || !GetViewProjection(OwningPlayer, LocalSize, ViewProjection))
+    {
+        Instances.Reset();
+        return;
+    }
+
+    GatherInstances(*HealthSubsystem, ViewProjection, OwningPlayer->GetPawn(), HeadOffset, BarSize, LocalSize, Instances);
+}
+
+int32 SCrowdHealthBars::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+    if (Instances.Num() == 0 || !WhiteBrush)
+    {
+        return LayerId;
+    }
+
+    BuildBarVertices(Instances, FVector2f(AllottedGeometry.GetLocalSize()), BarSize, AllottedGeometry.GetAccumulatedRenderTransform(), Vertices, Indices);
+
+    // 所有血條一個繪製元素：同一個筆刷與圖層，渲染器只需要一個批次
+    const FSlateResourceHandle ResourceHandle = FSlateApplication::Get().GetRenderer()->GetResourceHandle(*WhiteBrush);
+    FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, ResourceHandle, Vertices, Indices, nullptr, 0, 0);
+
+    return LayerId;
+}
+
+// ====================================================================
+// >>> 控制台指令：群眾血條的收集與頂點產生成本 <<<
+// 用法：CharacterSample.UI.HealthBarBenchmark [角色數量，預設 500] [受傷比例 0..1，預設 0.5] [回合數，預設 200]
+// 在第一個玩家的攝影機前方生成群眾並讓一部分受傷，逐回合執行與元件每幀相同的收集與頂點產生 (1920x1080)。
+// 不經過渲染，因此在 -nullrhi (例如 CI 或專用的量測機器) 下同樣可以量測元件端的成本。
+// ====================================================================
+static void RunHealthBarBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+    const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+    UCharacterHealthSubsystem* HealthSubsystem = World ? World->GetSubsystem<UCharacterHealthSubsystem>() : nullptr;
+    if (!PlayerController || !PlayerController->PlayerCameraManager || !HealthSubsystem)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("HealthBar Benchmark: requires a game world with a player camera."));
+        return;
+    }
+
+    const int32 CrowdSize = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 500;
+    const float DamagedFraction = Args.Num() > 1 ? FMath::Clamp(FCString::Atof(*Args[1]), 0.0f, 1.0f) : 0.5f;
+    const int32 NumRounds = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 200;
+
+    const FVector2f ViewportSize(1920.0f, 1080.0f);
+    const FVector2f BarSize(60.0f, 6.0f);
+    const float HeadOffset = 30.0f;
+
+    // 群眾放在攝影機前方，大部分在畫面內
+    const FMinimalViewInfo& View = PlayerController->PlayerCameraManager->GetCameraCacheView();
+    const FVector Forward = View.Rotation.Vector().GetSafeNormal2D();
+    const float HalfExtent = CrowdBenchmark::GetCrowdHalfExtent(CrowdSize, 200.0f);
+    FRandomStream RandomStream(12345);
+    TArray<ACharacterBase*> Crowd = CrowdBenchmark::SpawnCrowd(World, CrowdSize, View.Location + Forward * (HalfExtent + 500.0f), 200.0f, RandomStream);
+
+    // 直接修改子系統的資料，不廣播 (不讓通知的成本混入量測)
+    int32 NumDamaged = 0;
+    for (ACharacterBase* Character : Crowd)
+    {
+        if (Character->GetHealthHandle() != INDEX_NONE && RandomStream.FRand() < DamagedFraction)
+        {
+            HealthSubsystem->ApplyDamage(Character->GetHealthHandle(), Character->GetMaxHealth() * RandomStream.FRandRange(0.1f, 0.9f));
+            ++NumDamaged;
+        }
+    }
+
+    FMatrix ViewProjection;
+    SCrowdHealthBars::GetViewProjection(PlayerController, ViewportSize, ViewProjection);
+
+    TArray<FCrowdHealthBarInstance> Instances;
+    TArray<FSlateVertex> Vertices;
+    TArray<SlateIndex> Indices;
+    double GatherSeconds = 0.0;
+    double BuildSeconds = 0.0;
+    int32 NumDamagedChecked = 0;
+    for (int32 Round = 0; Round < NumRounds; ++Round)
+    {
+        double StartTime = FPlatformTime::Seconds();
+        NumDamagedChecked = SCrowdHealthBars::GatherInstances(*HealthSubsystem, ViewProjection, PlayerController->GetPawn(), HeadOffset, BarSize, ViewportSize, Instances);
+        GatherSeconds += FPlatformTime::Seconds() - StartTime;
+
+        StartTime = FPlatformTime::Seconds();
+        SCrowdHealthBars::BuildBarVertices(Instances, ViewportSize, BarSize, FSlateRenderTransform(), Vertices, Indices);
+        BuildSeconds += FPlatformTime::Seconds() - StartTime;
+    }
+
+    const double GatherUs = GatherSeconds * 1.0e6 / NumRounds;
+    const double BuildUs = BuildSeconds * 1.0e6 / NumRounds;
+    UE_LOG(LogTemp, Log, TEXT("HealthBar Benchmark [%d characters, %d damaged, %d registered, %d rounds]: %d bars drawn, %d damaged culled off-screen, %d vertices in 1 draw element"),
+        CrowdSize, NumDamaged, HealthSubsystem->GetNumRegistered(), NumRounds, Instances.Num(), NumDamagedChecked - Instances.Num(), Vertices.Num());
+    UE_LOG(LogTemp, Log, TEXT("  gather %8.2f us/frame | build %8.2f us/frame | total %8.2f us/frame"), GatherUs, BuildUs, GatherUs + BuildUs);
+
+    CrowdBenchmark::DestroyCrowd(Crowd);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GHealthBarBenchmarkCommand(
+    TEXT("CharacterSample.UI.HealthBarBenchmark"),
+    TEXT("量測群眾血條每幀的收集與頂點產生成本 (不需要渲染，可在 -nullrhi 下執行)。參數：[角色數量] [受傷比例] [回合數]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunHealthBarBenchmark));
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WeaponTrajectoryBakeCommandlet.generated.h"
+
+/**
+ * 離線烘焙攻擊蒙太奇的武器插槽軌跡，存成 UWeaponTrajectoryDataAsset。
+ * 直接從動畫資料計算骨骼鏈，不需要生成角色或執行動畫藍圖；只能在編輯器中執行。
+ *
+ * 用法：
+ *   UnrealEditor-Cmd CharacterSample.uproject -run=WeaponTrajectoryBake
+ *     [-Character=<藍圖類別路徑>]   角色類別，提供骨架網格、網格相對變換與預設的攻擊蒙太奇
+ *     [-Montages=<路徑>,<路徑>...]  只烘焙指定的蒙太奇 (預設為角色 CombatComponent 中的所有攻擊蒙太奇)
+ *     [-Socket=weapon_l]            取樣的插槽
+ *     [-SampleRate=60]              每秒取樣數
+ *     [-Output=<資產路徑>]          輸出資產 (已存在時覆寫其中對應蒙太奇的軌跡)
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UWeaponTrajectoryBakeCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UWeaponTrajectoryBakeCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CharacterBotInputComponent.generated.h"
+
+class UCharacterInputManagerComponent;
+class UInputAction;
+struct FInputActionValue;
+
+/**
+ * 負載測試用的機器人輸入。
+ * 附加在本地的 APlayerController 上，每幀以 UEnhancedInputLocalPlayerSubsystem::InjectInputForAction
+ * 注入 Move、Look、Jump 與攻擊的數值；動作取自操控角色的 UCharacterInputManagerComponent，
+ * 因此與真人玩家走完全相同的 Enhanced Input 綁定、預測與 RPC 路徑 (入場動畫期間同樣會被停用)。
+ *
+ * 以 -CharacterSampleBot 啟動的客戶端會自動加上這個組件；-BotSeed=<n> 指定亂數種子。
+ * 攻擊依 CharacterSample.Bot.AttackPattern 循環：L = 輕攻擊、H = 重攻擊、其他字元 = 停一拍。
+ */
+UCLASS(ClassGroup=(Custom))
+class CHARACTERSAMPLE_API UCharacterBotInputComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UCharacterBotInputComponent();
+
+    // 命令列是否要求以機器人模式執行 (-CharacterSampleBot)
+    static bool IsBotRequestedOnCommandLine();
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+    virtual void BeginPlay() override;
+
+private:
+    // 取得目前操控角色的輸入設定 (角色重生後會改變)
+    const UCharacterInputManagerComponent* GetInputManager() const;
+
+    void Inject(const UInputAction* Action, const FInputActionValue& Value) const;
+
+    void ChooseWanderDirection();
+
+    FRandomStream RandomStream;
+
+    FVector2D WanderInput = FVector2D::ZeroVector;
+    float LookYawRate = 0.0f;
+    float WanderTimeRemaining = 0.0f;
+
+    float AttackTimeRemaining = 0.0f;
+    int32 AttackPatternIndex = 0;
+};
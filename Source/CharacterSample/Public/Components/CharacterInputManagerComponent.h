@@ -43,7 +43,10 @@ public:
     UInputAction* LookAction; // 視角輸入動作
 
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
-    UInputAction* AttackAction; // 攻擊輸入動作
+    UInputAction* AttackAction; // 攻擊輸入動作 (輕攻擊)
+
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
+    UInputAction* HeavyAttackAction; // 重攻擊輸入動作 (連擊圖中的 Heavy 轉移)
 
 	// ====================================================================
 	// >>> 輸入綁定函式 <<<
@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Data/ComboGraphDataAsset.h" // 編譯後的連擊圖 (EComboInput、FCompiledComboGraph)
+#include "Core/TimingWheel.h" // FTimingWheelHandle
+#include "Core/ComboInputBuffer.h" // 帶時間戳記的連擊輸入緩衝
+#include "Engine/StreamableManager.h" // 攻擊蒙太奇的串流句柄
 #include "CombatComponent.generated.h"
 
 
@@ -13,6 +17,9 @@ class UAnimMontage;
 class UInputMappingContext; // 雖然輸入綁定會拆出去，但為了完整性，先聲明
 // 前向聲明 UEntranceAnimationComponent
 class UEntranceAnimationComponent;
+class UGameplayTimerSubsystem;
+class UWeaponTrajectoryDataAsset;
+struct FBakedWeaponTrajectory;
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class CHARACTERSAMPLE_API UCombatComponent : public UActorComponent
@@ -29,43 +36,133 @@ protected:
 
 public:	
 	// Called every frame
-	// virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override; // 暫時不需要 Tick，可以先註釋掉
+	// 只在命中窗口開啟期間啟用，用於逐幀取樣武器插槽
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	// ====================================================================
 	// >>> 攻擊相關函式 <<<
 	// ====================================================================
 
 	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
-	void Attack(); // 處理攻擊輸入 (由輸入系統綁定)
+	void Attack(); // 處理輕攻擊輸入 (由輸入系統綁定)
+
+	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
+	void HeavyAttack(); // 處理重攻擊輸入 (由輸入系統綁定)
+
+	// 處理任一種連擊輸入：待機時起手、窗口開啟時接續、否則緩衝
+	// 本地控制的客戶端會立即預測執行，並把輸入連同預測鍵送到伺服器驗證
+	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
+	void HandleComboInput(EComboInput Input);
 
 	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
 	void PlayAttackComboSegment(); // 播放當前連擊段動畫
 
 	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
-	void TryEnterNextCombo(); // 嘗試進入下一段連擊
+	void TryEnterNextCombo(); // 嘗試以輕攻擊進入下一段連擊，失敗時重置連擊
 
 	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
 	void ResetCombo(); // 重置連擊狀態
 
 	UFUNCTION() // 動態委託需要 UFUNCTION 標記
-	void OnComboWindowEnd(); // 連擊窗口定時器結束時呼叫
+	void OnComboWindowEnd(); // 連擊恢復時間結束時呼叫
 
-	// 由 Anim Notify 呼叫
+	// 取消窗口目前是否開啟
+	UFUNCTION(BlueprintPure, Category = "Combat|Attack")
+	bool IsComboWindowOpen() const;
+
+	// 是否有緩衝中的連擊輸入
+	UFUNCTION(BlueprintPure, Category = "Combat|Attack")
+	bool HasBufferedComboInput() const { return !InputBuffer.IsEmpty(); }
+
+	// 由 Anim Notify 呼叫 - 開啟或關閉目前這段的取消窗口 (只用於 CancelWindowStart < 0 的段)
 	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
 	void SetCanEnterNextCombo(bool bCan);
 
-	// 由 Anim Notify 呼叫
+	// 由 Anim Notify 呼叫 - 緩衝或清除一次輕攻擊輸入
 	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
 	void SetPendingNextComboInput(bool bPending);
 
-	// 由 Anim Notify 呼叫 - 執行實際的攻擊命中檢測
+	// 由 Anim Notify 呼叫 - 提交攻擊命中檢測 (結果由 CombatHitQuerySubsystem 於下一幀送達)
 	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
 	void PerformNormalAttackHitCheck();
 
+	// 由 Anim Notify State 的開始呼叫 - 開啟連續命中窗口，之後每幀掃掠武器插槽的移動軌跡
+	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
+	void BeginAttackHitWindow();
+
+	// 由 Anim Notify State 的結束呼叫 - 關閉連續命中窗口
+	UFUNCTION(BlueprintCallable, Category = "Combat|Attack")
+	void EndAttackHitWindow();
+
 	UFUNCTION() // 動態委託需要 UFUNCTION 標記
 	void OnAttackMontageEnded(UAnimMontage* Montage, bool bInterrupted); // 攻擊動畫結束時呼叫
 
+	// 無頭模式：不播放蒙太奇，改以連擊圖中編譯好的時間軸事件取代 Anim Notify (用於模擬與壓力測試)
+	void SetHeadless(bool bInHeadless);
+	bool IsHeadless() const { return bHeadless; }
+
+	// 連擊圖與舊版設定中所有的攻擊蒙太奇 (供離線烘焙武器軌跡使用，軟引用會同步載入)
+	void GetAttackMontages(TArray<UAnimMontage*>& OutMontages) const;
+
+	// 生成前需要預載的軟引用資產 (UCharacterAssetPreloadSubsystem 以類別預設物件呼叫)
+	void GetPreloadAssets(TArray<FSoftObjectPath>& OutPaths) const;
+
+	// 延遲補償：之後提交的命中查詢回溯這麼多秒判定目標位置 (<= 0 表示使用目前位置)
+	// 伺服器收到預測輸入時以客戶端的延遲設定
+	void SetHitRewindOffset(double InRewindOffset) { HitRewindOffset = InRewindOffset; }
+
 protected:
+	// 命中查詢結果回調 (由 CombatHitQuerySubsystem 呼叫)，SwingId 用來辨識結果屬於哪一段揮擊，Damage 為提交時該段的傷害
+	void OnNormalAttackHitQueryComplete(const TArray<FHitResult>& HitResults, uint32 SwingId, float Damage);
+
+	// 目前使用的連擊圖：優先使用 ComboGraph 資產，否則使用由 AttackMontages 編譯的線性連擊
+	const FCompiledComboGraph& GetActiveComboGraph() const { return ComboGraph ? ComboGraph->GetCompiledGraph() : LegacyComboGraph; }
+
+	// 查表並進入下一段；沒有對應轉移時回傳 false
+	bool TryComboTransition(EComboInput Input, double StartTime = -1.0);
+
+	// 播放連擊圖中的第 SegmentIndex 段並設定取消窗口與恢復計時器。
+	// StartTime 為這段應該開始的世界時間 (< 0 表示現在)；早於現在時蒙太奇與所有窗口一起往前追上，最多追 MaxSegmentCatchUpSeconds
+	bool StartComboSegment(int32 SegmentIndex, double StartTime = -1.0);
+
+	// 取消窗口開啟時若有緩衝輸入，立即接續 (計時器與 Anim Notify 的進入點)
+	void ConsumeBufferedComboInput();
+
+	// 依時間戳記由舊到新消耗緩衝的輸入：丟棄過期與窗口關閉後的輸入，第一個能轉移的輸入接續下一段
+	bool TryConsumeBufferedInput();
+
+	// HandleComboInput 的本體：取消窗口以 InputTime 判定 (伺服器驗證預測輸入時為客戶端按下的時間)
+	// InputPlatformTime 為本地輸入收到時的 FPlatformTime，非 0 時記錄輸入到蒙太奇開始的延遲
+	void HandleComboInputAt(EComboInput Input, double InputTime, double InputPlatformTime = 0.0);
+
+	// 本地輸入開始了一段連擊時記錄延遲 (無頭模式不播放蒙太奇，不記錄)
+	void RecordInputLatency(double InputPlatformTime, bool bBuffered, double ResolveDelaySeconds) const;
+
+	bool IsComboWindowOpenAt(double Time) const;
+
+	// 取消連擊恢復、取消窗口與時間軸事件的計時器
+	void ClearComboTimers();
+
+	// 無頭模式下由計時器呼叫，對應原本的 Anim Notify
+	void HandleTimelineEvent(EComboTimelineEvent Event);
+
+	// 提交一段掃掠 (單次取樣與連續命中窗口共用)
+	void SubmitAttackSweep(const FVector& Start, const FVector& End, float Radius);
+
+	// 開始新的一段揮擊：保留上一段的命中集合，清空目前的
+	void BeginNewSwing();
+
+	// 記錄目標在本段揮擊中已被命中；若之前已命中過則回傳 false
+	bool TryRegisterSwingHit(const AActor* HitActor, uint32 SwingId);
+
+	// 關閉命中窗口並停止 Tick
+	void StopAttackHitWindow();
+
+	// 目前的武器插槽世界位置：有烘焙軌跡時以軌跡與 Actor 變換計算，否則讀取骨架網格的插槽
+	FVector GetWeaponLocation() const;
+
 	// ====================================================================
 	// >>> 參考：擁有的角色 <<<
 	// 讓 CombatComponent 能夠訪問到它所附加的 APlayerCharacter
@@ -77,8 +174,58 @@ protected:
 	// >>> 攻擊連擊相關屬性 <<<
 	// ====================================================================
 
+	// 分支連擊圖 (輕 / 重攻擊、取消窗口、每段的命中形狀與傷害)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Attack")
-	TArray<UAnimMontage*> AttackMontages; // 攻擊動畫蒙太奇陣列，藍圖中設置
+	UComboGraphDataAsset* ComboGraph;
+
+	// 舊版設定：未指定 ComboGraph 時，在蒙太奇載入後編譯成只有輕攻擊的線性連擊。
+	// 軟引用：載入角色藍圖時不會一起同步載入，由 UCharacterAssetPreloadSubsystem 在生成前串流
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Attack")
+	TArray<TSoftObjectPtr<UAnimMontage>> AttackMontages; // 攻擊動畫蒙太奇陣列，藍圖中設置
+
+	FCompiledComboGraph LegacyComboGraph; // 由 AttackMontages 編譯而來
+
+	// 持有攻擊蒙太奇，讓編譯後的連擊圖引用的蒙太奇在組件存在期間不被回收
+	TSharedPtr<FStreamableHandle> AttackMontagesHandle;
+
+	// AttackMontages 全部載入後編譯 LegacyComboGraph (預載未完成時連擊輸入會被忽略)
+	void OnAttackMontagesLoaded();
+
+	// 命中檢測是否使用角色空間索引 + SIMD 窄相 (只會命中 ACharacterBase)，關閉時改用物理場景的非同步掃掠
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Attack")
+	bool bResolveHitsWithCharacterIndex;
+
+	// 連續命中窗口取樣的武器插槽
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Attack|HitWindow")
+	FName WeaponSocketName;
+
+	// 連續命中窗口中，沿武器軌跡掃掠的球體半徑
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Attack|HitWindow")
+	float WeaponSweepRadius;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|Attack|HitWindow")
+	bool bIsHitWindowActive; // 連續命中窗口是否開啟
+
+	FVector PreviousWeaponSocketLocation; // 上一幀取樣的武器插槽位置
+
+	// 離線烘焙的武器軌跡 (UWeaponTrajectoryBakeCommandlet)；未指定或找不到目前蒙太奇的軌跡時退回插槽取樣。
+	// 資產只以軟引用記錄蒙太奇，硬引用它不會讓角色藍圖同步載入攻擊蒙太奇
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat|Attack|HitWindow")
+	UWeaponTrajectoryDataAsset* WeaponTrajectories;
+
+	const FBakedWeaponTrajectory* CurrentWeaponTrajectory; // 目前這段的烘焙軌跡
+	double CurrentSegmentStartTime; // 目前這段開始的世界時間
+	float CurrentSegmentPlayRate;   // 目前這段的播放速率，用於換算蒙太奇播放位置
+
+	// ====================================================================
+	// >>> 每段揮擊的命中集合 <<<
+	// 每個目標在同一段連擊中最多被命中一次。目標數通常很少，以內嵌陣列線性搜尋即可。
+	// 物理路徑的結果會晚一幀送達，因此保留上一段的集合來處理跨段的遲到結果。
+	// ====================================================================
+	using FSwingHitSet = TArray<TObjectKey<AActor>, TInlineAllocator<8>>;
+	FSwingHitSet CurrentSwingHitActors;
+	FSwingHitSet PreviousSwingHitActors;
+	uint32 CurrentSwingId;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|Attack")
 	int32 CurrentAttackComboIndex; // 當前連擊段數
@@ -86,13 +233,74 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|Attack")
 	bool bIsAttacking; // 是否正在攻擊中
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|Attack")
-	bool bCanEnterNextCombo; // 是否可以進入下一段連擊 (由 Anim Notify 設置)
+	// 取消窗口的開啟與關閉時間 (世界時間)；由 Anim Notify 開啟的段在通知到達前開啟時間為無限大
+	double ComboWindowOpenTime;
+	double ComboWindowCloseTime;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|Attack")
-	bool bPendingNextComboInput; // 是否有連段輸入緩衝
+	// 尚未消耗的連擊輸入 (依到達順序，帶按下時間)；重置連擊時清除，跨段保留並以時間戳記判定是否過期
+	FComboInputBuffer InputBuffer;
+
+	float CurrentSegmentDamage; // 目前這段的傷害，提交命中查詢時一併帶入回調
+
+	double HitRewindOffset; // 命中查詢回溯的秒數 (<= 0 表示不回溯)，重置連擊時清除
+
+	FTimingWheelHandle ComboWindowTimerHandle; // 連擊恢復定時器句柄 (UGameplayTimerSubsystem)
+	FTimingWheelHandle ComboWindowOpenTimerHandle; // 定時開啟取消窗口的定時器句柄 (UGameplayTimerSubsystem)
 
-	FTimerHandle ComboWindowTimerHandle; // 連擊窗口定時器句柄
+	// 無頭模式下目前這段已排程的時間軸事件
+	TArray<FTimingWheelHandle, TInlineAllocator<4>> TimelineEventHandles;
+
+	// ====================================================================
+	// >>> 連擊狀態複製 (Push Model) <<<
+	// 連擊段數、是否攻擊中與段序號打包成 16 位元，只在開始新的一段或重置時標記為髒。
+	// 段序號讓連續重播同一段時仍能觸發 OnRep。
+	// ====================================================================
+	UPROPERTY(ReplicatedUsing = OnRep_ComboState)
+	uint16 ReplicatedComboState;
+
+	uint8 ComboSequence; // 伺服器每開始一段就遞增 (自然溢位)
+
+	UFUNCTION()
+	void OnRep_ComboState(uint16 PreviousComboState);
+
+	// 伺服器端：依目前的連擊狀態更新 ReplicatedComboState 並標記為髒
+	void UpdateReplicatedComboState();
+
+	// ====================================================================
+	// >>> 客戶端預測 <<<
+	// 本地控制的客戶端按下攻擊時立即執行連擊邏輯並播放蒙太奇，記錄預測的結果 (開始的段或不開始)，
+	// 再以預測鍵把輸入送到伺服器。伺服器以自己的連擊狀態執行同一個輸入並回覆結果；
+	// 結果不同時客戶端回滾：停止預測的蒙太奇，改採伺服器的段或回到待機。
+	// ====================================================================
+	struct FPredictedComboInput
+	{
+		uint8 Key = 0;
+		int32 PredictedSegment = INDEX_NONE; // 預測開始的段，INDEX_NONE 表示緩衝或忽略
+	};
+	TArray<FPredictedComboInput, TInlineAllocator<8>> PendingPredictions; // 等待伺服器回覆的預測 (依送出順序)
+
+	uint8 NextPredictionKey; // 下一個預測鍵 (自然溢位)
+	uint8 AcknowledgedServerSequence; // 最近一次回覆中伺服器的段序號，對應的 OnRep 不需要再修正
+
+	// 是否由本地客戶端預測 (自主代理)；伺服器與單機直接執行
+	bool IsPredictingClient() const;
+
+	UFUNCTION(Server, Reliable)
+	void ServerHandleComboInput(EComboInput Input, uint8 PredictionKey, double ClientInputTime);
+
+	// ServerSegment 為伺服器因這次輸入開始的段 (INDEX_NONE 表示沒有開始)，ServerSequence 為處理後伺服器的段序號
+	UFUNCTION(Client, Reliable)
+	void ClientAckComboInput(uint8 PredictionKey, int8 ServerSegment, uint8 ServerSequence);
+
+	// 捨棄預測的結果，改採伺服器的段 (INDEX_NONE 表示回到待機)
+	void RollbackPrediction(int32 PredictedSegment, int32 ServerSegment);
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|Headless")
+	bool bHeadless; // 是否處於無頭模式
+
+	// 快取的計時器子系統，避免每次攻擊都查找子系統
+	UPROPERTY()
+	UGameplayTimerSubsystem* GameplayTimerSubsystem;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Combat|State")
 	bool bIsDead; // 角色是否死亡 (未來可能移到 HealthComponent)
@@ -10,6 +10,8 @@
 // 因為組件需要訪問擁有者（Character）的移動組件和膠囊體
 #include "GameFramework/CharacterMovementComponent.h" 
 #include "Components/CapsuleComponent.h"
+// 入場蒙太奇的串流句柄
+#include "Engine/StreamableManager.h"
 
 #include "EntranceAnimationComponent.generated.h"
 
@@ -29,8 +31,9 @@ public:
     // >>> 入場動畫屬性 (從 APlayerCharacter 移入) <<<
     // ====================================================================
 
+    // 軟引用：由 UCharacterAssetPreloadSubsystem 在生成前串流，尚未載入完成時 PlayEntranceAnimation 會等待句柄
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation|Entrance")
-    class UAnimMontage* EntranceMontage; // 用於入場動畫的 AnimMontage 資產
+    TSoftObjectPtr<UAnimMontage> EntranceMontage; // 用於入場動畫的 AnimMontage 資產
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Animation|Entrance")
     bool bIsPlayingEntranceAnimation; // 標誌：指示是否正在播放入場動畫
@@ -42,6 +45,14 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Animation|Entrance") // 讓藍圖可以呼叫這個函數
     void PlayEntranceAnimation();
 
+    // 中止進行中的入場動畫 (包含等待載入的請求)，回到尚未播放的狀態；由角色池重用角色時呼叫。
+    // 不會恢復移動與碰撞，由呼叫端 (ACharacterBase::OnAcquiredFromPool) 負責
+    void ResetEntranceAnimation();
+
+    // 生成前需要預載的軟引用資產 (UCharacterAssetPreloadSubsystem 以類別預設物件呼叫)；
+    // World 為角色將生成的世界，專用伺服器 (包含 PIE 的專用伺服器) 上不載入入場蒙太奇
+    void GetPreloadAssets(TArray<FSoftObjectPath>& OutPaths, const UWorld* World = nullptr) const;
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
@@ -72,4 +83,20 @@ protected:
      */
     UFUNCTION() // 宣告為 UFunction 以便被 Unreal 系統呼叫
     void OnMontageEnded(UAnimMontage* Montage, bool bInterrupted);
+
+private:
+    // 播放已載入的入場蒙太奇，並在播放期間鎖住輸入、移動與碰撞
+    void PlayLoadedEntranceMontage(UAnimMontage* Montage);
+
+    // 等待中的入場蒙太奇載入完成
+    void OnEntranceMontageLoaded();
+
+    // 無法播放入場動畫時解除鎖定並交還控制權
+    void AbortEntranceAnimation();
+
+    // 入場蒙太奇的串流句柄 (等待期間與播放期間持有)
+    TSharedPtr<FStreamableHandle> EntranceMontageHandle;
+
+    // 開始等待載入的時間，用於記錄等待了多久
+    double EntranceMontageWaitStartTime = 0.0;
 };
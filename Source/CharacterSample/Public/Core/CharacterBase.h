@@ -11,6 +11,14 @@
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHealthChangedSignature, float, CurrentHealth, float, MaxHealth);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnDeathSignature);
 
+// 原生版本的生命值變更通知，C++ 監聽者 (例如血條) 綁定這個可以避開反射與藍圖 VM 的成本
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnHealthChangedNative, float /*CurrentHealth*/, float /*MaxHealth*/);
+
+class UCharacterSpatialIndexSubsystem; // 前向聲明空間索引子系統
+class UCharacterHealthSubsystem; // 前向聲明生命值子系統
+class UCharacterHitboxHistorySubsystem; // 前向聲明命中框歷史子系統 (延遲補償)
+struct FCoalescedDamageSource; // 前向聲明合併傷害的單一來源
+
 UCLASS()
 class CHARACTERSAMPLE_API ACharacterBase : public ACharacter
 {
@@ -24,9 +32,15 @@ protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
 
+    // Called when the actor is removed from the world
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
-    // Called every frame
-    virtual void Tick(float DeltaTime) override;
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    // 蹲下與起身會改變膠囊體半高，同步更新空間索引中的尺寸
+    virtual void OnStartCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust) override;
+    virtual void OnEndCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust) override;
 
     // --- 傷害與生命值系統 ---
 	
@@ -42,49 +56,163 @@ public:
     // 覆寫它來處理生命值邏輯
     virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
+    // 由 UCombatDamageSubsystem 在幀末呼叫：同一幀內對此角色的命中已依來源 (控制器與 Actor) 合併成 Sources，
+    // 每個來源各自經過引擎的傷害處理與受傷藍圖事件以保留歸屬，但無敵檢查、OnHealthChanged 廣播與死亡處理只執行一次
+    virtual float ApplyCoalescedDamage(TConstArrayView<FCoalescedDamageSource> Sources);
+
     // 藍圖可呼叫的通用傷害應用函數
     // 從攻擊者那邊呼叫來對此角色造成傷害的主要入口
     UFUNCTION(BlueprintCallable, Category = "Health")
     void ApplyDamageToHealth(float DamageAmount);
 
+    // 回滿生命值並清除死亡與無敵狀態 (重生、測試用)
+    UFUNCTION(BlueprintCallable, Category = "Health")
+    void Revive();
+
+    // 由 UCharacterHealthSubsystem 在批次處理 (排入佇列的傷害 / 治療、每秒回復、死亡偵測) 後呼叫
+    void HandleBatchedHealthChange(bool bDied);
+
     // 藍圖可讀寫的生命值屬性
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health")
+    // BeginPlay 後權威資料位於 UCharacterHealthSubsystem；執行期修改上限請呼叫 SetMaxHealth (以 Push Model 複製，直接寫入不會送出)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_MaxHealth, Category = "Health")
     float MaxHealth;
 
+    // 以下兩個欄位是給藍圖讀取的鏡像，只在生命值變化時由子系統同步
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Health") // VisibleAnywhere 讓藍圖只讀
     float CurrentHealth;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Health")
     bool bIsDead; // 角色是否已死亡
 
+    // 每秒自動回復的生命值 (0 表示不回復)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health")
+    float HealthRegenPerSecond;
+
     // 無敵時間相關屬性 (可選，但很實用)
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health|Invincibility")
     float InvincibilityDuration; // 無敵持續時間
 
+    // 合併生命值通知：開啟後每次變化只標記為待通知，由 UCharacterHealthSubsystem 每幀最多送出一次，
+    // 畫面外的角色再依 CharacterSample.Health.OffscreenNotifyRate 降低頻率 (適合大量敵人)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health")
+    bool bCoalesceHealthNotifications;
+
     // 當生命值改變時觸發 (例如 UI 更新血條)
     UPROPERTY(BlueprintAssignable, Category = "Health") // Assignable 讓藍圖可以綁定事件
     FOnHealthChangedSignature OnHealthChanged;
 
+    // 與 OnHealthChanged 同時觸發的原生委託
+    FOnHealthChangedNative OnHealthChangedNative;
+
+    // 立即廣播 OnHealthChangedNative 與 OnHealthChanged (合併模式下由子系統呼叫)
+    void BroadcastHealthChanged();
+
     UPROPERTY(BlueprintAssignable, Category = "Health")
     FOnDeathSignature OnDeath;
 
     // 添加公共的 getter 函數，讓外部類別可以安全地獲取生命值
     UFUNCTION(BlueprintPure, Category = "Health") // BlueprintPure 表示它不修改對象狀態，沒有執行引腳
-    float GetCurrentHealth() const { return CurrentHealth; }
+    float GetCurrentHealth() const;
+
+    UFUNCTION(BlueprintPure, Category = "Health")
+    float GetMaxHealth() const;
 
     UFUNCTION(BlueprintPure, Category = "Health")
-    float GetMaxHealth() const { return MaxHealth; }
+    bool IsDead() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Health")
+    void SetMaxHealth(float NewMaxHealth);
+
+    // 在 UCharacterHealthSubsystem 中的句柄 (INDEX_NONE 表示未登錄)
+    int32 GetHealthHandle() const { return HealthHandle; }
+
+    // 在 UCharacterHitboxHistorySubsystem 中的句柄 (只在伺服器登錄，INDEX_NONE 表示未登錄)
+    int32 GetHitboxHistoryHandle() const { return HitboxHistoryHandle; }
+
+    // --- 角色池 (UCharacterPoolSubsystem) ---
+    // 從池中取出：移到 SpawnTransform、重設狀態並重新啟用，效果等同剛生成的角色 (只在伺服器呼叫)
+    virtual void OnAcquiredFromPool(const FTransform& SpawnTransform);
+
+    // 放回池中：隱藏並關閉碰撞、移動與 Tick，退出空間索引與命中框歷史 (因此也不再複製給客戶端)
+    virtual void OnReleasedToPool();
+
+    // 把角色恢復成剛生成時的狀態：生命值、無敵與移動；子類別覆寫以重設自己的組件
+    virtual void ResetPooledState();
+
+    bool IsInPool() const { return bInPool; }
 
 protected:
-    // 私有變數，用於追蹤無敵計時器
-    FTimerHandle InvincibilityTimerHandle;
-    bool bIsInInvincibility; // 是否處於無敵狀態
+    // --- 生命值 ---
+    int32 HealthHandle = INDEX_NONE;
+
+    // --- 生命值複製 (Push Model) ---
+    // 生命值量化為相對 MaxHealth 的 15 位元比例，最高位元為死亡旗標；
+    // 只有量化後的值改變時才標記為髒，回復等微小變化不會產生流量
+    UPROPERTY(ReplicatedUsing = OnRep_HealthState)
+    uint16 ReplicatedHealthState;
+
+    UFUNCTION()
+    void OnRep_HealthState();
+
+    UFUNCTION()
+    void OnRep_MaxHealth();
+
+    // 伺服器端：依目前的生命值更新 ReplicatedHealthState，有變化時標記為髒
+    void UpdateReplicatedHealthState();
+
+    static uint16 EncodeHealthState(float Health, float InMaxHealth, bool bDead);
+    static void DecodeHealthState(uint16 State, float InMaxHealth, float& OutHealth, bool& bOutDead);
+
+    // 快取的子系統指標，生命值的讀寫都經過它
+    UPROPERTY()
+    UCharacterHealthSubsystem* HealthSubsystem;
+
+    bool HasHealthHandle() const { return HealthSubsystem && HealthHandle != INDEX_NONE; }
+
+    // 將子系統中的生命值同步到藍圖可見的鏡像欄位
+    void SyncHealthMirror();
+
+    // 生命值變化後呼叫：立即廣播，或在合併模式下交給子系統
+    void NotifyHealthChanged();
+
+    // 死亡時的處理 (立即與批次路徑共用)
+    void HandleDeath();
+
+    // 是否處於無敵狀態
+    bool IsInInvincibility() const;
 
     // 呼叫以啟動無敵時間
     void StartInvincibility();
     // 呼叫以結束無敵時間
     void EndInvincibility();
 
+    // --- 空間索引 ---
+    // 在 UCharacterSpatialIndexSubsystem 中的句柄 (INDEX_NONE 表示未登錄)
+    int32 SpatialIndexHandle = INDEX_NONE;
+
+    // 快取的子系統指標，避免每次移動都查找子系統
+    UPROPERTY()
+    UCharacterSpatialIndexSubsystem* SpatialIndexSubsystem;
+
+    // --- 命中框歷史 (延遲補償) ---
+    int32 HitboxHistoryHandle = INDEX_NONE;
+
+    UPROPERTY()
+    UCharacterHitboxHistorySubsystem* HitboxHistorySubsystem;
+
+    // 登錄 / 退出空間索引與命中框歷史 (BeginPlay、EndPlay 與角色池共用)
+    void RegisterQueryIndices();
+    void UnregisterQueryIndices();
+
+    // --- 角色池 ---
+    bool bInPool = false;
+
+    // 放回池中前 Actor Tick 是否啟用 (子類別可能在 BeginPlay 依情況關閉)，取出時恢復
+    bool bActorTickEnabledBeforePool = false;
+
+    // 膠囊體移動時增量更新空間索引
+    void OnCapsuleTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
     // --- 藍圖可實現事件 (BlueprintImplementableEvent) ---
     // 這些事件將在藍圖子類中被實現，用於處理視覺和音效反饋
 
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ACharacterBase;
+
+/**
+ * 均勻網格的空間雜湊 (只對 XY 平面分格)。
+ * 每個條目以垂直膠囊體 (中心、半徑、半高) 表示，並只存放在其中心所在的格子裡，
+ * 因此查詢時會以目前最大的條目半徑擴張查詢範圍，確保跨格的膠囊不會被漏掉。
+ *
+ * 所有查詢都是保守的寬相 (broadphase) 測試：可能回傳稍微超出範圍的條目，
+ * 但不會漏掉任何真正相交的條目。精確測試交給呼叫端的窄相處理。
+ */
+class CHARACTERSAMPLE_API FCharacterSpatialHash
+{
+public:
+    explicit FCharacterSpatialHash(float InCellSize = 500.0f);
+
+    // 新增條目，回傳穩定的句柄 (移除前都不會改變)
+    int32 Add(ACharacterBase* Character, const FVector& Location, float Radius, float HalfHeight);
+
+    // 移除條目，句柄之後可能被重用
+    void Remove(int32 Handle);
+
+    // 更新條目位置；只有跨格時才會搬移格子資料
+    void Update(int32 Handle, const FVector& Location);
+
+    // 更新條目的膠囊尺寸
+    void UpdateShape(int32 Handle, float Radius, float HalfHeight);
+
+    // 半徑查詢：水平距離 <= Radius + 條目半徑，且垂直距離 <= Radius + 條目半高
+    void QueryRadius(const FVector& Center, float Radius, TArray<ACharacterBase*>& OutCharacters) const;
+
+    // 錐形查詢：在 Range 內且水平方向與 Direction 的夾角 <= HalfAngleDegrees (錐角以條目半徑所張的角度放寬)
+    void QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Range, TArray<ACharacterBase*>& OutCharacters) const;
+
+    // 線段查詢：以 Radius 掃掠 Start -> End 的球體 (即攻擊的掃掠形狀)
+    void QuerySegment(const FVector& Start, const FVector& End, float Radius, TArray<ACharacterBase*>& OutCharacters) const;
+
+    int32 Num() const { return NumEntries; }
+    float GetCellSize() const { return CellSize; }
+
+    // 取得條目目前記錄的位置與尺寸
+    const FVector& GetLocation(int32 Handle) const { return Entries[Handle].Location; }
+    float GetRadius(int32 Handle) const { return Entries[Handle].Radius; }
+    float GetHalfHeight(int32 Handle) const { return Entries[Handle].HalfHeight; }
+
+private:
+    struct FEntry
+    {
+        ACharacterBase* Character = nullptr; // nullptr 表示空閒槽位
+        FVector Location = FVector::ZeroVector;
+        float Radius = 0.0f;
+        float HalfHeight = 0.0f;
+        uint64 CellKey = 0;
+        int32 SlotInCell = INDEX_NONE; // 在格子陣列中的位置，用於 O(1) 移除
+    };
+
+    // 每個格子只存條目索引，大部分格子的角色數量很少，因此使用內嵌配置避免堆積配置
+    using FCell = TArray<int32, TInlineAllocator<8>>;
+
+    int32 ToCellCoord(double Value) const { return FMath::FloorToInt32(Value * InvCellSize); }
+    static uint64 MakeCellKey(int32 X, int32 Y) { return (uint64(uint32(X)) << 32) | uint64(uint32(Y)); }
+    uint64 GetCellKey(const FVector& Location) const { return MakeCellKey(ToCellCoord(Location.X), ToCellCoord(Location.Y)); }
+
+    void AddToCell(int32 Handle, uint64 CellKey);
+    void RemoveFromCell(int32 Handle);
+
+    // 對覆蓋 [Min, Max] 水平範圍的每個格子中的每個條目呼叫 Visitor
+    template <typename VisitorType>
+    void ForEachEntryInBounds(const FVector2D& Min, const FVector2D& Max, VisitorType&& Visitor) const;
+
+    float CellSize;
+    float InvCellSize;
+
+    // 目前登錄過的最大膠囊半徑，用來擴張查詢的格子範圍
+    float MaxEntryRadius = 0.0f;
+
+    TArray<FEntry> Entries;
+    TArray<int32> FreeList;
+    int32 NumEntries = 0;
+
+    TMap<uint64, FCell> Cells;
+};
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ====================================================================
+// >>> 戰鬥除錯輸出 <<<
+// 畫面訊息與日誌由 CharacterSample.Combat.DebugText 控制，
+// 除錯繪製由 CharacterSample.Combat.DebugDraw 控制，兩者預設關閉。
+// Shipping 版本中控制台變數與所有呼叫都會被完全移除；
+// 伺服器目標 (UE_SERVER) 沒有畫面，只保留日誌，畫面訊息與除錯繪製一併移除。
+// ====================================================================
+
+#define COMBAT_DEBUG_ENABLED (!UE_BUILD_SHIPPING)
+#define COMBAT_DEBUG_VISUALS_ENABLED (COMBAT_DEBUG_ENABLED && !UE_SERVER)
+
+#if COMBAT_DEBUG_ENABLED
+
+namespace CombatDebug
+{
+    extern CHARACTERSAMPLE_API bool bDebugText;
+
+#if COMBAT_DEBUG_VISUALS_ENABLED
+    extern CHARACTERSAMPLE_API bool bDebugDraw;
+
+    // 在畫面上顯示一行除錯訊息 (呼叫前應先檢查 bDebugText)
+    CHARACTERSAMPLE_API void AddOnScreenMessage(const FColor& Color, const TCHAR* Message);
+#endif
+}
+
+// 熱路徑上的一般日誌
+#define COMBAT_DEBUG_LOG(Format, ...) \
+    do { if (CombatDebug::bDebugText) { UE_LOG(LogTemp, Log, Format, ##__VA_ARGS__); } } while (0)
+
+#if COMBAT_DEBUG_VISUALS_ENABLED
+
+// 畫面除錯訊息
+#define COMBAT_DEBUG_MESSAGE(Color, Message) \
+    do { if (CombatDebug::bDebugText) { CombatDebug::AddOnScreenMessage(Color, Message); } } while (0)
+
+// 除錯繪製是否開啟；繪製程式碼本身仍需放在 #if ENABLE_DRAW_DEBUG 中
+#define COMBAT_DEBUG_DRAW_ENABLED() (CombatDebug::bDebugDraw)
+
+#else
+
+#define COMBAT_DEBUG_MESSAGE(Color, Message) do { } while (0)
+#define COMBAT_DEBUG_DRAW_ENABLED() (false)
+
+#endif
+
+#else
+
+#define COMBAT_DEBUG_MESSAGE(Color, Message) do { } while (0)
+#define COMBAT_DEBUG_LOG(Format, ...) do { } while (0)
+#define COMBAT_DEBUG_DRAW_ENABLED() (false)
+
+#endif
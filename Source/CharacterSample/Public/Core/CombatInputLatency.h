@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ====================================================================
+// >>> 攻擊輸入到蒙太奇開始的延遲 <<<
+// 只量測本地輸入 (Enhanced Input 的 Started 事件或機器人注入)，時間戳記來自 FPlatformTime：
+//   FrameStart  這一幀開始 (FApp::GetCurrentTime，作業系統輸入在這之後才被分派)
+//   Input       HandleComboInput 收到輸入
+//   Montage     Montage_Play 回傳，蒙太奇在這一幀的動畫更新開始產生姿勢
+// 直接開始的一段 (待機起手或窗口已開啟) 記錄三段延遲；
+// 緩衝輸入 (窗口開啟時才由 SetCanEnterNextCombo 或計時器消耗) 記錄按下到開始的時間，
+// 以及窗口開啟 (或按下) 的世界時間到實際處理之間的排程延遲。
+// 直方圖為整個行程共用，CharacterSample.Combat.InputLatency 輸出百分位數。
+// ====================================================================
+
+namespace CombatInputLatency
+{
+    // 一段連擊由本地輸入開始時呼叫 (呼叫時 Montage_Play 已回傳)
+    // InputPlatformTime：收到輸入時的 FPlatformTime::Seconds()
+    // bBuffered：輸入在取消窗口開啟前按下、之後才被消耗
+    // ResolveDelaySeconds：緩衝輸入從可接續的世界時間到實際處理的延遲
+    CHARACTERSAMPLE_API void RecordSegmentStart(double InputPlatformTime, bool bBuffered, double ResolveDelaySeconds);
+
+    CHARACTERSAMPLE_API void Reset();
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UCapsuleComponent;
+
+// ====================================================================
+// >>> 攻擊形狀：掃掠球體 <<<
+// 與 PerformNormalAttackHitCheck 相同：半徑 Radius 的球體從 Start 掃到 End
+// ====================================================================
+struct FCombatSweptSphere
+{
+    FVector3f Start = FVector3f::ZeroVector;
+    FVector3f End = FVector3f::ZeroVector;
+    float Radius = 0.0f;
+};
+
+// ====================================================================
+// >>> 以 Struct-of-Arrays 打包的直立膠囊體 <<<
+// 角色的 UCapsuleComponent 一律是直立的，因此只需要中心、核心半高 (不含半球) 與半徑。
+// 陣列長度會補齊到 4 的倍數，讓 SIMD 版本可以直接對齊載入；補齊的槽位不會被回報。
+// ====================================================================
+struct CHARACTERSAMPLE_API FCombatCapsuleSoA
+{
+    static constexpr int32 Lanes = 4;
+
+    void Reset();
+    void Reserve(int32 Count);
+
+    // 加入一個膠囊體，回傳其索引；HalfHeight 為 UE 的半高定義 (包含半球)
+    int32 Add(const FVector& Center, float Radius, float HalfHeight);
+
+    // 直接從角色的膠囊體組件讀取位置與尺寸
+    int32 Add(const UCapsuleComponent* Capsule);
+
+    int32 Num() const { return NumCapsules; }
+
+    TArray<float, TAlignedHeapAllocator<16>> CenterX;
+    TArray<float, TAlignedHeapAllocator<16>> CenterY;
+    TArray<float, TAlignedHeapAllocator<16>> CenterZ;
+    TArray<float, TAlignedHeapAllocator<16>> CoreHalfHeight; // 半高扣除半徑後的線段半長
+    TArray<float, TAlignedHeapAllocator<16>> Radius;
+
+private:
+    int32 NumCapsules = 0;
+};
+
+/**
+ * 掃掠球體對直立膠囊體的窄相測試。
+ * 兩者都可化為「線段之間的最近距離 <= 半徑和」，這裡以無分支的形式實作，
+ * 讓純量版本與 SIMD 版本 (UE 的 VectorRegister4Float，x64 上為 SSE) 逐條執行完全相同的浮點運算，
+ * 因此兩者的結果逐位元一致。
+ */
+namespace CombatNarrowphase
+{
+    // 單一膠囊體的純量測試
+    CHARACTERSAMPLE_API bool SweptSphereVsCapsule(const FCombatSweptSphere& Sweep, float CenterX, float CenterY, float CenterZ, float CoreHalfHeight, float CapsuleRadius);
+
+    // 純量版本：將命中的膠囊體索引 (遞增順序) 加入 OutHitIndices，回傳命中數
+    CHARACTERSAMPLE_API int32 SweptSphereVsCapsulesScalar(const FCombatSweptSphere& Sweep, const FCombatCapsuleSoA& Capsules, TArray<int32>& OutHitIndices);
+
+    // SIMD 版本：一次測試 4 個膠囊體，輸出與純量版本完全相同
+    CHARACTERSAMPLE_API int32 SweptSphereVsCapsulesSIMD(const FCombatSweptSphere& Sweep, const FCombatCapsuleSoA& Capsules, TArray<int32>& OutHitIndices);
+}
@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 無渲染、無動畫的固定步長戰鬥模擬器。
+ * 在獨立的遊戲世界中生成成對對戰的角色，CombatComponent 以無頭模式執行
+ * (蒙太奇通知改由 GameplayTimerSubsystem 依連擊圖的時間軸事件觸發)，
+ * 並以腳本化的隨機輸入驅動連擊、命中與傷害。可在 -nullrhi 下執行。
+ */
+namespace CombatSimulator
+{
+    struct FSettings
+    {
+        int32 NumCharacters = 100; // 角色數量 (兩兩一組對戰，奇數時會補成偶數)
+        float DurationSeconds = 60.0f; // 模擬的遊戲時間 (秒)
+        float StepHz = 30.0f;      // 固定步長的頻率
+        int32 Seed = 1234;         // 輸入腳本的亂數種子
+
+        float MinInputInterval = 0.15f; // 每個角色兩次攻擊輸入之間的間隔範圍 (秒)
+        float MaxInputInterval = 0.4f;
+        float HeavyAttackChance = 0.1f; // 輸入為重攻擊的機率
+    };
+
+    // 執行一次模擬並將結果輸出到日誌；無法建立世界時回傳 false
+    CHARACTERSAMPLE_API bool Run(const FSettings& Settings);
+}
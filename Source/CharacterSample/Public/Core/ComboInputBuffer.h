@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/ComboGraphDataAsset.h" // EComboInput
+
+// 一次連擊輸入：種類與按下時的世界時間 (預測輸入在伺服器上為客戶端按下的時間)
+struct FComboInputEvent
+{
+    EComboInput Input = EComboInput::Light;
+    double Time = 0.0;
+    double InputPlatformTime = 0.0; // 本地輸入時收到輸入的 FPlatformTime，用於延遲量測；其他來源為 0
+};
+
+/**
+ * 固定容量的連擊輸入環形緩衝區。
+ * 輸入在輪詢時依到達順序寫入並帶上時間戳記，取消窗口開啟時由最舊的開始消耗；
+ * 是否過期、是否落在窗口內由呼叫端以時間戳記判定。緩衝區滿時覆蓋最舊的輸入，不會配置記憶體。
+ */
+class FComboInputBuffer
+{
+public:
+    static constexpr int32 Capacity = 8;
+
+    void Push(EComboInput Input, double Time, double InputPlatformTime = 0.0)
+    {
+        if (Count == Capacity)
+        {
+            Head = (Head + 1) & Mask;
+            --Count;
+        }
+        FComboInputEvent& Event = Events[(Head + Count) & Mask];
+        Event.Input = Input;
+        Event.Time = Time;
+        Event.InputPlatformTime = InputPlatformTime;
+        ++Count;
+    }
+
+    // 取出最舊的輸入；緩衝區為空時回傳 false
+    bool PopOldest(FComboInputEvent& OutEvent)
+    {
+        if (Count == 0)
+        {
+            return false;
+        }
+        OutEvent = Events[Head];
+        Head = (Head + 1) & Mask;
+        --Count;
+        return true;
+    }
+
+    int32 Num() const { return Count; }
+    bool IsEmpty() const { return Count == 0; }
+
+    void Reset()
+    {
+        Head = 0;
+        Count = 0;
+    }
+
+private:
+    static constexpr int32 Mask = Capacity - 1;
+    static_assert((Capacity & Mask) == 0, "Capacity must be a power of two.");
+
+    FComboInputEvent Events[Capacity];
+    int32 Head = 0;
+    int32 Count = 0;
+};
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ACharacterBase;
+class UWorld;
+
+/**
+ * 效能測試用的群眾生成工具。
+ * 各個 Benchmark 控制台指令共用，用來在目前的世界中生成大量不 Tick 的 ACharacterBase。
+ */
+namespace CrowdBenchmark
+{
+    // 在 Center 周圍的正方形區域內隨機生成 Count 個角色，區域大小依 Spacing 隨數量調整以維持密度
+    CHARACTERSAMPLE_API TArray<ACharacterBase*> SpawnCrowd(UWorld* World, int32 Count, const FVector& Center, float Spacing, FRandomStream& RandomStream);
+
+    // 銷毀由 SpawnCrowd 生成的角色
+    CHARACTERSAMPLE_API void DestroyCrowd(TArray<ACharacterBase*>& Crowd);
+
+    // 群眾區域的半邊長
+    CHARACTERSAMPLE_API float GetCrowdHalfExtent(int32 Count, float Spacing);
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 固定記憶體的延遲直方圖。
+ * 以微秒為單位、每 2 倍分成 BucketsPerOctave 個對數桶 (相對誤差約 19%)，
+ * 涵蓋 1 微秒到約 70 分鐘；最小、最大與平均值則精確記錄。
+ * 新增樣本不會配置記憶體，適合在熱路徑或每幀記錄。
+ */
+struct CHARACTERSAMPLE_API FLatencyHistogram
+{
+    static constexpr int32 BucketsPerOctave = 4;
+    static constexpr int32 NumBuckets = 32 * BucketsPerOctave;
+
+    FLatencyHistogram() { Reset(); }
+
+    void Reset();
+
+    // 新增一筆樣本 (毫秒)
+    void AddSampleMs(double Milliseconds);
+
+    // 合併另一個直方圖
+    void Merge(const FLatencyHistogram& Other);
+
+    int64 Num() const { return Count; }
+    double GetMinMs() const { return Count > 0 ? MinMs : 0.0; }
+    double GetMaxMs() const { return Count > 0 ? MaxMs : 0.0; }
+    double GetMeanMs() const { return Count > 0 ? SumMs / Count : 0.0; }
+
+    // 百分位數 (0 - 100)，回傳所在桶的上界，並以實際最大值為上限
+    double GetPercentileMs(double Percentile) const;
+
+    // 單行摘要：n / mean / p50 / p90 / p99 / max
+    FString ToString() const;
+
+private:
+    static int32 GetBucketIndex(double Microseconds);
+    static double GetBucketUpperBoundMs(int32 BucketIndex);
+
+    int64 Buckets[NumBuckets];
+    int64 Count;
+    double SumMs;
+    double MinMs;
+    double MaxMs;
+};
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ====================================================================
+// >>> 冷啟動時間分解 <<<
+// 以行程開始 (GStartTime) 為零點記錄每個階段第一次的開始與結束：
+//   ModuleStartup        行程開始到遊戲模組的 StartupModule 完成 (引擎初始化與模組載入)
+//   MapLoad              第一次 LoadMap (PreLoadMap -> PostLoadMapWithWorld)
+//   ClassLoad            GameMode 串流玩家控制器與角色類別 (InitGame -> 載入完成)
+//   FirstPossessedFrame  本地玩家控制器第一次擁有 Pawn 的那一幀結束
+// 第一個被擁有的幀結束時自動輸出一次報告；-CharacterSampleStartupBenchmark 時輸出後結束行程。
+// CharacterSample.Startup.Report 可隨時輸出目前已記錄的階段。
+// ====================================================================
+
+namespace StartupTiming
+{
+    enum class EStage : uint8
+    {
+        ModuleStartup,
+        MapLoad,
+        ClassLoad,
+        FirstPossessedFrame,
+        Count
+    };
+
+    // 由模組的 StartupModule 結尾呼叫：結束模組階段並開始監聽地圖載入與第一個被擁有的幀
+    CHARACTERSAMPLE_API void Initialize();
+    CHARACTERSAMPLE_API void Shutdown();
+
+    // 只記錄每個階段的第一次開始與結束
+    CHARACTERSAMPLE_API void BeginStage(EStage Stage);
+    CHARACTERSAMPLE_API void EndStage(EStage Stage);
+
+    // 登入時仍需同步等待類別載入完成的時間 (非同步載入沒能完全藏住的部分)
+    CHARACTERSAMPLE_API void AddClassLoadWaitMs(double WaitMs);
+
+    CHARACTERSAMPLE_API void Report();
+}
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// ====================================================================
+// >>> 計時器句柄 <<<
+// 槽位索引 + 世代計數：槽位被重用後，舊句柄會因世代不符而自動失效
+// ====================================================================
+struct FTimingWheelHandle
+{
+    int32 Index = INDEX_NONE;
+    uint32 Generation = 0;
+
+    bool IsValid() const { return Index != INDEX_NONE; }
+    void Invalidate() { Index = INDEX_NONE; Generation = 0; }
+};
+
+/**
+ * 階層式時間輪 (hierarchical timing wheel)，用於大量短期的遊戲期限 (連擊窗口等)。
+ * 時間以固定長度的刻度 (tick) 表示，共 NumLevels 層，每層 SlotsPerLevel 個槽位；
+ * 第 L 層的每個槽位涵蓋 SlotsPerLevel^L 個刻度，較遠的期限放在較高層，
+ * 當低層轉完一圈時再把高層對應槽位中的計時器往下分配 (cascade)。
+ *
+ * 每個計時器是節點池中的一個節點，以侵入式雙向串列掛在槽位上，
+ * 因此設定與取消都是 O(1)，且節點池重複使用，不會在執行期反覆配置。
+ */
+class CHARACTERSAMPLE_API FTimingWheel
+{
+public:
+    static constexpr int32 SlotBits = 6;
+    static constexpr int32 SlotsPerLevel = 1 << SlotBits; // 64
+    static constexpr int32 NumLevels = 4;                  // 最長 64^4 個刻度
+    static constexpr uint64 SlotMask = SlotsPerLevel - 1;
+    static constexpr uint64 MaxDelayTicks = (uint64(1) << (SlotBits * NumLevels)) - 1;
+
+    FTimingWheel();
+
+    // 設定一個在 ExpireTick 到期的計時器；ExpireTick 早於目前刻度時會在下一次 Advance 立即到期
+    FTimingWheelHandle Arm(uint64 ExpireTick, FSimpleDelegate&& Callback);
+
+    // 取消計時器並使句柄失效；句柄已失效或計時器已到期時回傳 false
+    bool Cancel(FTimingWheelHandle& Handle);
+
+    // 計時器是否仍在等待到期或等待執行
+    bool IsArmed(const FTimingWheelHandle& Handle) const;
+
+    // 推進到 TargetTick (含)，將到期的計時器依到期順序附加到 OutExpired。
+    // 節點在這裡只從槽位取下，仍可被 Cancel；呼叫端必須對每個句柄呼叫 TakeExpired 取出回調並釋放節點
+    void Advance(uint64 TargetTick, TArray<FTimingWheelHandle>& OutExpired);
+
+    // 取出已到期計時器的回調並釋放節點；計時器在 Advance 之後已被取消 (或句柄失效) 時回傳 false
+    bool TakeExpired(const FTimingWheelHandle& Handle, FSimpleDelegate& OutCallback);
+
+    // 下一個尚未處理的刻度
+    uint64 GetNextTick() const { return NextTick; }
+
+    // 重設目前刻度 (只能在沒有任何計時器時呼叫)
+    void ResetTick(uint64 Tick);
+
+    int32 Num() const { return NumArmed; }
+
+    // 丟棄所有計時器
+    void Reset();
+
+private:
+    struct FNode
+    {
+        FSimpleDelegate Callback;
+        uint64 ExpireTick = 0;
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+        int32 Slot = INDEX_NONE; // 所在的槽位 (Level * SlotsPerLevel + Index)，INDEX_NONE 表示空閒，ExpiredSlot 表示已到期等待執行
+        uint32 Generation = 1;
+    };
+
+    static constexpr int32 ExpiredSlot = -2;
+
+    // 依到期刻度與目前刻度選擇槽位並掛上串列
+    void Link(int32 NodeIndex);
+
+    // 從所在槽位的串列中移除
+    void Unlink(int32 NodeIndex);
+
+    // 釋放節點並遞增世代，使舊句柄失效
+    void Free(int32 NodeIndex);
+
+    // 把第 Level 層目前槽位中的節點重新分配到較低層
+    void Cascade(int32 Level);
+
+    TArray<FNode> Nodes;
+    TArray<int32> FreeNodes;
+    int32 SlotHeads[NumLevels * SlotsPerLevel];
+
+    uint64 NextTick = 0;
+    int32 NumArmed = 0;
+};
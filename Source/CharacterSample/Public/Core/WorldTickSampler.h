@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h" // ELevelTick
+
+class UWorld;
+
+/**
+ * 量測一個世界每幀 Actor 與可 Tick 子系統的遊戲執行緒時間 (OnWorldTickStart 到 OnWorldPostActorTick)。
+ * 固定 Tick 率的伺服器大部分時間在等待下一幀，牆鐘的幀時間看不出實際的工作量。
+ * 需要以 TSharedRef 持有 (委託以 AddSP 綁定)，效能測試的控制台指令共用。
+ */
+class CHARACTERSAMPLE_API FWorldTickSampler : public TSharedFromThis<FWorldTickSampler>
+{
+public:
+    struct FSample
+    {
+        int32 NumFrames = 0;
+        double AverageMs = 0.0; // 平均每幀的 Tick 時間
+        double MaxMs = 0.0;     // 取樣期間最慢的一幀
+        double FrameIntervalMs = 0.0; // 平均幀間隔 (牆鐘)
+    };
+
+    explicit FWorldTickSampler(UWorld* InWorld);
+
+    void Start();
+    void Stop();
+
+    // 回傳上次呼叫以來的統計並重新開始累計
+    FSample Consume();
+
+private:
+    void HandleTickStart(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds);
+    void HandlePostActorTick(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds);
+
+    TWeakObjectPtr<UWorld> World;
+    FDelegateHandle TickStartHandle;
+    FDelegateHandle PostActorTickHandle;
+
+    double TickStartTime = 0.0;
+    double SampleStartTime = 0.0;
+    double TotalSeconds = 0.0;
+    double MaxSeconds = 0.0;
+    int32 NumFrames = 0;
+};
@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ComboGraphDataAsset.generated.h"
+
+class UAnimMontage;
+
+// 連擊輸入種類
+UENUM(BlueprintType)
+enum class EComboInput : uint8
+{
+    Light,
+    Heavy,
+
+    Count UMETA(Hidden)
+};
+
+// ====================================================================
+// >>> 編輯用資料 (設計師在資產中填寫) <<<
+// ====================================================================
+
+// 每段攻擊的命中形狀：從武器插槽沿角色前方掃掠的球體
+USTRUCT(BlueprintType)
+struct FComboHitShape
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    float Radius = 70.0f; // 球體半徑
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    float Reach = 150.0f; // 掃掠長度
+};
+
+// 一條連擊轉移：在目前這段按下 Input 時跳到 TargetSegment
+USTRUCT(BlueprintType)
+struct FComboTransition
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    EComboInput Input = EComboInput::Light;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    FName TargetSegment;
+};
+
+// 一段連擊
+USTRUCT(BlueprintType)
+struct FComboSegmentDefinition
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    FName SegmentName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    UAnimMontage* Montage = nullptr;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo", meta = (ClampMin = "0.01"))
+    float PlayRate = 1.0f;
+
+    // 取消窗口開啟時間 (從這段開始算起的秒數)；小於 0 表示由 Anim Notify 呼叫 SetCanEnterNextCombo 開啟
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    float CancelWindowStart = -1.0f;
+
+    // 取消窗口關閉時間 (從這段開始算起的秒數)；小於 0 表示持續到這段結束
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    float CancelWindowEnd = -1.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    float Damage = 25.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    FComboHitShape HitShape;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    TArray<FComboTransition> Transitions;
+};
+
+// ====================================================================
+// >>> 時間軸事件 <<<
+// 編譯時從蒙太奇的具名 Notify 取出，無頭模擬時取代 Anim Notify 驅動 UCombatComponent
+// ====================================================================
+enum class EComboTimelineEvent : uint8
+{
+    HitCheck,             // "HitCheck" -> PerformNormalAttackHitCheck
+    OpenComboWindow,      // "NextCombo" -> SetCanEnterNextCombo(true)
+    ConsumeBufferedInput, // "SaveAttack" -> 若窗口已開啟則消耗緩衝輸入
+    BeginHitWindow,       // "HitWindow" Notify State 開始 -> BeginAttackHitWindow
+    EndHitWindow,         // "HitWindow" Notify State 結束 -> EndAttackHitWindow
+};
+
+struct FComboTimelineEntry
+{
+    float Time = 0.0f; // 從這段開始算起的秒數 (已除以 PlayRate)
+    EComboTimelineEvent Event = EComboTimelineEvent::HitCheck;
+};
+
+// ====================================================================
+// >>> 編譯後的執行期資料 <<<
+// 載入時由資產編譯成扁平陣列，執行期每次輸入只需一次查表，不再查詢蒙太奇
+// ====================================================================
+
+struct FCompiledComboSegment
+{
+    UAnimMontage* Montage = nullptr;
+    float PlayRate = 1.0f;
+    float Duration = 0.0f;          // 蒙太奇長度 / PlayRate (載入時計算)
+    float CancelWindowStart = -1.0f; // 小於 0 表示由 Anim Notify 開啟
+    float CancelWindowEnd = 0.0f;    // 已解析為實際秒數
+    float RecoveryEnd = 0.0f;        // 超過此時間仍未接續則重置連擊
+    float Damage = 0.0f;
+    float HitRadius = 0.0f;
+    float HitReach = 0.0f;
+
+    TArray<FComboTimelineEntry> Timeline; // 依時間排序
+};
+
+struct CHARACTERSAMPLE_API FCompiledComboGraph
+{
+    static constexpr int32 NumInputs = static_cast<int32>(EComboInput::Count);
+
+    TArray<FCompiledComboSegment> Segments;
+
+    // 轉移表：第 0 列為待機狀態，第 i + 1 列為第 i 段；值為目標段索引或 INDEX_NONE
+    TArray<int16> TransitionTable;
+
+    bool IsValid() const { return Segments.Num() > 0; }
+
+    // 查詢下一段；CurrentSegment 為 INDEX_NONE 時表示從待機開始
+    int32 GetNextSegment(int32 CurrentSegment, EComboInput Input) const
+    {
+        return TransitionTable[(CurrentSegment + 1) * NumInputs + static_cast<int32>(Input)];
+    }
+
+    // 從編輯用資料編譯
+    void Compile(const TArray<FComboSegmentDefinition>& SegmentDefinitions, const TArray<FComboTransition>& EntryTransitions, float ComboResetGrace, const UObject* Owner);
+
+    // 舊版資料：將 AttackMontages 陣列編譯成只有 Light 輸入的線性連擊
+    void CompileLinear(const TArray<UAnimMontage*>& Montages, float ComboResetGrace);
+};
+
+/**
+ * 分支連擊圖資產 (輕 / 重攻擊、取消窗口、每段的命中形狀與傷害)。
+ * 載入時編譯成 FCompiledComboGraph，UCombatComponent 在執行期只讀取編譯後的資料。
+ */
+UCLASS(BlueprintType)
+class CHARACTERSAMPLE_API UComboGraphDataAsset : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    // 待機狀態下各輸入的起手段
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    TArray<FComboTransition> EntryTransitions;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo")
+    TArray<FComboSegmentDefinition> Segments;
+
+    // 每段結束後額外等待的時間，超過仍未接續才重置連擊
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Combo", meta = (ClampMin = "0.0"))
+    float ComboResetGrace = 0.1f;
+
+    const FCompiledComboGraph& GetCompiledGraph() const { return CompiledGraph; }
+
+    // 重新編譯 (載入與編輯後會自動呼叫)
+    void Compile();
+
+    virtual void PostLoad() override;
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+    FCompiledComboGraph CompiledGraph;
+};
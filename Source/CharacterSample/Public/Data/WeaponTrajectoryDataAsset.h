@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "WeaponTrajectoryDataAsset.generated.h"
+
+class UAnimMontage;
+
+// ====================================================================
+// >>> 烘焙的武器軌跡 <<<
+// 以固定取樣率記錄武器插槽在角色空間 (相對於 Actor 變換) 的位置，
+// 每個軸量化為 16 位元 (精度 = 該軸範圍 / 65535，一般揮擊遠小於 0.1 公分)。
+// 時間為蒙太奇本身的播放位置 (未除以 PlayRate)。
+// ====================================================================
+USTRUCT()
+struct CHARACTERSAMPLE_API FBakedWeaponTrajectory
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, Category = "Trajectory")
+    float SampleRate = 60.0f; // 每秒取樣數
+
+    UPROPERTY(VisibleAnywhere, Category = "Trajectory")
+    FVector QuantizationMin = FVector::ZeroVector; // 量化範圍的最小值
+
+    UPROPERTY(VisibleAnywhere, Category = "Trajectory")
+    FVector QuantizationExtent = FVector::ZeroVector; // 量化範圍的大小
+
+    // 依序交錯存放每個取樣的 X / Y / Z
+    UPROPERTY()
+    TArray<uint16> QuantizedSamples;
+
+    int32 NumSamples() const { return QuantizedSamples.Num() / 3; }
+    bool IsValid() const { return NumSamples() > 0; }
+
+    // 將角色空間的取樣點量化後存入
+    void Encode(const TArray<FVector>& Positions, float InSampleRate);
+
+    // 取得蒙太奇播放位置 MontageTime 時的角色空間位置 (線性內插，超出範圍時夾住)
+    FVector Evaluate(float MontageTime) const;
+
+private:
+    FVector DecodeSample(int32 SampleIndex) const;
+};
+
+/**
+ * 由 UWeaponTrajectoryBakeCommandlet 離線產生的武器軌跡資產。
+ * 命中窗口以此取代逐幀的 GetSocketLocation，命中檢測不再依賴骨架網格的姿勢計算，
+ * 因此遠處或動畫被節流的角色仍能正確且廉價地攻擊。
+ */
+UCLASS(BlueprintType)
+class CHARACTERSAMPLE_API UWeaponTrajectoryDataAsset : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    // 烘焙時取樣的插槽
+    UPROPERTY(VisibleAnywhere, Category = "Trajectory")
+    FName SocketName;
+
+    // 以軟引用為鍵：角色藍圖引用這個資產時不會連帶同步載入所有攻擊蒙太奇 (蒙太奇由預載子系統串流)
+    UPROPERTY(VisibleAnywhere, Category = "Trajectory")
+    TMap<TSoftObjectPtr<UAnimMontage>, FBakedWeaponTrajectory> Trajectories;
+
+    // 以已載入蒙太奇的路徑查詢
+    const FBakedWeaponTrajectory* FindTrajectory(UAnimMontage* Montage) const
+    {
+        const FBakedWeaponTrajectory* Trajectory = Montage ? Trajectories.Find(TSoftObjectPtr<UAnimMontage>(Montage)) : nullptr;
+        return Trajectory && Trajectory->IsValid() ? Trajectory : nullptr;
+    }
+};
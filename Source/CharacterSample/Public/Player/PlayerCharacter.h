@@ -23,6 +23,7 @@ class UCombatComponent;
 class UCharacterInputManagerComponent; // 前向聲明我們的輸入管理組件
 class UEntranceAnimationComponent; // 前向聲明入場動畫組件
 class UAnimMontage; // 雖然攻擊蒙太奇移走了，但入場動畫還在這裡
+class UCharacterAnimVariablesSubsystem; // 前向聲明動畫變數子系統
 
 UCLASS()
 class CHARACTERSAMPLE_API APlayerCharacter : public ACharacterBase
@@ -90,7 +91,23 @@ public:
      */
     void SetPlayerInputEnabled(bool bEnabled);
 
+    // --- 角色池 ---
+    // 重用時重新播放入場動畫，並把動畫變數交回子系統批次更新
+    virtual void OnAcquiredFromPool(const FTransform& SpawnTransform) override;
+    virtual void OnReleasedToPool() override;
+
+    // 額外重設連擊 (計時器、輸入緩衝、命中窗口)、入場動畫與正在播放的蒙太奇
+    virtual void ResetPooledState() override;
+
 protected:
     // BeginPlay：在遊戲開始時或角色被生成時呼叫
     virtual void BeginPlay() override;
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // 在 UCharacterAnimVariablesSubsystem 中的句柄 (INDEX_NONE 表示由自己的 Tick 更新)
+    int32 AnimVariablesHandle = INDEX_NONE;
+
+    UPROPERTY()
+    UCharacterAnimVariablesSubsystem* AnimVariablesSubsystem;
 };
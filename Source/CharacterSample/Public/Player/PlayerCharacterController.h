@@ -7,6 +7,8 @@
 #include "PlayerCharacterController.generated.h"
 
 class UHealthBarBaseWidget;
+class UCharacterBotInputComponent;
+class SCrowdHealthBars;
 
 /**
  * 
@@ -34,13 +36,29 @@ private:
 	// 負責創建和設定血條 Widget 的輔助函式
     void CreateAndSetupHealthBarWidget();
 
+    // 其他受傷角色的血條：一個 Slate 元件在一次繪製中畫出全部 (CharacterSample.UI.CrowdHealthBars)
+    TSharedPtr<SCrowdHealthBars> CrowdHealthBars;
+
+    void CreateCrowdHealthBars();
+    void RemoveCrowdHealthBars();
+
+	// 負載測試時取代真人輸入的機器人 (-CharacterSampleBot 或 CharacterSample.Bot.Toggle)
+    UPROPERTY()
+    UCharacterBotInputComponent* BotInputComponent;
+
 public:
 	// 構造函數：設定控制器的預設值
 	APlayerCharacterController();
 
+    // 開始或停止以機器人注入輸入 (只對本地控制器有效)
+    void SetBotInputEnabled(bool bEnabled);
+
+    bool IsBotInputEnabled() const { return BotInputComponent != nullptr; }
+
 protected:
     // BeginPlay：在遊戲開始時或角色被生成時呼叫
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	// 當 PlayerController 擁有（Possess）一個新的 Pawn 時會被呼叫
     virtual void OnPossess(APawn* InPawn) override;
     // 當 PlayerController 失去（UnPossess）一個 Pawn 時會被呼叫
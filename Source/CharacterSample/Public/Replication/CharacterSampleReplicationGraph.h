@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "Core/LatencyHistogram.h"
+#include "CharacterSampleReplicationGraph.generated.h"
+
+class UCharacterSpatialIndexSubsystem;
+
+// ====================================================================
+// >>> 群眾角色節點 <<<
+// 不自行保存角色清單，而是以 UCharacterSpatialIndexSubsystem 的空間雜湊 (網格) 查詢每個視角附近的角色，
+// 並依距離設定這個連線對每個角色的複製週期：近處每幀、中距離每 2 幀、遠處每 4 幀，超過剔除距離不複製。
+// ====================================================================
+UCLASS()
+class CHARACTERSAMPLE_API UCharacterCrowdReplicationGraphNode : public UReplicationGraphNode
+{
+    GENERATED_BODY()
+
+public:
+    virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override { }
+    virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override { return false; }
+    virtual void NotifyResetAllNetworkActors() override { }
+    virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+    UPROPERTY()
+    UCharacterSpatialIndexSubsystem* SpatialIndexSubsystem = nullptr;
+
+private:
+    // 連線是依序收集並複製的，因此各連線共用同一份暫存清單
+    FActorRepListRefView GatheredCharacters;
+    TArray<class ACharacterBase*> ScratchCandidates;
+};
+
+// ====================================================================
+// >>> 連線專屬節點 <<<
+// 一律讓連線自己的 PlayerController、操控的 APlayerCharacter 與視角目標保持相關，不受距離剔除影響；
+// 由這個連線擁有的 bOnlyRelevantToOwner Actor 也由這裡複製
+// ====================================================================
+UCLASS()
+class CHARACTERSAMPLE_API UCharacterOwnerReplicationGraphNode : public UReplicationGraphNode_ActorList
+{
+    GENERATED_BODY()
+
+public:
+    virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+    void AddOwnerOnlyActor(AActor* Actor) { OwnerOnlyActors.ConditionalAdd(Actor); }
+    bool RemoveOwnerOnlyActor(AActor* Actor) { return OwnerOnlyActors.RemoveFast(Actor); }
+
+private:
+    // 只對擁有者相關、且擁有連線為這個連線的 Actor
+    FActorRepListRefView OwnerOnlyActors;
+};
+
+/**
+ * 專案的複製圖 (Replication Graph)，取代逐連線逐 Actor 的 IsNetRelevantFor 檢查。
+ * - ACharacterBase：UCharacterCrowdReplicationGraphNode (空間索引 + 依距離的更新頻率)
+ * - bAlwaysRelevant (GameState、PlayerState…)：全域的 AlwaysRelevant 節點
+ * - 連線自己的控制器與角色，以及 bOnlyRelevantToOwner 的 Actor：擁有連線的 UCharacterOwnerReplicationGraphNode
+ * - 其他會移動的 Actor：引擎的 2D 網格節點
+ *
+ * 由 FCharacterSampleModule 綁定 UReplicationDriver::CreateReplicationDriverDelegate 建立，
+ * 可用 CharacterSample.RepGraph.Enable 0 在下一次建立 NetDriver 時改回預設的相關性檢查。
+ */
+UCLASS(Transient)
+class CHARACTERSAMPLE_API UCharacterSampleReplicationGraph : public UReplicationGraph
+{
+    GENERATED_BODY()
+
+public:
+    // 由模組的 CreateReplicationDriverDelegate 呼叫；只為遊戲 NetDriver 建立，關閉時回傳 nullptr
+    static UReplicationDriver* CreateForNetDriver(UNetDriver* ForNetDriver, const FURL& URL, UWorld* World);
+
+    virtual void InitGlobalActorClassSettings() override;
+    virtual void InitGlobalGraphNodes() override;
+    virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+    virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+    virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+    virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+
+    // 計時每幀的 ServerReplicateActors (CharacterSample.RepGraph.Stats 輸出)
+    virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+    const FLatencyHistogram& GetReplicateActorsHistogram() const { return ReplicateActorsHistogram; }
+    void ResetStats() { ReplicateActorsHistogram.Reset(); }
+
+private:
+    // 把只對擁有者相關的 Actor 交給擁有連線的節點；擁有連線還不明時回傳 false
+    bool RouteOwnerOnlyActor(AActor* Actor);
+
+    UPROPERTY()
+    UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+    UPROPERTY()
+    UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+    UPROPERTY()
+    UCharacterCrowdReplicationGraphNode* CrowdNode;
+
+    // 每個連線的專屬節點
+    UPROPERTY()
+    TMap<UNetConnection*, UCharacterOwnerReplicationGraphNode*> OwnerNodes;
+
+    // 加入時還沒有擁有連線的 bOnlyRelevantToOwner Actor (例如生成後才設定擁有者)，每個複製幀重試
+    UPROPERTY()
+    TArray<AActor*> PendingOwnerOnlyActors;
+
+    FLatencyHistogram ReplicateActorsHistogram;
+};
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterAnimVariablesSubsystem.generated.h"
+
+class APlayerCharacter;
+class UCharacterMovementComponent;
+
+/**
+ * 批次更新所有 APlayerCharacter 的動畫變數 (CurrentSpeed、bIsFalling、MovementDirection)。
+ * 取代每個角色各自的 Actor Tick：在遊戲執行緒上把速度與 Yaw 收集到緊密陣列，
+ * 以 ParallelFor 一次計算全部角色，再寫回角色供動畫藍圖讀取。
+ *
+ * 子系統在所有 Tick 群組之後執行，結果由下一幀的動畫更新讀取；
+ * 角色移動同樣在 Tick 群組中更新速度，因此與原本 Actor Tick 的延遲相同。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCharacterAnimVariablesSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // 登錄角色並回傳句柄 (槽位索引，移除後重複使用)
+    int32 RegisterCharacter(APlayerCharacter* Character);
+
+    void UnregisterCharacter(int32 Handle);
+
+    int32 GetNumRegistered() const { return NumRegistered; }
+
+    // 由速度與角色 Yaw 計算速度大小與相對於角色前方的移動方向 (度，0 = 前方，90 = 右方)
+    // 逐 Actor 的備用路徑也使用同一個函式，確保結果一致
+    static void ComputeAnimVariables(const FVector3f& Velocity, float ActorYaw, float& OutSpeed, float& OutDirection);
+
+    // --- UTickableWorldSubsystem ---
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    // --- 冷資料：登錄時設定 ---
+    TArray<APlayerCharacter*> Characters; // 未登錄的槽位為 nullptr
+    TArray<UCharacterMovementComponent*> MovementComponents;
+
+    // --- 每幀收集的輸入與計算結果 ---
+    TArray<FVector3f> Velocities;
+    TArray<float> ActorYaws;
+    TArray<float> Speeds;
+    TArray<float> Directions;
+
+    TArray<int32> FreeList;
+    int32 NumRegistered = 0;
+};
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/ObjectKey.h"
+#include "CharacterAssetPreloadSubsystem.generated.h"
+
+class AGameModeBase;
+class AGameStateBase;
+
+/**
+ * 角色表演資產 (攻擊與入場蒙太奇，以及蒙太奇通知引用的特效) 的串流預載。
+ * 這些資產在組件上是軟引用，載入角色藍圖時不會一起被同步載入；
+ * 改為在生成或擁有角色之前，以角色類別的預設物件收集路徑並發出非同步載入：
+ *   伺服器與單機：GameMode 初始化時預載 DefaultPawnClass (早於任何玩家生成)
+ *   客戶端：GameState 複製到達 (UWorld::GameStateSetEvent) 後依複製過來的 GameModeClass 預載
+ *           (ACharacterSampleGameMode 的軟類別先串流類別本身)
+ * 句柄保存到世界結束，讓之後生成的同類角色不需要重新載入。
+ * 組件自己也會對同一批路徑發出請求並等待句柄 (已在載入中時只是等待同一個請求)。
+ * CharacterSample.Preload.Async 0 改回同步載入，用於比較生成時的卡頓。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCharacterAssetPreloadSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // 開始 (或取得已存在的) 角色類別預載；類別沒有需要預載的資產時回傳空句柄
+    TSharedPtr<FStreamableHandle> PreloadCharacterClass(const UClass* CharacterClass);
+
+    // 依 CharacterSample.Preload.Async 以非同步或同步方式載入 Paths，全部載入後呼叫 OnLoaded。
+    // Paths 為空時立即呼叫 OnLoaded 並回傳空句柄；呼叫端持有句柄期間資產不會被回收
+    static TSharedPtr<FStreamableHandle> RequestAssets(TArray<FSoftObjectPath> Paths, FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+    // 立即同步載入角色類別的資產 (無頭模擬等不會執行引擎主迴圈的情況)
+    static TSharedPtr<FStreamableHandle> LoadCharacterAssetsSync(const UClass* CharacterClass);
+
+    // 從 APlayerCharacter 類別的預設物件 (包含藍圖覆寫的組件預設值) 收集軟引用的資產路徑；
+    // World 為角色將生成的世界，用於依網路模式略過不會播放的資產 (預設物件本身沒有世界)
+    static void GatherCharacterAssets(const UClass* CharacterClass, TArray<FSoftObjectPath>& OutPaths, const UWorld* World = nullptr);
+
+    static bool AreCharacterAssetsLoaded(const UClass* CharacterClass, const UWorld* World = nullptr);
+
+    // --- UWorldSubsystem ---
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    void OnGameModeInitialized(AGameModeBase* GameMode);
+
+    // 客戶端：GameState 生成時 GameModeClass 可能還沒複製到，尚未到達時在下一幀重試
+    void OnGameStateSet(AGameStateBase* GameState);
+    void TryPreloadFromGameState();
+
+    // 以類別為鍵的預載句柄，保存到世界結束
+    TMap<TObjectKey<UClass>, TSharedPtr<FStreamableHandle>> ClassHandles;
+
+    // 客戶端串流 GameMode 軟引用的角色類別本身
+    TSharedPtr<FStreamableHandle> PawnClassHandle;
+
+    FDelegateHandle GameModeInitializedHandle;
+    FDelegateHandle GameStateSetHandle;
+
+    bool bClientPreloadStarted = false;
+};
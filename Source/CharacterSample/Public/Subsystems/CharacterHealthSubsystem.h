@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterHealthSubsystem.generated.h"
+
+class ACharacterBase;
+
+/**
+ * 世界內所有 ACharacterBase 的生命值，以結構陣列 (SoA) 存放。
+ * 角色在 BeginPlay 時登錄並取得穩定的句柄 (槽位索引，移除後放入空閒串列重複使用)，
+ * ACharacterBase 的生命值函式只是對這裡的薄存取。
+ *
+ * 立即的傷害與治療 (TakeDamage / Heal) 直接修改對應的槽位；
+ * 排入佇列的傷害與治療、每秒回復與死亡偵測則在 Tick 中以線性掃過緊密陣列的方式批次處理，
+ * 處理完後只通知有變化的角色。
+ *
+ * 開啟 bCoalesceHealthNotifications 的角色不會在每次變化時立即廣播 OnHealthChanged，
+ * 而是在這裡標記為待通知，於 Tick 結尾每個角色最多廣播一次；畫面外的角色再依設定的頻率降低廣播次數。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCharacterHealthSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // ====================================================================
+    // >>> 登錄 (由 ACharacterBase 呼叫) <<<
+    // ====================================================================
+
+    int32 RegisterCharacter(ACharacterBase* Character, float MaxHealth, float CurrentHealth, float InvincibilityDuration, float RegenPerSecond);
+    void UnregisterCharacter(int32 Handle);
+
+    bool IsValidHandle(int32 Handle) const { return Handle >= 0 && Handle < StateFlags.Num() && (StateFlags[Handle] & EStateFlags::Registered); }
+
+    // ====================================================================
+    // >>> 存取 <<<
+    // ====================================================================
+
+    float GetCurrentHealth(int32 Handle) const { return CurrentHealth[Handle]; }
+    float GetMaxHealth(int32 Handle) const { return MaxHealth[Handle]; }
+    bool IsDead(int32 Handle) const { return (StateFlags[Handle] & EStateFlags::Dead) != 0; }
+    bool IsInvincible(int32 Handle) const { return GetWorld()->GetTimeSeconds() < InvincibleUntil[Handle]; }
+
+    void SetMaxHealth(int32 Handle, float NewMaxHealth);
+    void SetRegenPerSecond(int32 Handle, float NewRegenPerSecond) { RegenPerSecond[Handle] = FMath::Max(NewRegenPerSecond, 0.0f); }
+    void SetInvincibilityDuration(int32 Handle, float NewDuration) { InvincibilityDuration[Handle] = NewDuration; }
+
+    // ====================================================================
+    // >>> 立即修改 (呼叫端負責廣播) <<<
+    // ====================================================================
+
+    // 扣血；未死亡時開始無敵時間。回傳這次是否造成死亡
+    bool ApplyDamage(int32 Handle, float Amount);
+
+    // 補血 (已死亡時無效)
+    void ApplyHeal(int32 Handle, float Amount);
+
+    void StartInvincibility(int32 Handle);
+    void EndInvincibility(int32 Handle) { InvincibleUntil[Handle] = 0.0; }
+
+    // 回滿生命值並清除死亡與無敵狀態
+    void Revive(int32 Handle);
+
+    // 客戶端：直接套用伺服器複製過來的生命值與死亡狀態
+    void SetReplicatedHealth(int32 Handle, float Health, bool bDead);
+
+    // ====================================================================
+    // >>> 批次修改 (在下一次 Tick 處理並通知角色) <<<
+    // ====================================================================
+
+    void QueueDamage(int32 Handle, float Amount) { PendingDamage[Handle] += FMath::Max(Amount, 0.0f); }
+    void QueueHeal(int32 Handle, float Amount) { PendingHeal[Handle] += FMath::Max(Amount, 0.0f); }
+
+    // 依序執行治療、回復、傷害與死亡偵測的線性掃描；bNotifyCharacters 為 false 時只更新資料 (基準測試用)。
+    // TimeOverride 不小於 0 時取代世界時間作為無敵時間的判斷基準 (基準測試在同一幀內以模擬時間推進)
+    void RunHealthPasses(float DeltaTime, bool bNotifyCharacters = true, double TimeOverride = -1.0);
+
+    int32 GetNumRegistered() const { return NumRegistered; }
+
+    // 對每個生命值未滿且未死亡的角色呼叫 Func(ACharacterBase*, float HealthRatio)。
+    // 滿血與死亡的角色只讀取緊密陣列就被略過，不會碰到 Actor (群眾血條的收集)
+    template<typename FuncType>
+    void ForEachDamagedCharacter(FuncType&& Func) const
+    {
+        for (int32 Handle = 0; Handle < StateFlags.Num(); ++Handle)
+        {
+            if ((StateFlags[Handle] & (EStateFlags::Registered | EStateFlags::Dead)) != EStateFlags::Registered
+                || CurrentHealth[Handle] >= MaxHealth[Handle])
+            {
+                continue;
+            }
+            if (ACharacterBase* Character = Characters[Handle].Get())
+            {
+                Func(Character, CurrentHealth[Handle] / MaxHealth[Handle]);
+            }
+        }
+    }
+
+    // ====================================================================
+    // >>> 合併的生命值通知 <<<
+    // ====================================================================
+
+    // 標記角色的生命值需要廣播；同一幀內重複的請求會被合併 (計入 Suppressed)
+    void RequestHealthNotification(int32 Handle);
+
+    // 送出到期的待通知廣播：畫面內的角色每幀一次，畫面外的角色依 OffscreenNotifyRate
+    void FlushHealthNotifications();
+
+    // 累計的通知統計 (CharacterSample.Health.NotifyStats 會輸出並重設)
+    struct FNotifyStats
+    {
+        uint64 Requested = 0;  // 呼叫 RequestHealthNotification 的次數
+        uint64 Sent = 0;       // 實際廣播的次數
+        uint64 Suppressed = 0; // 被合併掉的請求 (Requested - Sent - 仍在等待的數量)
+    };
+    const FNotifyStats& GetNotifyStats() const { return NotifyStats; }
+    int32 GetNumPendingNotifications() const { return PendingNotifyHandles.Num(); }
+    void ResetNotifyStats() { NotifyStats = FNotifyStats(); }
+
+    // --- UTickableWorldSubsystem ---
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    struct EStateFlags
+    {
+        enum : uint8
+        {
+            Registered = 1 << 0,
+            Dead = 1 << 1,
+            Changed = 1 << 2, // 本次批次處理中有變化，等待通知
+            JustDied = 1 << 3, // 本次批次處理中死亡
+            NotifyPending = 1 << 4, // 等待合併後的生命值廣播
+        };
+    };
+
+    void MarkChanged(int32 Handle);
+
+    // --- 熱資料：每次掃描都會讀寫 ---
+    TArray<float> CurrentHealth;
+    TArray<float> MaxHealth;
+    TArray<float> RegenPerSecond;
+    TArray<float> PendingDamage;
+    TArray<float> PendingHeal;
+    TArray<double> InvincibleUntil; // 無敵結束的世界時間
+    TArray<uint8> StateFlags;
+
+    // --- 冷資料：登錄、設定與通知時才使用 ---
+    TArray<float> InvincibilityDuration;
+    TArray<TWeakObjectPtr<ACharacterBase>> Characters;
+    TArray<double> LastNotifyTime; // 上次送出合併廣播的世界時間
+
+    TArray<int32> FreeList;
+    int32 NumRegistered = 0;
+
+    // 本次批次處理中有變化的槽位，重複使用避免每幀配置
+    TArray<int32> ChangedHandles;
+
+    // 等待合併廣播的槽位 (畫面外未到期的會保留到下一幀)
+    TArray<int32> PendingNotifyHandles;
+    FNotifyStats NotifyStats;
+};
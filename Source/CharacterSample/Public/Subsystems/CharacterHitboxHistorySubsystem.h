@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterHitboxHistorySubsystem.generated.h"
+
+class ACharacterBase;
+
+/**
+ * 伺服器端延遲補償用的命中框歷史。
+ * 每個 ACharacterBase 在登錄時取得一個槽位，子系統每個伺服器 Tick 記錄一次所有角色的膠囊體中心，
+ * 存放在固定容量的環形緩衝區中；命中查詢可以回溯到客戶端攻擊當下的時間，以插值後的位置做窄相測試。
+ *
+ * 所有角色在同一個 Tick 寫入，因此時間戳記只存一份；每個角色每幀只佔一個 FVector3f
+ * (角色的膠囊體一律直立且對 Yaw 對稱，不需要旋轉)，尺寸在查詢時直接讀取膠囊體組件。
+ * 登錄時一次配置整段歷史，之後的記錄與查詢都不會配置記憶體。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCharacterHitboxHistorySubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // 每個角色保留的歷史幀數 (2 的次方，60Hz 下約 1 秒)
+    static constexpr int32 HistoryCapacity = 64;
+
+    // ====================================================================
+    // >>> 登錄 (由 ACharacterBase 呼叫) <<<
+    // ====================================================================
+
+    int32 RegisterCharacter(ACharacterBase* Character);
+    void UnregisterCharacter(int32 Handle);
+
+    bool IsValidHandle(int32 Handle) const { return Characters.IsValidIndex(Handle) && Characters[Handle] != nullptr; }
+
+    // ====================================================================
+    // >>> 記錄與回溯 <<<
+    // ====================================================================
+
+    // 記錄所有登錄角色目前的位置 (Tick 每幀呼叫一次；Time 必須遞增)
+    void RecordFrame(double Time);
+
+    // 取得角色在 Time 時的膠囊體中心；超出歷史範圍時夾到最舊或最新的一幀。沒有任何歷史時回傳 false
+    bool GetLocationAtTime(int32 Handle, double Time, FVector& OutLocation) const;
+
+    // 目前歷史涵蓋的最舊與最新時間 (沒有歷史時回傳 false)
+    bool GetHistoryTimeRange(double& OutOldest, double& OutNewest) const;
+
+    // 清除所有歷史 (槽位與登錄保留)
+    void ResetHistory();
+
+    int32 GetNumRegistered() const { return NumRegistered; }
+
+    // 歷史資料目前佔用的記憶體 (位元組)
+    SIZE_T GetAllocatedSize() const;
+
+    // --- UTickableWorldSubsystem ---
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    static constexpr int32 HistoryMask = HistoryCapacity - 1;
+    static_assert((HistoryCapacity & HistoryMask) == 0, "HistoryCapacity must be a power of two.");
+
+    // 角色在槽位內可用的最舊幀序號
+    uint64 GetFirstValidSerial(int32 Handle) const;
+
+    // 所有槽位共用的時間戳記，以幀序號 & HistoryMask 索引
+    TArray<double> FrameTimes;
+    uint64 NextFrameSerial = 0; // 下一個要寫入的幀序號 (已記錄的幀數)
+    uint64 HistoryStartSerial = 0; // ResetHistory 後的第一幀
+
+    // 每個槽位 HistoryCapacity 個位置，槽位連續存放：Locations[Handle * HistoryCapacity + (Serial & HistoryMask)]
+    TArray<FVector3f> Locations;
+
+    // 登錄時的幀序號，之前的幀不屬於這個角色
+    TArray<uint64> RegisteredSerials;
+
+    TArray<ACharacterBase*> Characters; // 未登錄的槽位為 nullptr
+
+    TArray<int32> FreeList;
+    int32 NumRegistered = 0;
+};
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CharacterPoolSubsystem.generated.h"
+
+class ACharacterBase;
+
+// 載入期間預熱的角色類別與數量 (ACharacterSampleGameMode::PooledCharacters)
+USTRUCT()
+struct FCharacterPoolPrewarmEntry
+{
+    GENERATED_BODY()
+
+    // 軟引用：與玩家類別一起在 InitGame 非同步載入
+    UPROPERTY(EditAnywhere, Category = "Pool")
+    TSoftClassPtr<ACharacterBase> CharacterClass;
+
+    // 同時出現的最大數量 (例如最大一波的敵人數)
+    UPROPERTY(EditAnywhere, Category = "Pool", meta = (ClampMin = "0"))
+    int32 Count = 0;
+};
+
+// 單一角色類別的池：尚未取出的角色，以及統計
+USTRUCT()
+struct FCharacterPoolBucket
+{
+    GENERATED_BODY()
+
+    // 放在池中、可以直接取出的角色 (角色在池中被銷毀時，UPROPERTY 讓引用在 GC 後變為空)
+    UPROPERTY()
+    TArray<ACharacterBase*> Available;
+
+    // 由這個池生成的角色總數 (包含已取出的)
+    int32 NumCreated = 0;
+
+    // 池空了而必須在取出時生成的次數 (預熱數量不足)
+    int32 NumMisses = 0;
+};
+
+/**
+ * 角色物件池 (只在伺服器與單機使用)。
+ * 生成與銷毀角色需要建立組件、執行每個組件的 BeginPlay、登錄各個子系統與綁定輸入；
+ * 池在載入期間預先生成角色並隱藏停用，遊戲中以 AcquireCharacter / ReleaseCharacter 取代 SpawnActor / Destroy，
+ * 由 ACharacterBase::OnAcquiredFromPool 重設生命值、連擊、入場動畫與移動狀態。
+ * 池中的角色不在空間索引中，因此不會被命中、查詢，也不會複製給客戶端 (客戶端在取出後才重新建立)。
+ * 預熱數量由 ACharacterSampleGameMode 的 PooledCharacters 設定，在 StartPlay (仍屬於地圖載入) 時生成。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCharacterPoolSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // 生成角色直到 CharacterClass 的池中至少有 Count 個可用角色；回傳這次新生成的數量
+    int32 Prewarm(TSubclassOf<ACharacterBase> CharacterClass, int32 Count);
+
+    // 取出一個角色並放到 SpawnTransform；池空時直接生成 (記為未命中)
+    ACharacterBase* AcquireCharacter(TSubclassOf<ACharacterBase> CharacterClass, const FTransform& SpawnTransform);
+
+    // 把角色放回池中 (取代 Destroy)；由玩家控制器擁有的角色不會被放回
+    void ReleaseCharacter(ACharacterBase* Character);
+
+    int32 GetNumAvailable(TSubclassOf<ACharacterBase> CharacterClass) const;
+
+    // 輸出每個類別的可用數量、生成總數與未命中次數
+    void DumpStats() const;
+
+    // --- UWorldSubsystem ---
+    virtual void Deinitialize() override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    // 生成一個角色並立即停用放入池中
+    ACharacterBase* SpawnPooledCharacter(UClass* CharacterClass, FCharacterPoolBucket& Bucket);
+
+    UPROPERTY()
+    TMap<UClass*, FCharacterPoolBucket> Buckets;
+};
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Core/CharacterSpatialHash.h"
+#include "CharacterSpatialIndexSubsystem.generated.h"
+
+class ACharacterBase;
+
+/**
+ * 世界內所有 ACharacterBase 的空間索引。
+ * 角色在 BeginPlay 時登錄，移動時由膠囊體的 TransformUpdated 事件增量更新，
+ * 讓戰鬥、鎖定目標與 AI 不需要經過物理場景就能找到附近的角色。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCharacterSpatialIndexSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UCharacterSpatialIndexSubsystem();
+
+    // ====================================================================
+    // >>> 登錄 (由 ACharacterBase 呼叫) <<<
+    // ====================================================================
+
+    // 登錄角色並回傳句柄
+    int32 RegisterCharacter(ACharacterBase* Character);
+
+    // 取消登錄
+    void UnregisterCharacter(int32 Handle);
+
+    // 依角色目前的膠囊體位置更新索引
+    void UpdateCharacter(int32 Handle, ACharacterBase* Character);
+
+    // 依角色目前的膠囊體尺寸更新索引 (蹲下、起身等改變膠囊大小之後)
+    void UpdateCharacterShape(int32 Handle, ACharacterBase* Character);
+
+    // ====================================================================
+    // >>> 查詢 (寬相，結果為保守集合) <<<
+    // ====================================================================
+
+    void QueryRadius(const FVector& Center, float Radius, TArray<ACharacterBase*>& OutCharacters) const { SpatialHash.QueryRadius(Center, Radius, OutCharacters); }
+    void QueryCone(const FVector& Origin, const FVector& Direction, float HalfAngleDegrees, float Range, TArray<ACharacterBase*>& OutCharacters) const { SpatialHash.QueryCone(Origin, Direction, HalfAngleDegrees, Range, OutCharacters); }
+    void QuerySegment(const FVector& Start, const FVector& End, float Radius, TArray<ACharacterBase*>& OutCharacters) const { SpatialHash.QuerySegment(Start, End, Radius, OutCharacters); }
+
+    // 藍圖可用的半徑查詢 (例如 AI 尋找附近敵人)
+    UFUNCTION(BlueprintCallable, Category = "Combat|SpatialIndex")
+    TArray<ACharacterBase*> GetCharactersInRadius(FVector Center, float Radius) const;
+
+    const FCharacterSpatialHash& GetSpatialHash() const { return SpatialHash; }
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    FCharacterSpatialHash SpatialHash;
+};
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/Queue.h" // 無鎖多生產者佇列
+#include "CombatDamageSubsystem.generated.h"
+
+class ACharacterBase;
+
+// ====================================================================
+// >>> 單筆傷害提交 <<<
+// 只包含弱引用與數值，可以在任何執行緒上建立並提交
+// ====================================================================
+struct FCombatDamageSubmission
+{
+    TWeakObjectPtr<ACharacterBase> Target; // 受擊角色
+    float Damage = 0.0f;                   // 傷害量
+
+    TWeakObjectPtr<AController> EventInstigator; // 造成傷害的控制器
+    TWeakObjectPtr<AActor> DamageCauser;         // 造成傷害的 Actor
+};
+
+// ====================================================================
+// >>> 合併後單一來源的傷害 <<<
+// 同一幀內同一個控制器與 Actor 對同一目標的命中總和，用於保留傷害歸屬
+// ====================================================================
+struct FCoalescedDamageSource
+{
+    TWeakObjectPtr<AController> EventInstigator;
+    TWeakObjectPtr<AActor> DamageCauser;
+    float Damage = 0.0f;
+    int32 HitCount = 0;
+};
+
+// ====================================================================
+// >>> 統計資料 <<<
+// ====================================================================
+struct FCombatDamageStats
+{
+    int32 HitsLastFrame = 0;    // 上一次 Tick 處理的傷害提交數
+    int32 TargetsLastFrame = 0; // 上一次 Tick 實際套用傷害的角色數 (= 生命值廣播次數)
+    int64 TotalHits = 0;        // 累計傷害提交數
+    int64 TotalTargets = 0;     // 累計套用次數
+
+    double LastFrameCostMs = 0.0; // 上一次 Tick 的遊戲執行緒成本 (毫秒)
+};
+
+/**
+ * 幀末合併的傷害管線。
+ * 任何執行緒都可以透過 SubmitDamage 將命中放入無鎖佇列；子系統 Tick 時在遊戲執行緒
+ * 一次取出，依目標合併傷害後，每個目標只呼叫一次 ACharacterBase::ApplyCoalescedDamage，
+ * 因此同一幀內對同一目標的多次命中 (例如範圍攻擊) 只會觸發一次生命值廣播。
+ * 每個目標內再依來源 (控制器與造成傷害的 Actor) 分開加總，多名攻擊者同時命中時傷害仍歸屬正確的來源。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCombatDamageSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // 提交一筆傷害 (執行緒安全)，會在下一次子系統 Tick 時套用
+    // 注意：取得子系統本身需要在遊戲執行緒上完成，工作執行緒應持有事先取得的指標
+    void SubmitDamage(ACharacterBase* Target, float Damage, AController* EventInstigator, AActor* DamageCauser);
+
+    // 取得統計資料
+    const FCombatDamageStats& GetStats() const { return Stats; }
+
+    // 將統計資料輸出到日誌
+    void LogStats() const;
+
+    // --- UTickableWorldSubsystem ---
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    // 同一目標在本幀合併後的傷害
+    struct FMergedDamage
+    {
+        TWeakObjectPtr<ACharacterBase> Target;
+
+        // 依來源分開的加總，保持每個來源第一次命中的順序；大部分目標只有一、兩個來源
+        TArray<FCoalescedDamageSource, TInlineAllocator<2>> Sources;
+    };
+
+    // 多生產者、單一消費者 (遊戲執行緒) 的無鎖佇列
+    TQueue<FCombatDamageSubmission, EQueueMode::Mpsc> PendingDamage;
+
+    // Tick 時重複使用的合併暫存資料，避免每幀配置
+    TArray<FMergedDamage> ScratchMerged;
+    TMap<TObjectKey<ACharacterBase>, int32> ScratchTargetToIndex;
+
+    FCombatDamageStats Stats;
+};
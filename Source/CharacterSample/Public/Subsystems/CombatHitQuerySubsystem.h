@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h" // FTraceHandle、FTraceDatum、FTraceDelegate
+#include "Core/CombatNarrowphase.h" // 空間索引路徑的 SIMD 窄相
+#include "CombatHitQuerySubsystem.generated.h"
+
+// 命中查詢完成時的原生回調 (非動態委託，避免反射成本)
+// 物理路徑的結果會在提交後的下一幀送達，空間索引路徑則在本幀子系統 Tick 時送達
+DECLARE_DELEGATE_OneParam(FOnCombatHitQueryComplete, const TArray<FHitResult>& /*HitResults*/);
+
+// ====================================================================
+// >>> 單筆命中查詢請求 <<<
+// 由 CombatComponent 在 Anim Notify 觸發時填寫並提交
+// ====================================================================
+struct FCombatHitQueryRequest
+{
+    FVector Start = FVector::ZeroVector; // 掃掠起點
+    FVector End = FVector::ZeroVector;   // 掃掠終點
+    float Radius = 0.0f;                 // 球體半徑
+
+    TWeakObjectPtr<AActor> IgnoredActor; // 需要忽略的 Actor (通常是攻擊者自己)
+
+    // 只針對 ACharacterBase：以空間索引 + SIMD 窄相解析，不經過物理場景，結果在本幀子系統 Tick 時送達
+    bool bResolveWithCharacterIndex = false;
+
+    // 延遲補償：>= 0 時以目標在這個世界時間的位置判定 (只用於空間索引路徑)，< 0 表示使用目前位置
+    double RewindTime = -1.0;
+
+    FOnCombatHitQueryComplete OnComplete; // 結果回調
+};
+
+// ====================================================================
+// >>> 統計資料 <<<
+// 每幀查詢數與遊戲執行緒上的總成本 (提交 + 派送結果)
+// ====================================================================
+struct FCombatHitQueryStats
+{
+    int32 QueriesLastFrame = 0;    // 上一次 Tick 發出的查詢數
+    int32 PeakQueriesPerFrame = 0; // 單幀最大查詢數
+    int64 TotalQueries = 0;        // 累計查詢數
+    int64 TotalIndexQueries = 0;   // 其中以空間索引解析的查詢數
+
+    double LastFrameCostMs = 0.0;  // 上一次 Tick 的遊戲執行緒成本 (毫秒)
+    double TotalCostMs = 0.0;      // 累計遊戲執行緒成本 (毫秒)
+};
+
+class ACharacterBase;
+class UCharacterSpatialIndexSubsystem;
+class UCharacterHitboxHistorySubsystem;
+
+/**
+ * 批次化的非同步命中查詢子系統。
+ * 收集同一幀內所有 CombatComponent 提交的命中請求，在子系統 Tick 時一次性以
+ * 非同步球體掃掠 (AsyncSweepByObjectType) 發出，結果在下一幀透過原生回調送達，
+ * 避免在 Anim Notify 中同步執行 SphereTraceMultiForObjects 造成的遊戲執行緒尖峰。
+ * 標記為 bResolveWithCharacterIndex 的請求則改用角色空間索引做寬相、SIMD 膠囊測試做窄相。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCombatHitQuerySubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // 提交一筆球體掃掠請求，會在本幀結束前被批次發出
+    void SubmitSphereSweep(FCombatHitQueryRequest&& Request);
+
+    // 取得統計資料
+    const FCombatHitQueryStats& GetStats() const { return Stats; }
+
+    // 將統計資料輸出到日誌
+    void LogStats() const;
+
+    // --- UTickableWorldSubsystem ---
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    // 非同步掃掠完成時由引擎呼叫 (下一幀)
+    void HandleTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+    // 以空間索引 + 窄相立即解析一筆請求
+    void ResolveWithCharacterIndex(FCombatHitQueryRequest& Request);
+
+    UPROPERTY()
+    UCharacterSpatialIndexSubsystem* SpatialIndexSubsystem;
+
+    UPROPERTY()
+    UCharacterHitboxHistorySubsystem* HitboxHistorySubsystem;
+
+    // 空間索引路徑重複使用的暫存資料，避免每次配置
+    TArray<ACharacterBase*> ScratchCandidates;
+    FCombatCapsuleSoA ScratchCapsules;
+    TArray<int32> ScratchHitIndices;
+    TArray<FHitResult> ScratchHitResults;
+
+    // 本幀收集到、尚未發出的請求
+    TArray<FCombatHitQueryRequest> PendingRequests;
+
+    // Tick 時與 PendingRequests 交換後處理，回調中再提交的請求會留到下一輪
+    TArray<FCombatHitQueryRequest> IssuingRequests;
+
+    // 已發出、等待結果的請求回調，以 UserData 作為鍵值
+    TMap<uint32, FOnCombatHitQueryComplete> InFlightCallbacks;
+
+    // 遞增的請求序號，作為 AsyncSweep 的 UserData
+    uint32 NextRequestId = 1;
+
+    // 共用的引擎回調委託
+    FTraceDelegate TraceDelegate;
+
+    FCombatHitQueryStats Stats;
+
+    // 本幀在派送結果上所花費的時間 (在下一次 Tick 時計入)
+    double PendingDeliveryCostSeconds = 0.0;
+};
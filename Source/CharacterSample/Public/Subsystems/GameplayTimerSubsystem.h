@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Core/TimingWheel.h"
+#include "GameplayTimerSubsystem.generated.h"
+
+/**
+ * 集中式的短期遊戲計時器 (連擊窗口等)。
+ * 以階層式時間輪取代每個角色各自持有的 FTimerHandle：設定與取消都是 O(1)，
+ * 到期的回調在子系統 Tick 時批次執行。時間來源為世界時間，因此與 FTimerManager 一樣會受暫停與時間膨脹影響。
+ * 精度為一個刻度 (TickSeconds)，回調最晚會在到期後的第一個子系統 Tick 執行。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UGameplayTimerSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // 時間輪的刻度長度 (秒)
+    static constexpr double TickSeconds = 0.01;
+
+    // 在 DelaySeconds 秒後呼叫 Callback；回傳的句柄可用於取消
+    FTimingWheelHandle SetTimer(float DelaySeconds, FSimpleDelegate&& Callback);
+
+    // 取消計時器並使句柄失效 (句柄已失效時不做任何事)
+    bool ClearTimer(FTimingWheelHandle& Handle) { return TimingWheel.Cancel(Handle); }
+
+    bool IsTimerActive(const FTimingWheelHandle& Handle) const { return TimingWheel.IsArmed(Handle); }
+
+    int32 GetNumActiveTimers() const { return TimingWheel.Num(); }
+
+    // 上一次 Tick 的遊戲執行緒成本 (毫秒，包含執行回調)
+    double GetLastTickCostMs() const { return LastTickCostMs; }
+
+    // --- UTickableWorldSubsystem ---
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    FTimingWheel TimingWheel;
+
+    // 本次 Tick 到期的計時器，重複使用避免每幀配置
+    TArray<FTimingWheelHandle> ExpiredTimers;
+
+    double LastTickCostMs = 0.0;
+};
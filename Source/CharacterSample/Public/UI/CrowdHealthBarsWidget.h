@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/Widget.h"
+#include "CrowdHealthBarsWidget.generated.h"
+
+class SCrowdHealthBars;
+
+/**
+ * SCrowdHealthBars 的 UMG 包裝，讓 HUD 藍圖可以直接放入群眾血條。
+ * 放在全螢幕的 Canvas 插槽 (錨點拉滿) 中，位置才會與視口對齊；投影使用擁有這個 Widget 的玩家攝影機。
+ */
+UCLASS()
+class CHARACTERSAMPLE_API UCrowdHealthBarsWidget : public UWidget
+{
+    GENERATED_BODY()
+
+public:
+    // 每條血條的大小 (Slate 單位)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HealthBar")
+    FVector2D BarSize = FVector2D(60.0, 6.0);
+
+    // 血條位於膠囊體頂端上方的距離 (公分)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HealthBar")
+    float HeadOffset = 30.0f;
+
+    virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+protected:
+    virtual TSharedRef<SWidget> RebuildWidget() override;
+
+private:
+    TSharedPtr<SCrowdHealthBars> CrowdHealthBars;
+};
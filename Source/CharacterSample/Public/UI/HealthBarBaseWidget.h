@@ -29,9 +29,22 @@ public:
 protected:
     // 如果你需要在 C++ 中處理 Construct 邏輯，可以覆寫這個
     virtual void NativeConstruct() override; 
+    virtual void NativeDestruct() override;
 
     // 聲明一個 Blueprint Implementable Event，讓藍圖去實現實際的 UI 更新邏輯
     // 這樣當生命值變化時，C++ 可以呼叫這個事件，藍圖來更新 Progress Bar 和 Text
     UFUNCTION(BlueprintImplementableEvent, Category = "HealthBar")
     void K2_UpdateHealthBarUI(float CurrentHealth, float MaxHealth);
+
+private:
+    // 綁定到 OnHealthChangedNative 的原生回呼，數值沒有變化時不呼叫藍圖事件
+    void HandleHealthChanged(float CurrentHealth, float MaxHealth);
+
+    void UnbindOwnerCharacter();
+
+    FDelegateHandle HealthChangedHandle;
+
+    // 上次送給藍圖的數值
+    float DisplayedHealth = -1.0f;
+    float DisplayedMaxHealth = -1.0f;
 };
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+#include "Rendering/RenderingCommon.h" // FSlateVertex、SlateIndex
+
+class APlayerController;
+class UCharacterHealthSubsystem;
+struct FSlateBrush;
+
+// 一條血條：相對於視口的位置 (0..1，左上為原點) 與生命值比例，緊密排列供一次繪製
+struct FCrowdHealthBarInstance
+{
+    FVector2f ViewportPosition;
+    float HealthRatio;
+};
+
+/**
+ * 在一次繪製中畫出所有受傷角色的血條。
+ * 取代每個敵人一個 UUserWidget：每幀從 UCharacterHealthSubsystem 的緊密陣列收集受傷且在畫面內的角色，
+ * 投影成視口位置與生命值比例的緊密陣列，再產生一組自訂頂點 (每條血條兩個四邊形) 以單一繪製元素送出。
+ * 滿血、死亡、隱藏 (例如在角色池中) 與畫面外的角色會被剔除；本地玩家自己的角色由 UHealthBarBaseWidget 顯示，也會略過。
+ *
+ * 這個元件應該鋪滿玩家的視口 (APlayerCharacterController 以 AddViewportWidgetForPlayer 加入，
+ * 或在 UMG 中透過 UCrowdHealthBarsWidget 放在全螢幕的 Canvas 中)。
+ * 收集與頂點產生是靜態函式，CharacterSample.UI.HealthBarBenchmark 在 -nullrhi 下直接量測它們。
+ */
+class CHARACTERSAMPLE_API SCrowdHealthBars : public SLeafWidget
+{
+public:
+    SLATE_BEGIN_ARGS(SCrowdHealthBars)
+        : _BarSize(FVector2f(60.0f, 6.0f))
+        , _HeadOffset(30.0f)
+    {}
+        // 擁有這個視口的玩家：以它的攝影機投影，並略過它擁有的角色
+        SLATE_ARGUMENT(TWeakObjectPtr<APlayerController>, PlayerController)
+
+        // 每條血條的大小 (Slate 單位)
+        SLATE_ARGUMENT(FVector2f, BarSize)
+
+        // 血條位於膠囊體頂端上方的距離 (公分)
+        SLATE_ARGUMENT(float, HeadOffset)
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments& InArgs);
+
+    // CharacterSample.UI.CrowdHealthBars：本地玩家控制器是否建立群眾血條
+    static bool IsEnabled();
+
+    // 以玩家攝影機最近一次的視角計算投影矩陣 (視口長寬比用於透視)
+    static bool GetViewProjection(const APlayerController* PlayerController, const FVector2f& ViewportSize, FMatrix& OutViewProjection);
+
+    // 收集受傷且在畫面內的角色；回傳收集時檢查過 (受傷且未死亡) 的角色數，其餘都已在緊密陣列上被剔除
+    static int32 GatherInstances(const UCharacterHealthSubsystem& HealthSubsystem, const FMatrix& ViewProjection, const AActor* IgnoredActor,
+        float HeadOffset, FVector2f BarSize, const FVector2f& ViewportSize, TArray<FCrowdHealthBarInstance>& OutInstances);
+
+    // 把血條展開成頂點與索引 (背景與填充各一個四邊形)
+    static void BuildBarVertices(TConstArrayView<FCrowdHealthBarInstance> Instances, const FVector2f& LocalSize, FVector2f BarSize,
+        const FSlateRenderTransform& RenderTransform, TArray<FSlateVertex>& OutVertices, TArray<SlateIndex>& OutIndices);
+
+    // --- SWidget ---
+    virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+    virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+protected:
+    virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+    TWeakObjectPtr<APlayerController> PlayerController;
+    FVector2f BarSize;
+    float HeadOffset = 0.0f;
+
+    // 白色筆刷，四邊形以頂點色著色
+    const FSlateBrush* WhiteBrush = nullptr;
+
+    // 每幀重複使用，避免配置
+    TArray<FCrowdHealthBarInstance> Instances;
+    mutable TArray<FSlateVertex> Vertices;
+    mutable TArray<SlateIndex> Indices;
+};